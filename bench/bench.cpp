@@ -118,14 +118,47 @@ int main(int argc, char** argv) {
 
         if (test_case == "np_ot") {
             np_ot_bench(net, party, test_number);
+        } else if (test_case == "simplest_ot") {
+            simplest_ot_bench(net, party, test_number);
         } else if (test_case == "iknp_ot") {
             iknp_ot_bench(net, party, test_number);
         } else if (test_case == "kkrt_ot") {
             kkrt_ot_bench(net, party, test_number);
+        } else if (test_case == "kkrt_setup") {
+            kkrt_setup_bench(net, party, test_number);
+        } else if (test_case == "iknp_large") {
+            iknp_large_bench(net, party, test_number);
+        } else if (test_case == "arithmetic_triple") {
+            arithmetic_triple_bench(net, party, test_number);
+        } else if (test_case == "boolean_triple") {
+            boolean_triple_bench(net, party, test_number);
+        } else if (test_case == "kk13_ot") {
+            kk13_ot_bench(net, party, test_number);
+        } else if (test_case == "nco_chosen") {
+            nco_chosen_bench(net, party, test_number);
+        } else if (test_case == "mp_oprf") {
+            mp_oprf_bench(net, party, test_number);
+        } else if (test_case == "iknp_duplex") {
+            iknp_duplex_bench(net, party, test_number);
+        } else if (test_case == "striped_network") {
+            striped_network_bench(net_params, party, test_number);
+        } else if (test_case == "perf_counters") {
+            perf_counters_bench(net, party, test_number);
         } else if (test_case == "all") {
             np_ot_bench(net, party, test_number);
+            simplest_ot_bench(net, party, test_number);
             iknp_ot_bench(net, party, test_number);
             kkrt_ot_bench(net, party, test_number);
+            kkrt_setup_bench(net, party, test_number);
+            iknp_large_bench(net, party, test_number);
+            arithmetic_triple_bench(net, party, test_number);
+            boolean_triple_bench(net, party, test_number);
+            kk13_ot_bench(net, party, test_number);
+            nco_chosen_bench(net, party, test_number);
+            mp_oprf_bench(net, party, test_number);
+            iknp_duplex_bench(net, party, test_number);
+            striped_network_bench(net_params, party, test_number);
+            perf_counters_bench(net, party, test_number);
         }
         google::RemoveLogSink(&log_to_file_sink);
         google::ShutdownGoogleLogging();
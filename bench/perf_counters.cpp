@@ -0,0 +1,147 @@
+// Copyright 2023 TikTok Pte. Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "perf_counters.h"
+
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+#ifdef __linux__
+int open_event(std::uint32_t type, std::uint64_t config) {
+    perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = 1;
+    attr.inherit = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+}
+#endif
+
+}  // namespace
+
+PerfCounters::PerfCounters() {
+    fds_.fill(-1);
+#ifdef __linux__
+    const std::uint64_t l1d_read_miss = PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                                        (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    fds_[static_cast<std::size_t>(PerfEvent::Cycles)] = open_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+    fds_[static_cast<std::size_t>(PerfEvent::Instructions)] =
+            open_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+    fds_[static_cast<std::size_t>(PerfEvent::L1dMisses)] = open_event(PERF_TYPE_HW_CACHE, l1d_read_miss);
+    fds_[static_cast<std::size_t>(PerfEvent::LlcMisses)] = open_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+    fds_[static_cast<std::size_t>(PerfEvent::BranchMisses)] =
+            open_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+#endif
+}
+
+PerfCounters::~PerfCounters() {
+#ifdef __linux__
+    for (int fd : fds_) {
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+#endif
+}
+
+bool PerfCounters::available() const {
+    for (int fd : fds_) {
+        if (fd >= 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void PerfCounters::start() {
+#ifdef __linux__
+    for (int fd : fds_) {
+        if (fd >= 0) {
+            ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+#endif
+}
+
+PerfSample PerfCounters::stop() {
+    PerfSample sample;
+#ifdef __linux__
+    for (std::size_t i = 0; i < kPerfEventCount; i++) {
+        if (fds_[i] < 0) {
+            continue;
+        }
+        ioctl(fds_[i], PERF_EVENT_IOC_DISABLE, 0);
+        // value, time enabled, time running
+        std::uint64_t data[3] = {0, 0, 0};
+        if (read(fds_[i], data, sizeof(data)) != static_cast<ssize_t>(sizeof(data)) || data[2] == 0) {
+            continue;
+        }
+        sample.values[i] = static_cast<double>(data[0]) * static_cast<double>(data[1]) / static_cast<double>(data[2]);
+        sample.valid[i] = true;
+    }
+#endif
+    return sample;
+}
+
+const char* PerfCounters::name(PerfEvent event) {
+    switch (event) {
+        case PerfEvent::Cycles:
+            return "cycles";
+        case PerfEvent::Instructions:
+            return "instructions";
+        case PerfEvent::L1dMisses:
+            return "l1d_misses";
+        case PerfEvent::LlcMisses:
+            return "llc_misses";
+        case PerfEvent::BranchMisses:
+            return "branch_misses";
+    }
+    return "unknown";
+}
+
+std::string PerfCounters::format(const PerfSample& sample, double units, const std::string& unit) {
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(3);
+    for (std::size_t i = 0; i < kPerfEventCount; i++) {
+        PerfEvent event = static_cast<PerfEvent>(i);
+        out << (i == 0 ? "" : " ") << name(event) << "/" << unit << " ";
+        if (sample.has(event)) {
+            out << sample.value(event) / units;
+        } else {
+            out << "n/a";
+        }
+    }
+    if (sample.has(PerfEvent::Cycles) && sample.has(PerfEvent::Instructions) &&
+            sample.value(PerfEvent::Cycles) > 0) {
+        out << " ipc " << sample.value(PerfEvent::Instructions) / sample.value(PerfEvent::Cycles);
+    }
+    return out.str();
+}
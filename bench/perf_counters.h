@@ -0,0 +1,71 @@
+// Copyright 2023 TikTok Pte. Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <string>
+
+// Hardware events counted by PerfCounters.
+enum class PerfEvent : std::size_t { Cycles = 0, Instructions, L1dMisses, LlcMisses, BranchMisses };
+
+const std::size_t kPerfEventCount = 5;
+
+// Counter values of one measured phase; events the kernel refused are marked invalid.
+struct PerfSample {
+    std::array<double, kPerfEventCount> values{};
+    std::array<bool, kPerfEventCount> valid{};
+
+    double value(PerfEvent event) const {
+        return values[static_cast<std::size_t>(event)];
+    }
+
+    bool has(PerfEvent event) const {
+        return valid[static_cast<std::size_t>(event)];
+    }
+};
+
+// Hardware counters read through perf_event_open. Each event is opened on its own for the calling thread and the
+// threads it creates afterwards; threads still running when a phase ends are not included, so measure with
+// num_threads = 1 for complete counts. An event the kernel does not offer, e.g. in a container or with a restrictive
+// perf_event_paranoid, stays closed and reads as invalid; without perf_event_open every event does. Values are scaled
+// by the enabled over running time when the kernel multiplexes counters.
+class PerfCounters {
+public:
+    PerfCounters();
+
+    ~PerfCounters();
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    // Return whether at least one event could be opened.
+    bool available() const;
+
+    // Reset and enable all open events.
+    void start();
+
+    // Disable all open events and return their values since start.
+    PerfSample stop();
+
+    // Return the name printed for an event.
+    static const char* name(PerfEvent event);
+
+    // Format the values of sample divided by units, e.g. the number of ots, as "<name>/<unit> <value>" pairs.
+    static std::string format(const PerfSample& sample, double units, const std::string& unit);
+
+private:
+    std::array<int, kPerfEventCount> fds_{};
+};
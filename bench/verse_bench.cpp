@@ -14,14 +14,26 @@
 
 #include "verse_bench.h"
 
+#include <algorithm>
 #include <chrono>
 #include <iomanip>
 #include <iostream>
 #include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
 
+#include "alloc_counter.h"
+#include "perf_counters.h"
 #include "glog/logging.h"
 
+#include "verse/oprf/mp_oprf.h"
+#include "verse/triple/arithmetic_triple.h"
+#include "verse/triple/boolean_triple.h"
+#include "verse/two-choose-one/iknp/iknp_duplex_ot_ext.h"
 #include "verse/util/common.h"
+#include "verse/util/striped_network.h"
 
 double get_unix_timestamp() {
     std::chrono::time_point<std::chrono::system_clock> now = std::chrono::system_clock::now();
@@ -69,6 +81,46 @@ void np_ot_bench(const std::shared_ptr<petace::network::Network>& net, std::size
     }
 }
 
+void simplest_ot_bench(
+        const std::shared_ptr<petace::network::Network>& net, std::size_t party_id, std::size_t test_number) {
+    try {
+        petace::verse::VerseParams params;
+        params.base_ot_sizes = 512;
+
+        std::vector<petace::verse::block> base_recv_ots;
+        std::vector<std::array<petace::verse::block, 2>> base_send_ots;
+        std::vector<petace::verse::block> base_choices;
+        for (std::size_t i = 0; i < 4; i++) {
+            base_choices.emplace_back(petace::verse::read_block_from_dev_urandom());
+        }
+
+        auto ot_sender = petace::verse::VerseFactory<petace::verse::BaseOtSender>::get_instance().build(
+                petace::verse::OTScheme::SimplestOtSender, params);
+        auto ot_receiver = petace::verse::VerseFactory<petace::verse::BaseOtReceiver>::get_instance().build(
+                petace::verse::OTScheme::SimplestOtReceiver, params);
+
+        double begin = get_unix_timestamp();
+        LOG(INFO) << std::fixed << "case simplest_ot_" << params.base_ot_sizes << "_bench"
+                  << " begin " << begin << " " << test_number;
+
+        for (size_t i = 0; i < test_number; i++) {
+            if (party_id == 0) {
+                ot_sender->send(net, base_send_ots);
+            } else {
+                ot_receiver->receive(net, base_choices, base_recv_ots);
+            }
+        }
+
+        double end = get_unix_timestamp();
+
+        LOG(INFO) << std::fixed << "case simplest_ot_" << params.base_ot_sizes << "_bench"
+                  << " end " << end << " " << end - begin << "s " << net->get_bytes_sent() << " "
+                  << net->get_bytes_received();
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << '\n';
+    }
+}
+
 void iknp_ot_bench(
         const std::shared_ptr<petace::network::Network>& net, std::size_t party_id, std::size_t test_number) {
     try {
@@ -96,6 +148,7 @@ void iknp_ot_bench(
         std::vector<std::array<petace::verse::block, 2>> send_msgs;
         std::vector<petace::verse::block> recv_msgs;
 
+        std::size_t steady_allocations = 0;
         double begin = get_unix_timestamp();
         LOG(INFO) << std::fixed << "case iknp_ot_" << params.base_ot_sizes << "_" << params.ext_ot_sizes << "_bench"
                   << " begin " << begin << " " << test_number;
@@ -104,21 +157,32 @@ void iknp_ot_bench(
             npot_receiver->receive(net, base_choices, base_recv_ots);
             iknp_sender->set_base_ots(base_choices, base_recv_ots);
             for (size_t i = 0; i < test_number; i++) {
+                std::size_t allocations = allocation_count();
                 iknp_sender->send(net, send_msgs);
+                // The first batch sizes the engine's buffers; later batches should not allocate.
+                if (i != 0) {
+                    steady_allocations += allocation_count() - allocations;
+                }
             }
         } else {
             npot_sender->send(net, base_send_ots);
             iknp_receiver->set_base_ots(base_send_ots);
             for (size_t i = 0; i < test_number; i++) {
+                std::size_t allocations = allocation_count();
                 iknp_receiver->receive(net, ext_choices, recv_msgs);
+                // The first batch sizes the engine's buffers; later batches should not allocate.
+                if (i != 0) {
+                    steady_allocations += allocation_count() - allocations;
+                }
             }
         }
 
         double end = get_unix_timestamp();
 
-        LOG(INFO) << std::fixed << "case np_ot_" << params.base_ot_sizes << "_" << params.ext_ot_sizes << "_bench"
+        LOG(INFO) << std::fixed << "case iknp_ot_" << params.base_ot_sizes << "_" << params.ext_ot_sizes << "_bench"
                   << " end " << end << " " << end - begin << "s " << net->get_bytes_sent() << " "
-                  << net->get_bytes_received();
+                  << net->get_bytes_received() << " allocs/batch "
+                  << steady_allocations / std::max<std::size_t>(test_number - 1, 1);
     } catch (const std::exception& e) {
         std::cerr << e.what() << '\n';
     }
@@ -152,6 +216,7 @@ void kkrt_ot_bench(
 
         std::vector<petace::verse::block> recv_msgs;
 
+        std::size_t steady_allocations = 0;
         double begin = get_unix_timestamp();
         LOG(INFO) << std::fixed << "case kkrt_ot_" << params.base_ot_sizes << "_" << params.ext_ot_sizes << "_bench"
                   << " begin " << begin << " " << test_number;
@@ -160,13 +225,23 @@ void kkrt_ot_bench(
             npot_receiver->receive(net, base_choices, base_recv_ots);
             kkrt_sender->set_base_ots(base_choices, base_recv_ots);
             for (size_t i = 0; i < test_number; i++) {
+                std::size_t allocations = allocation_count();
                 kkrt_sender->send(net, params.ext_ot_sizes);
+                // The first batch sizes the engine's buffers; later batches should not allocate.
+                if (i != 0) {
+                    steady_allocations += allocation_count() - allocations;
+                }
             }
         } else {
             npot_sender->send(net, base_send_ots);
             kkrt_receiver->set_base_ots(base_send_ots);
             for (size_t i = 0; i < test_number; i++) {
+                std::size_t allocations = allocation_count();
                 kkrt_receiver->receive(net, ext_choices, recv_msgs);
+                // The first batch sizes the engine's buffers; later batches should not allocate.
+                if (i != 0) {
+                    steady_allocations += allocation_count() - allocations;
+                }
             }
         }
 
@@ -174,8 +249,667 @@ void kkrt_ot_bench(
 
         LOG(INFO) << std::fixed << "case kkrt_ot_" << params.base_ot_sizes << "_" << params.ext_ot_sizes << "_bench"
                   << " end " << end << " " << end - begin << "s " << net->get_bytes_sent() << " "
-                  << net->get_bytes_received();
+                  << net->get_bytes_received() << " allocs/batch "
+                  << steady_allocations / std::max<std::size_t>(test_number - 1, 1);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << '\n';
+    }
+}
+
+void kkrt_setup_bench(
+        const std::shared_ptr<petace::network::Network>& net, std::size_t party_id, std::size_t test_number) {
+    // Compare the setup of kkrt from 512 public-key base ots with the setup bootstrapped from 128-wide iknp.
+    std::vector<std::pair<std::string, std::pair<petace::verse::OTScheme, petace::verse::OTScheme>>> setups = {
+            {"np", {petace::verse::OTScheme::NaorPinkasSender, petace::verse::OTScheme::NaorPinkasReceiver}},
+            {"iknp", {petace::verse::OTScheme::IknpBaseOtSender, petace::verse::OTScheme::IknpBaseOtReceiver}}};
+    for (auto& setup : setups) {
+        try {
+            petace::verse::VerseParams params;
+            params.base_ot_sizes = 512;
+            params.ext_ot_sizes = 1024;
+            std::vector<petace::verse::block> base_recv_ots;
+            std::vector<std::array<petace::verse::block, 2>> base_send_ots;
+            std::vector<petace::verse::block> base_choices;
+            for (std::size_t i = 0; i < 4; i++) {
+                base_choices.emplace_back(petace::verse::read_block_from_dev_urandom());
+            }
+
+            auto base_sender = petace::verse::VerseFactory<petace::verse::BaseOtSender>::get_instance().build(
+                    setup.second.first, params);
+            auto base_receiver = petace::verse::VerseFactory<petace::verse::BaseOtReceiver>::get_instance().build(
+                    setup.second.second, params);
+            auto kkrt_sender = petace::verse::VerseFactory<petace::verse::NcoOtExtSender>::get_instance().build(
+                    petace::verse::OTScheme::KkrtSender, params);
+            auto kkrt_receiver = petace::verse::VerseFactory<petace::verse::NcoOtExtReceiver>::get_instance().build(
+                    petace::verse::OTScheme::KkrtReceiver, params);
+
+            std::size_t bytes_sent = net->get_bytes_sent();
+            std::size_t bytes_received = net->get_bytes_received();
+            double begin = get_unix_timestamp();
+            LOG(INFO) << std::fixed << "case kkrt_setup_" << setup.first << "_" << params.base_ot_sizes << "_bench"
+                      << " begin " << begin << " " << test_number;
+
+            for (size_t i = 0; i < test_number; i++) {
+                if (party_id == 0) {
+                    base_receiver->receive(net, base_choices, base_recv_ots);
+                    kkrt_sender->set_base_ots(base_choices, base_recv_ots);
+                } else {
+                    base_sender->send(net, base_send_ots);
+                    kkrt_receiver->set_base_ots(base_send_ots);
+                }
+            }
+
+            double end = get_unix_timestamp();
+
+            LOG(INFO) << std::fixed << "case kkrt_setup_" << setup.first << "_" << params.base_ot_sizes << "_bench"
+                      << " end " << end << " " << end - begin << "s " << net->get_bytes_sent() - bytes_sent << " "
+                      << net->get_bytes_received() - bytes_received;
+        } catch (const std::exception& e) {
+            std::cerr << e.what() << '\n';
+        }
+    }
+}
+
+void iknp_large_bench(
+        const std::shared_ptr<petace::network::Network>& net, std::size_t party_id, std::size_t test_number) {
+    // Compare heap buffers with huge-page buffers bound to node 0 on batches of 2^20 ots (16 MB matrices). The first
+    // batch of each setting includes the page faults of its fresh buffers.
+    std::vector<std::pair<std::string, bool>> settings = {{"heap", false}, {"huge_pages", true}};
+    for (auto& setting : settings) {
+        try {
+            petace::verse::VerseParams params;
+            params.base_ot_sizes = 128;
+            params.ext_ot_sizes = std::size_t(1) << 20;
+            params.num_threads = 4;
+            params.huge_pages = setting.second;
+            params.numa_node = setting.second ? 0 : -1;
+            std::vector<petace::verse::block> base_recv_ots;
+            std::vector<std::array<petace::verse::block, 2>> base_send_ots;
+            std::vector<petace::verse::block> base_choices;
+            std::vector<petace::verse::block> ext_choices;
+            base_choices.emplace_back(petace::verse::read_block_from_dev_urandom());
+            for (std::size_t i = 0; i < params.ext_ot_sizes / 128; i++) {
+                ext_choices.emplace_back(petace::verse::read_block_from_dev_urandom());
+            }
+
+            auto npot_sender = petace::verse::VerseFactory<petace::verse::BaseOtSender>::get_instance().build(
+                    petace::verse::OTScheme::NaorPinkasSender, params);
+            auto npot_receiver = petace::verse::VerseFactory<petace::verse::BaseOtReceiver>::get_instance().build(
+                    petace::verse::OTScheme::NaorPinkasReceiver, params);
+            auto iknp_sender = petace::verse::VerseFactory<petace::verse::OtExtSender>::get_instance().build(
+                    petace::verse::OTScheme::IknpSender, params);
+            auto iknp_receiver = petace::verse::VerseFactory<petace::verse::OtExtReceiver>::get_instance().build(
+                    petace::verse::OTScheme::IknpReceiver, params);
+
+            std::vector<std::array<petace::verse::block, 2>> send_msgs;
+            std::vector<petace::verse::block> recv_msgs;
+            if (party_id == 0) {
+                npot_receiver->receive(net, base_choices, base_recv_ots);
+                iknp_sender->set_base_ots(base_choices, base_recv_ots);
+            } else {
+                npot_sender->send(net, base_send_ots);
+                iknp_receiver->set_base_ots(base_send_ots);
+            }
+
+            std::size_t steady_allocations = 0;
+            double begin = get_unix_timestamp();
+            double first = begin;
+            LOG(INFO) << std::fixed << "case iknp_large_" << setting.first << "_" << params.ext_ot_sizes << "_bench"
+                      << " begin " << begin << " " << test_number;
+            for (size_t i = 0; i < test_number; i++) {
+                std::size_t allocations = allocation_count();
+                if (party_id == 0) {
+                    iknp_sender->send(net, send_msgs);
+                } else {
+                    iknp_receiver->receive(net, ext_choices, recv_msgs);
+                }
+                // Later batches should not allocate, also with the work split over the worker threads.
+                if (i == 0) {
+                    first = get_unix_timestamp();
+                } else {
+                    steady_allocations += allocation_count() - allocations;
+                }
+            }
+            double end = get_unix_timestamp();
+
+            LOG(INFO) << std::fixed << "case iknp_large_" << setting.first << "_" << params.ext_ot_sizes << "_bench"
+                      << " end " << end << " " << end - begin << "s first " << first - begin << "s steady "
+                      << (end - first) / std::max<std::size_t>(test_number - 1, 1) << "s/batch allocs/batch "
+                      << steady_allocations / std::max<std::size_t>(test_number - 1, 1);
+        } catch (const std::exception& e) {
+            std::cerr << e.what() << '\n';
+        }
+    }
+}
+
+void arithmetic_triple_bench(
+        const std::shared_ptr<petace::network::Network>& net, std::size_t party_id, std::size_t test_number) {
+    for (std::size_t bit_length : {32, 64}) {
+        try {
+            petace::verse::VerseParams params;
+            params.base_ot_sizes = 128;
+            params.ext_ot_sizes = std::size_t(1) << 16;
+            std::size_t triples = std::size_t(1) << 14;
+            petace::verse::ArithmeticTripleGenerator generator(params, bit_length, party_id == 0);
+            generator.setup(net);
+            std::vector<std::uint64_t> a, b, c;
+
+            double begin = get_unix_timestamp();
+            LOG(INFO) << std::fixed << "case arithmetic_triple_" << bit_length << "_" << triples << "_bench"
+                      << " begin " << begin << " " << test_number;
+            for (size_t i = 0; i < test_number; i++) {
+                generator.generate(net, triples, a, b, c);
+            }
+            double end = get_unix_timestamp();
+
+            LOG(INFO) << std::fixed << "case arithmetic_triple_" << bit_length << "_" << triples << "_bench"
+                      << " end " << end << " " << end - begin << "s " << net->get_bytes_sent() << " "
+                      << net->get_bytes_received() << " triples/s "
+                      << static_cast<double>(triples * test_number) / (end - begin);
+        } catch (const std::exception& e) {
+            std::cerr << e.what() << '\n';
+        }
+    }
+}
+
+void boolean_triple_bench(
+        const std::shared_ptr<petace::network::Network>& net, std::size_t party_id, std::size_t test_number) {
+    try {
+        petace::verse::VerseParams params;
+        params.base_ot_sizes = 128;
+        params.ext_ot_sizes = std::size_t(1) << 20;
+        std::size_t words = std::size_t(1) << 14;
+        petace::verse::BooleanTripleGenerator generator(params, party_id == 0);
+        generator.setup(net);
+        std::vector<std::uint64_t> a(words), b(words), c(words);
+
+        double begin = get_unix_timestamp();
+        LOG(INFO) << std::fixed << "case boolean_triple_" << words * 64 << "_bench"
+                  << " begin " << begin << " " << test_number;
+        for (size_t i = 0; i < test_number; i++) {
+            generator.generate(net, words, a.data(), b.data(), c.data());
+        }
+        double end = get_unix_timestamp();
+
+        LOG(INFO) << std::fixed << "case boolean_triple_" << words * 64 << "_bench"
+                  << " end " << end << " " << end - begin << "s " << net->get_bytes_sent() << " "
+                  << net->get_bytes_received() << " triples/s "
+                  << static_cast<double>(words * 64 * test_number) / (end - begin);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << '\n';
+    }
+}
+
+void kk13_ot_bench(
+        const std::shared_ptr<petace::network::Network>& net, std::size_t party_id, std::size_t test_number) {
+    // The sender of a 1-out-of-n table lookup encodes all n inputs of every ot, so compare kk13 and kkrt per n.
+    struct NcoScheme {
+        std::string name;
+        std::size_t base_ot_sizes;
+        petace::verse::OTScheme sender;
+        petace::verse::OTScheme receiver;
+    };
+    std::vector<NcoScheme> schemes = {
+            {"kk13", petace::verse::kKk13BaseOts, petace::verse::OTScheme::Kk13Sender,
+                    petace::verse::OTScheme::Kk13Receiver},
+            {"kkrt", 512, petace::verse::OTScheme::KkrtSender, petace::verse::OTScheme::KkrtReceiver}};
+    for (auto& scheme : schemes) {
+        try {
+            petace::verse::VerseParams params;
+            params.base_ot_sizes = scheme.base_ot_sizes;
+            params.ext_ot_sizes = 1024;
+            std::vector<petace::verse::block> base_choices;
+            for (std::size_t i = 0; i < params.base_ot_sizes / 128; i++) {
+                base_choices.emplace_back(petace::verse::read_block_from_dev_urandom());
+            }
+            auto npot_sender = petace::verse::VerseFactory<petace::verse::BaseOtSender>::get_instance().build(
+                    petace::verse::OTScheme::NaorPinkasSender, params);
+            auto npot_receiver = petace::verse::VerseFactory<petace::verse::BaseOtReceiver>::get_instance().build(
+                    petace::verse::OTScheme::NaorPinkasReceiver, params);
+            auto nco_sender = petace::verse::VerseFactory<petace::verse::NcoOtExtSender>::get_instance().build(
+                    scheme.sender, params);
+            auto nco_receiver = petace::verse::VerseFactory<petace::verse::NcoOtExtReceiver>::get_instance().build(
+                    scheme.receiver, params);
+            if (party_id == 0) {
+                std::vector<petace::verse::block> base_recv_ots;
+                npot_receiver->receive(net, base_choices, base_recv_ots);
+                nco_sender->set_base_ots(base_choices, base_recv_ots);
+            } else {
+                std::vector<std::array<petace::verse::block, 2>> base_send_ots;
+                npot_sender->send(net, base_send_ots);
+                nco_receiver->set_base_ots(base_send_ots);
+            }
+
+            for (std::size_t n : {4, 16, 64, 256}) {
+                std::vector<petace::verse::block> choices;
+                for (std::size_t i = 0; i < params.ext_ot_sizes; i++) {
+                    choices.emplace_back(_mm_set_epi64x(0, i % n));
+                }
+                std::vector<petace::verse::block> messages;
+                petace::verse::block encoded;
+
+                double begin = get_unix_timestamp();
+                LOG(INFO) << std::fixed << "case " << scheme.name << "_1_of_" << n << "_" << params.ext_ot_sizes
+                          << "_bench begin " << begin << " " << test_number;
+                for (size_t i = 0; i < test_number; i++) {
+                    if (party_id == 0) {
+                        nco_sender->send(net, params.ext_ot_sizes);
+                        for (std::size_t j = 0; j < params.ext_ot_sizes; j++) {
+                            for (std::size_t input = 0; input < n; input++) {
+                                nco_sender->encode(j, _mm_set_epi64x(0, input), encoded);
+                            }
+                        }
+                    } else {
+                        nco_receiver->receive(net, choices, messages);
+                    }
+                }
+                double end = get_unix_timestamp();
+
+                LOG(INFO) << std::fixed << "case " << scheme.name << "_1_of_" << n << "_" << params.ext_ot_sizes
+                          << "_bench end " << end << " " << end - begin << "s " << net->get_bytes_sent() << " "
+                          << net->get_bytes_received();
+            }
+        } catch (const std::exception& e) {
+            std::cerr << e.what() << '\n';
+        }
+    }
+}
+
+void nco_chosen_bench(
+        const std::shared_ptr<petace::network::Network>& net, std::size_t party_id, std::size_t test_number) {
+    // Every run transfers 2^20 chosen messages, n per ot.
+    struct NcoScheme {
+        std::string name;
+        std::size_t base_ot_sizes;
+        std::size_t max_n;
+        petace::verse::OTScheme sender;
+        petace::verse::OTScheme receiver;
+    };
+    std::vector<NcoScheme> schemes = {
+            {"kk13", petace::verse::kKk13BaseOts, petace::verse::kKk13MaxChoices, petace::verse::OTScheme::Kk13Sender,
+                    petace::verse::OTScheme::Kk13Receiver},
+            {"kkrt", 512, std::size_t(1) << 16, petace::verse::OTScheme::KkrtSender,
+                    petace::verse::OTScheme::KkrtReceiver}};
+    for (auto& scheme : schemes) {
+        try {
+            petace::verse::VerseParams params;
+            params.base_ot_sizes = scheme.base_ot_sizes;
+            std::vector<petace::verse::block> base_choices;
+            for (std::size_t i = 0; i < params.base_ot_sizes / 128; i++) {
+                base_choices.emplace_back(petace::verse::read_block_from_dev_urandom());
+            }
+            auto npot_sender = petace::verse::VerseFactory<petace::verse::BaseOtSender>::get_instance().build(
+                    petace::verse::OTScheme::NaorPinkasSender, params);
+            auto npot_receiver = petace::verse::VerseFactory<petace::verse::BaseOtReceiver>::get_instance().build(
+                    petace::verse::OTScheme::NaorPinkasReceiver, params);
+            auto nco_sender = petace::verse::VerseFactory<petace::verse::NcoOtExtSender>::get_instance().build(
+                    scheme.sender, params);
+            auto nco_receiver = petace::verse::VerseFactory<petace::verse::NcoOtExtReceiver>::get_instance().build(
+                    scheme.receiver, params);
+            if (party_id == 0) {
+                std::vector<petace::verse::block> base_recv_ots;
+                npot_receiver->receive(net, base_choices, base_recv_ots);
+                nco_sender->set_base_ots(base_choices, base_recv_ots);
+            } else {
+                std::vector<std::array<petace::verse::block, 2>> base_send_ots;
+                npot_sender->send(net, base_send_ots);
+                nco_receiver->set_base_ots(base_send_ots);
+            }
+
+            for (std::size_t n = 16; n <= scheme.max_n; n *= 16) {
+                std::size_t ots = (std::size_t(1) << 20) / n;
+                std::vector<petace::verse::block> inputs(party_id == 0 ? ots * n : 0);
+                std::vector<petace::verse::block> choices;
+                for (std::size_t i = 0; i < ots; i++) {
+                    choices.emplace_back(_mm_set_epi64x(0, i % n));
+                }
+                std::vector<petace::verse::block> messages;
+
+                double begin = get_unix_timestamp();
+                LOG(INFO) << std::fixed << "case nco_chosen_" << scheme.name << "_1_of_" << n << "_" << ots
+                          << "_bench begin " << begin << " " << test_number;
+                for (size_t i = 0; i < test_number; i++) {
+                    if (party_id == 0) {
+                        nco_sender->send_chosen(net, inputs, n);
+                    } else {
+                        nco_receiver->receive_chosen(net, choices, n, messages);
+                    }
+                }
+                double end = get_unix_timestamp();
+
+                LOG(INFO) << std::fixed << "case nco_chosen_" << scheme.name << "_1_of_" << n << "_" << ots
+                          << "_bench end " << end << " " << end - begin << "s " << net->get_bytes_sent() << " "
+                          << net->get_bytes_received() << " ots/s "
+                          << static_cast<double>(ots * test_number) / (end - begin) << " messages/s "
+                          << static_cast<double>(ots * n * test_number) / (end - begin);
+            }
+        } catch (const std::exception& e) {
+            std::cerr << e.what() << '\n';
+        }
+    }
+}
+
+void mp_oprf_bench(
+        const std::shared_ptr<petace::network::Network>& net, std::size_t party_id, std::size_t test_number) {
+    // Both sides hold n items; party 0 is the oprf sender and evaluates its items test_number times.
+    for (std::size_t log_n : {20, 22, 24}) {
+        try {
+            std::size_t n = std::size_t(1) << log_n;
+            petace::verse::VerseParams params;
+            params.base_ot_sizes = petace::verse::kMpOprfWidth;
+            params.num_threads = std::max<std::size_t>(1, std::thread::hardware_concurrency());
+            std::vector<petace::verse::block> items(n);
+            for (std::size_t i = 0; i < n; i++) {
+                items[i] = _mm_set_epi64x(static_cast<long long>(party_id), static_cast<long long>(i));
+            }
+            std::vector<petace::verse::block> outputs;
+
+            double begin = get_unix_timestamp();
+            LOG(INFO) << std::fixed << "case mp_oprf_" << n << "_bench begin " << begin << " " << test_number;
+            if (party_id == 0) {
+                petace::verse::MpOprfSender sender(params);
+                sender.setup(net, n);
+                double setup_end = get_unix_timestamp();
+                for (size_t i = 0; i < test_number; i++) {
+                    sender.evaluate(items, outputs);
+                }
+                double end = get_unix_timestamp();
+                LOG(INFO) << std::fixed << "case mp_oprf_" << n << "_bench end " << end << " " << end - begin << "s "
+                          << net->get_bytes_sent() << " " << net->get_bytes_received() << " setup "
+                          << setup_end - begin << "s evaluations/s "
+                          << static_cast<double>(n * test_number) / (end - setup_end);
+            } else {
+                petace::verse::MpOprfReceiver receiver(params);
+                receiver.receive(net, items, outputs);
+                double end = get_unix_timestamp();
+                LOG(INFO) << std::fixed << "case mp_oprf_" << n << "_bench end " << end << " " << end - begin << "s "
+                          << net->get_bytes_sent() << " " << net->get_bytes_received();
+            }
+        } catch (const std::exception& e) {
+            std::cerr << e.what() << '\n';
+        }
+    }
+}
+
+void iknp_duplex_bench(
+        const std::shared_ptr<petace::network::Network>& net, std::size_t party_id, std::size_t test_number) {
+    // Both parties need 2^20 ots as sender and 2^20 as receiver. "sequential" runs the two extensions back to back,
+    // "duplex" interleaves their chunks over the same connection.
+    try {
+        petace::verse::VerseParams params;
+        params.base_ot_sizes = 128;
+        params.ext_ot_sizes = std::size_t(1) << 20;
+        params.chunk_size = std::size_t(1) << 16;
+        petace::verse::IknpDuplexOtExt duplex(
+                params.base_ot_sizes, params.ext_ot_sizes, params.num_threads, params.chunk_size);
+        auto npot_sender = petace::verse::VerseFactory<petace::verse::BaseOtSender>::get_instance().build(
+                petace::verse::OTScheme::NaorPinkasSender, params);
+        auto npot_receiver = petace::verse::VerseFactory<petace::verse::BaseOtReceiver>::get_instance().build(
+                petace::verse::OTScheme::NaorPinkasReceiver, params);
+        std::vector<petace::verse::block> base_choices{petace::verse::read_block_from_dev_urandom()};
+        std::vector<petace::verse::block> base_recv_ots;
+        std::vector<std::array<petace::verse::block, 2>> base_send_ots;
+        if (party_id == 0) {
+            npot_receiver->receive(net, base_choices, base_recv_ots);
+            npot_sender->send(net, base_send_ots);
+        } else {
+            npot_sender->send(net, base_send_ots);
+            npot_receiver->receive(net, base_choices, base_recv_ots);
+        }
+        duplex.set_base_ots(base_choices, base_recv_ots, base_send_ots);
+        petace::verse::IknpOtExtSender iknp_sender(
+                params.base_ot_sizes, params.ext_ot_sizes, params.num_threads, params.chunk_size);
+        petace::verse::IknpOtExtReceiver iknp_receiver(
+                params.base_ot_sizes, params.ext_ot_sizes, params.num_threads, params.chunk_size);
+        iknp_sender.set_base_ots(base_choices, base_recv_ots);
+        iknp_receiver.set_base_ots(base_send_ots);
+
+        std::vector<petace::verse::block> ext_choices;
+        for (std::size_t i = 0; i < params.ext_ot_sizes / 128; i++) {
+            ext_choices.emplace_back(petace::verse::read_block_from_dev_urandom());
+        }
+        std::vector<std::array<petace::verse::block, 2>> send_msgs;
+        std::vector<petace::verse::block> recv_msgs;
+
+        for (std::string mode : {"sequential", "duplex"}) {
+            double begin = get_unix_timestamp();
+            LOG(INFO) << std::fixed << "case iknp_duplex_" << mode << "_" << params.ext_ot_sizes << "_bench begin "
+                      << begin << " " << test_number;
+            for (size_t i = 0; i < test_number; i++) {
+                if (mode == "duplex") {
+                    duplex.extend(net, send_msgs, ext_choices, recv_msgs);
+                } else if (party_id == 0) {
+                    iknp_sender.send(net, send_msgs);
+                    iknp_receiver.receive(net, ext_choices, recv_msgs);
+                } else {
+                    iknp_receiver.receive(net, ext_choices, recv_msgs);
+                    iknp_sender.send(net, send_msgs);
+                }
+            }
+            double end = get_unix_timestamp();
+            LOG(INFO) << std::fixed << "case iknp_duplex_" << mode << "_" << params.ext_ot_sizes << "_bench end "
+                      << end << " " << end - begin << "s " << (end - begin) / static_cast<double>(test_number)
+                      << "s/round";
+        }
     } catch (const std::exception& e) {
         std::cerr << e.what() << '\n';
     }
 }
+
+void striped_network_bench(
+        const petace::network::NetParams& net_params, std::size_t party_id, std::size_t test_number) {
+    // Connection i of a striped network uses the ports of net_params shifted by 2 * (i + 1); every setting opens fresh
+    // connections on ports after those of the previous one. Party 0 sends test_number frames of 64 MB, then runs
+    // test_number iknp batches of 2^18 ots as sender.
+    std::size_t port_offset = 2;
+    for (std::size_t k : {1, 2, 4, 8}) {
+        try {
+            std::vector<std::shared_ptr<petace::network::Network>> connections;
+            for (std::size_t i = 0; i < k; i++) {
+                petace::network::NetParams params = net_params;
+                params.local_port = static_cast<std::uint16_t>(net_params.local_port + port_offset);
+                params.remote_port = static_cast<std::uint16_t>(net_params.remote_port + port_offset);
+                port_offset += 2;
+                connections.emplace_back(petace::network::NetFactory::get_instance().build(
+                        petace::network::NetScheme::SOCKET, params));
+            }
+            auto net = std::make_shared<petace::verse::StripedNetwork>(connections);
+
+            std::vector<char> payload(std::size_t(64) << 20);
+            double begin = get_unix_timestamp();
+            LOG(INFO) << std::fixed << "case striped_network_" << k << "_bench begin " << begin << " " << test_number;
+            for (size_t i = 0; i < test_number; i++) {
+                if (party_id == 0) {
+                    petace::verse::send_frame(net, payload.data(), payload.size());
+                } else {
+                    petace::verse::recv_frame(net, payload.data(), payload.size());
+                }
+            }
+            // Close the transfer with a round trip so that both parties stop the clock on delivery.
+            std::uint8_t ack = 0;
+            if (party_id == 0) {
+                net->recv_data(&ack, 1);
+            } else {
+                net->send_data(&ack, 1);
+            }
+            double transfer_end = get_unix_timestamp();
+
+            petace::verse::VerseParams params;
+            params.base_ot_sizes = 128;
+            params.ext_ot_sizes = std::size_t(1) << 18;
+            std::vector<petace::verse::block> base_choices{petace::verse::read_block_from_dev_urandom()};
+            std::vector<petace::verse::block> base_recv_ots;
+            std::vector<std::array<petace::verse::block, 2>> base_send_ots;
+            std::vector<petace::verse::block> ext_choices(params.ext_ot_sizes / 128);
+            std::vector<std::array<petace::verse::block, 2>> send_msgs;
+            std::vector<petace::verse::block> recv_msgs;
+            petace::verse::IknpOtExtSender iknp_sender(params.base_ot_sizes, params.ext_ot_sizes);
+            petace::verse::IknpOtExtReceiver iknp_receiver(params.base_ot_sizes, params.ext_ot_sizes);
+            if (party_id == 0) {
+                auto npot_receiver = petace::verse::VerseFactory<petace::verse::BaseOtReceiver>::get_instance().build(
+                        petace::verse::OTScheme::NaorPinkasReceiver, params);
+                npot_receiver->receive(net, base_choices, base_recv_ots);
+                iknp_sender.set_base_ots(base_choices, base_recv_ots);
+            } else {
+                auto npot_sender = petace::verse::VerseFactory<petace::verse::BaseOtSender>::get_instance().build(
+                        petace::verse::OTScheme::NaorPinkasSender, params);
+                npot_sender->send(net, base_send_ots);
+                iknp_receiver.set_base_ots(base_send_ots);
+            }
+            double ot_begin = get_unix_timestamp();
+            for (size_t i = 0; i < test_number; i++) {
+                if (party_id == 0) {
+                    iknp_sender.send(net, send_msgs);
+                } else {
+                    iknp_receiver.receive(net, ext_choices, recv_msgs);
+                }
+            }
+            double end = get_unix_timestamp();
+
+            LOG(INFO) << std::fixed << "case striped_network_" << k << "_bench end " << end << " " << end - begin
+                      << "s Gbit/s "
+                      << static_cast<double>(payload.size() * test_number) * 8 / 1e9 / (transfer_end - begin)
+                      << " iknp ots/s " << static_cast<double>(params.ext_ot_sizes * test_number) / (end - ot_begin);
+        } catch (const std::exception& e) {
+            std::cerr << e.what() << '\n';
+        }
+    }
+}
+
+namespace {
+
+// Run fn as one stage of a case and log its time, traffic and hardware counters divided by units.
+template <class Fn>
+void perf_stage(PerfCounters& counters, const std::string& name, const std::shared_ptr<petace::network::Network>& net,
+        double units, const std::string& unit, const Fn& fn) {
+    std::size_t sent = net->get_bytes_sent();
+    std::size_t received = net->get_bytes_received();
+    double begin = get_unix_timestamp();
+    LOG(INFO) << std::fixed << "stage " << name << " begin " << begin;
+    counters.start();
+    fn();
+    PerfSample sample = counters.stop();
+    double end = get_unix_timestamp();
+    LOG(INFO) << std::fixed << "stage " << name << " end " << end << " " << end - begin << "s "
+              << net->get_bytes_sent() - sent << " " << net->get_bytes_received() - received << " "
+              << PerfCounters::format(sample, units, unit);
+}
+
+}  // namespace
+
+void perf_counters_bench(
+        const std::shared_ptr<petace::network::Network>& net, std::size_t party_id, std::size_t test_number) {
+    // Every scheme runs in three stages: the base ots, test_number extensions and, for 1-out-of-n schemes, encoding
+    // one input per ot on the sender. Counters cover the calling thread, so num_threads stays at 1.
+    PerfCounters counters;
+    if (!counters.available()) {
+        LOG(INFO) << "perf_event_open is not available; counters are reported as n/a";
+    }
+    struct Scheme {
+        std::string name;
+        std::size_t base_ot_sizes;
+        std::size_t ext_ot_sizes;
+        bool nco;
+        petace::verse::OTScheme sender;
+        petace::verse::OTScheme receiver;
+    };
+    std::vector<Scheme> schemes = {
+            {"iknp", 128, std::size_t(1) << 16, false, petace::verse::OTScheme::IknpSender,
+                    petace::verse::OTScheme::IknpReceiver},
+            {"kkrt", 512, std::size_t(1) << 14, true, petace::verse::OTScheme::KkrtSender,
+                    petace::verse::OTScheme::KkrtReceiver},
+            {"kk13", petace::verse::kKk13BaseOts, std::size_t(1) << 14, true, petace::verse::OTScheme::Kk13Sender,
+                    petace::verse::OTScheme::Kk13Receiver}};
+    for (auto& scheme : schemes) {
+        try {
+            petace::verse::VerseParams params;
+            params.base_ot_sizes = scheme.base_ot_sizes;
+            params.ext_ot_sizes = scheme.ext_ot_sizes;
+            std::vector<petace::verse::block> base_choices;
+            for (std::size_t i = 0; i < params.base_ot_sizes / 128; i++) {
+                base_choices.emplace_back(petace::verse::read_block_from_dev_urandom());
+            }
+            // 2-out-of-1 choices are bits packed in blocks, 1-out-of-n choices are one block per ot.
+            std::vector<petace::verse::block> choices;
+            std::size_t num_choices = scheme.nco ? params.ext_ot_sizes : params.ext_ot_sizes / 128;
+            for (std::size_t i = 0; i < num_choices; i++) {
+                choices.emplace_back(
+                        scheme.nco ? _mm_set_epi64x(0, i % 16) : petace::verse::read_block_from_dev_urandom());
+            }
+            auto npot_sender = petace::verse::VerseFactory<petace::verse::BaseOtSender>::get_instance().build(
+                    petace::verse::OTScheme::NaorPinkasSender, params);
+            auto npot_receiver = petace::verse::VerseFactory<petace::verse::BaseOtReceiver>::get_instance().build(
+                    petace::verse::OTScheme::NaorPinkasReceiver, params);
+            std::unique_ptr<petace::verse::OtExtSender> ot_sender = nullptr;
+            std::unique_ptr<petace::verse::OtExtReceiver> ot_receiver = nullptr;
+            std::unique_ptr<petace::verse::NcoOtExtSender> nco_sender = nullptr;
+            std::unique_ptr<petace::verse::NcoOtExtReceiver> nco_receiver = nullptr;
+            if (scheme.nco) {
+                nco_sender = petace::verse::VerseFactory<petace::verse::NcoOtExtSender>::get_instance().build(
+                        scheme.sender, params);
+                nco_receiver = petace::verse::VerseFactory<petace::verse::NcoOtExtReceiver>::get_instance().build(
+                        scheme.receiver, params);
+            } else {
+                ot_sender = petace::verse::VerseFactory<petace::verse::OtExtSender>::get_instance().build(
+                        scheme.sender, params);
+                ot_receiver = petace::verse::VerseFactory<petace::verse::OtExtReceiver>::get_instance().build(
+                        scheme.receiver, params);
+            }
+
+            std::string name = "perf_" + scheme.name + "_" + std::to_string(params.ext_ot_sizes);
+            double begin = get_unix_timestamp();
+            LOG(INFO) << std::fixed << "case " << name << "_bench begin " << begin << " " << test_number;
+            perf_stage(counters, name + "_base", net, static_cast<double>(params.base_ot_sizes), "base_ot", [&] {
+                if (party_id == 0) {
+                    std::vector<petace::verse::block> base_recv_ots;
+                    npot_receiver->receive(net, base_choices, base_recv_ots);
+                    if (scheme.nco) {
+                        nco_sender->set_base_ots(base_choices, base_recv_ots);
+                    } else {
+                        ot_sender->set_base_ots(base_choices, base_recv_ots);
+                    }
+                } else {
+                    std::vector<std::array<petace::verse::block, 2>> base_send_ots;
+                    npot_sender->send(net, base_send_ots);
+                    if (scheme.nco) {
+                        nco_receiver->set_base_ots(base_send_ots);
+                    } else {
+                        ot_receiver->set_base_ots(base_send_ots);
+                    }
+                }
+            });
+
+            double ots = static_cast<double>(params.ext_ot_sizes * test_number);
+            std::vector<std::array<petace::verse::block, 2>> send_msgs;
+            std::vector<petace::verse::block> recv_msgs;
+            perf_stage(counters, name + "_extend", net, ots, "ot", [&] {
+                for (std::size_t i = 0; i < test_number; i++) {
+                    if (party_id == 0 && scheme.nco) {
+                        nco_sender->send(net, params.ext_ot_sizes);
+                    } else if (party_id == 0) {
+                        ot_sender->send(net, send_msgs);
+                    } else if (scheme.nco) {
+                        nco_receiver->receive(net, choices, recv_msgs);
+                    } else {
+                        ot_receiver->receive(net, choices, recv_msgs);
+                    }
+                }
+            });
+
+            if (scheme.nco && party_id == 0) {
+                std::vector<petace::verse::block> outputs(params.ext_ot_sizes);
+                perf_stage(counters, name + "_encode", net, static_cast<double>(params.ext_ot_sizes), "ot", [&] {
+                    for (std::size_t i = 0; i < params.ext_ot_sizes; i++) {
+                        nco_sender->encode(i, choices[i], outputs[i]);
+                    }
+                });
+            }
+
+            double end = get_unix_timestamp();
+            LOG(INFO) << std::fixed << "case " << name << "_bench end " << end << " " << end - begin << "s "
+                      << net->get_bytes_sent() << " " << net->get_bytes_received();
+        } catch (const std::exception& e) {
+            std::cerr << e.what() << '\n';
+        }
+    }
+}
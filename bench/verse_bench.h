@@ -14,12 +14,44 @@
 
 #pragma once
 
+#include "network/net_factory.h"
 #include "network/net_socket.h"
 
 #include "verse/verse_factory.h"
 
 void np_ot_bench(const std::shared_ptr<petace::network::Network>& net, std::size_t party_id, std::size_t test_number);
 
+void simplest_ot_bench(
+        const std::shared_ptr<petace::network::Network>& net, std::size_t party_id, std::size_t test_number);
+
 void iknp_ot_bench(const std::shared_ptr<petace::network::Network>& net, std::size_t party_id, std::size_t test_number);
 
 void kkrt_ot_bench(const std::shared_ptr<petace::network::Network>& net, std::size_t party_id, std::size_t test_number);
+
+void kkrt_setup_bench(
+        const std::shared_ptr<petace::network::Network>& net, std::size_t party_id, std::size_t test_number);
+
+void iknp_large_bench(
+        const std::shared_ptr<petace::network::Network>& net, std::size_t party_id, std::size_t test_number);
+
+void arithmetic_triple_bench(
+        const std::shared_ptr<petace::network::Network>& net, std::size_t party_id, std::size_t test_number);
+
+void boolean_triple_bench(
+        const std::shared_ptr<petace::network::Network>& net, std::size_t party_id, std::size_t test_number);
+
+void kk13_ot_bench(const std::shared_ptr<petace::network::Network>& net, std::size_t party_id, std::size_t test_number);
+
+void nco_chosen_bench(
+        const std::shared_ptr<petace::network::Network>& net, std::size_t party_id, std::size_t test_number);
+
+void mp_oprf_bench(const std::shared_ptr<petace::network::Network>& net, std::size_t party_id, std::size_t test_number);
+
+void iknp_duplex_bench(
+        const std::shared_ptr<petace::network::Network>& net, std::size_t party_id, std::size_t test_number);
+
+void striped_network_bench(
+        const petace::network::NetParams& net_params, std::size_t party_id, std::size_t test_number);
+
+void perf_counters_bench(
+        const std::shared_ptr<petace::network::Network>& net, std::size_t party_id, std::size_t test_number);
@@ -0,0 +1,418 @@
+// Copyright 2023 TikTok Pte. Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "verse/base-ot/base-ot-cache/base_ot_cache.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+#include "solo/hash.h"
+
+#include "verse/util/aes.h"
+#include "verse/util/common.h"
+#include "verse/verse_factory.h"
+
+namespace petace {
+namespace verse {
+
+namespace {
+
+const std::size_t kDigestBytes = 32;
+const std::size_t kHmacBlockBytes = 64;
+const char kEntryMagic[4] = {'V', 'B', 'O', 'C'};
+const std::uint32_t kEntryVersion = 1;
+const solo::Byte kSenderEntry = 0;
+const solo::Byte kReceiverEntry = 1;
+
+void append(std::vector<solo::Byte>& out, const void* data, std::size_t nbyte) {
+    std::size_t offset = out.size();
+    out.resize(offset + nbyte);
+    if (nbyte != 0) {
+        std::memcpy(out.data() + offset, data, nbyte);
+    }
+}
+
+std::vector<solo::Byte> sha256(const std::vector<solo::Byte>& in) {
+    std::vector<solo::Byte> out(kDigestBytes);
+    auto hash = solo::Hash::create(solo::HashScheme::SHA_256);
+    hash->compute(in.data(), in.size(), out.data(), out.size());
+    return out;
+}
+
+std::vector<solo::Byte> hmac_sha256(const std::vector<solo::Byte>& key, const std::vector<solo::Byte>& message) {
+    std::vector<solo::Byte> padded_key = key.size() > kHmacBlockBytes ? sha256(key) : key;
+    padded_key.resize(kHmacBlockBytes, 0);
+    std::vector<solo::Byte> inner;
+    std::vector<solo::Byte> outer;
+    for (auto k : padded_key) {
+        inner.emplace_back(static_cast<solo::Byte>(static_cast<std::uint8_t>(k) ^ 0x36));
+        outer.emplace_back(static_cast<solo::Byte>(static_cast<std::uint8_t>(k) ^ 0x5c));
+    }
+    append(inner, message.data(), message.size());
+    auto inner_digest = sha256(inner);
+    append(outer, inner_digest.data(), inner_digest.size());
+    return sha256(outer);
+}
+
+std::vector<solo::Byte> derive_key(const std::vector<solo::Byte>& key, const char* purpose) {
+    std::vector<solo::Byte> in(purpose, purpose + std::strlen(purpose));
+    return hmac_sha256(key, in);
+}
+
+// XOR data with the AES-CTR keystream of a key derived from enc_key and the entry's random iv.
+void apply_keystream(const std::vector<solo::Byte>& enc_key, const block& iv, std::vector<solo::Byte>& data) {
+    std::vector<solo::Byte> in;
+    append(in, &iv, sizeof(iv));
+    auto digest = hmac_sha256(enc_key, in);
+    block seed;
+    std::memcpy(&seed, digest.data(), sizeof(seed));
+    std::vector<solo::Byte> keystream(data.size());
+    prg_stretch(&seed, 1, data.size(), keystream.data());
+    for (std::size_t i = 0; i < data.size(); i++) {
+        data[i] = static_cast<solo::Byte>(
+                static_cast<std::uint8_t>(data[i]) ^ static_cast<std::uint8_t>(keystream[i]));
+    }
+}
+
+bool equal_digest(const solo::Byte* a, const solo::Byte* b, std::size_t nbyte) {
+    std::uint8_t diff = 0;
+    for (std::size_t i = 0; i < nbyte; i++) {
+        diff = static_cast<std::uint8_t>(diff | (static_cast<std::uint8_t>(a[i]) ^ static_cast<std::uint8_t>(b[i])));
+    }
+    return diff == 0;
+}
+
+std::vector<solo::Byte> entry_label(solo::Byte role, const std::string& peer_id, std::uint64_t session_id) {
+    std::vector<solo::Byte> label;
+    append(label, &role, sizeof(role));
+    append(label, &session_id, sizeof(session_id));
+    append(label, peer_id.data(), peer_id.size());
+    return label;
+}
+
+std::string to_hex(const solo::Byte* data, std::size_t nbyte) {
+    const char* digits = "0123456789abcdef";
+    std::string out;
+    for (std::size_t i = 0; i < nbyte; i++) {
+        out.push_back(digits[static_cast<std::uint8_t>(data[i]) >> 4]);
+        out.push_back(digits[static_cast<std::uint8_t>(data[i]) & 0xf]);
+    }
+    return out;
+}
+
+bool same_block(const block& a, const block& b) {
+    return std::memcmp(&a, &b, sizeof(block)) == 0;
+}
+
+bool is_zero(const block& value) {
+    return same_block(value, _mm_setzero_si128());
+}
+
+// Send local and receive the peer's block by commit-then-reveal: each party sends SHA-256(value || salt) before
+// either value is revealed, so the party that speaks second cannot choose its value after seeing the other one.
+block exchange_committed(const std::shared_ptr<network::Network>& net, const block& local, bool send_first) {
+    auto hash = solo::Hash::create(solo::HashScheme::SHA_256);
+    std::array<block, 2> opening = {local, read_block_from_dev_urandom()};
+    std::array<block, 2> commitment;
+    hash->compute(reinterpret_cast<const solo::Byte*>(opening.data()), sizeof(opening),
+            reinterpret_cast<solo::Byte*>(commitment.data()), sizeof(commitment));
+
+    std::array<block, 2> remote_commitment;
+    std::array<block, 2> remote_opening;
+    if (send_first) {
+        send_block(net, commitment.data(), 2);
+        recv_block(net, remote_commitment.data(), 2);
+        send_block(net, opening.data(), 2);
+        recv_block(net, remote_opening.data(), 2);
+    } else {
+        recv_block(net, remote_commitment.data(), 2);
+        send_block(net, commitment.data(), 2);
+        recv_block(net, remote_opening.data(), 2);
+        send_block(net, opening.data(), 2);
+    }
+
+    std::array<block, 2> expected;
+    hash->compute(reinterpret_cast<const solo::Byte*>(remote_opening.data()), sizeof(remote_opening),
+            reinterpret_cast<solo::Byte*>(expected.data()), sizeof(expected));
+    if (!same_block(expected[0], remote_commitment[0]) || !same_block(expected[1], remote_commitment[1])) {
+        throw std::runtime_error("peer opened a different value than it committed to.");
+    }
+    return remote_opening[0];
+}
+
+// Both parties contribute a committed random block r and derive H(r_0 || r_1), where r_0 is the block of the party
+// that speaks first; the result is uniform as long as one of them is honest.
+block agree_on_block(const std::shared_ptr<network::Network>& net, bool send_first) {
+    block local = read_block_from_dev_urandom();
+    block remote = exchange_committed(net, local, send_first);
+    std::array<block, 2> in = send_first ? std::array<block, 2>{local, remote} : std::array<block, 2>{remote, local};
+    std::array<block, 2> digest;
+    auto hash = solo::Hash::create(solo::HashScheme::SHA_256);
+    hash->compute(reinterpret_cast<const solo::Byte*>(in.data()), sizeof(in),
+            reinterpret_cast<solo::Byte*>(digest.data()), sizeof(digest));
+    return digest[0];
+}
+
+// Return whether both parties hold an entry with the same non-zero cache id. The ids are committed first, so a party
+// without the entry cannot echo the peer's id to fake a cache hit.
+bool exchange_cache_id(const std::shared_ptr<network::Network>& net, const block& local, bool send_first) {
+    block remote = exchange_committed(net, local, send_first);
+    return !is_zero(local) && same_block(local, remote);
+}
+
+block rekey(solo::Hash& hash, const block& message, const block& nonce, std::uint64_t index) {
+    solo::Byte in[2 * sizeof(block) + sizeof(index)];
+    std::memcpy(in, &message, sizeof(block));
+    std::memcpy(in + sizeof(block), &nonce, sizeof(block));
+    std::memcpy(in + 2 * sizeof(block), &index, sizeof(index));
+    block out;
+    hash.compute(in, sizeof(in), reinterpret_cast<solo::Byte*>(&out), sizeof(out));
+    return out;
+}
+
+void check_cached_params(const VerseParams& params) {
+    if (params.net == nullptr) {
+        throw std::invalid_argument("network is not set.");
+    }
+    if (params.base_ot_sizes == 0) {
+        throw std::invalid_argument("base ot sizes is not supported.");
+    }
+}
+
+}  // namespace
+
+BaseOtCache::BaseOtCache(const std::string& directory, const std::vector<solo::Byte>& key) : directory_(directory) {
+    if (directory.empty()) {
+        throw std::invalid_argument("cache directory is not set.");
+    }
+    if (key.size() < sizeof(block)) {
+        throw std::invalid_argument("cache key is too short.");
+    }
+    enc_key_ = derive_key(key, "verse base ot cache encryption");
+    mac_key_ = derive_key(key, "verse base ot cache authentication");
+}
+
+std::string BaseOtCache::entry_path(const std::vector<solo::Byte>& label) const {
+    auto digest = hmac_sha256(mac_key_, label);
+    return directory_ + "/" + to_hex(digest.data(), sizeof(block)) + ".bot";
+}
+
+bool BaseOtCache::store(const std::vector<solo::Byte>& label, const std::vector<solo::Byte>& payload) const {
+    // Layout: magic, version, iv, payload length, encrypted payload, hmac over label and everything before it.
+    block iv = read_block_from_dev_urandom();
+    std::uint64_t length = payload.size();
+    std::vector<solo::Byte> ciphertext(payload);
+    apply_keystream(enc_key_, iv, ciphertext);
+
+    std::vector<solo::Byte> entry;
+    append(entry, kEntryMagic, sizeof(kEntryMagic));
+    append(entry, &kEntryVersion, sizeof(kEntryVersion));
+    append(entry, &iv, sizeof(iv));
+    append(entry, &length, sizeof(length));
+    append(entry, ciphertext.data(), ciphertext.size());
+    std::vector<solo::Byte> authenticated(label);
+    append(authenticated, entry.data(), entry.size());
+    auto tag = hmac_sha256(mac_key_, authenticated);
+    append(entry, tag.data(), tag.size());
+
+    // Write a temporary file and rename it, so a concurrent reader never sees a partial entry.
+    std::string path = entry_path(label);
+    std::string tmp_path = path + ".tmp";
+    {
+        std::ofstream out(tmp_path, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            return false;
+        }
+        out.write(reinterpret_cast<const char*>(entry.data()), static_cast<std::streamsize>(entry.size()));
+        if (!out) {
+            return false;
+        }
+    }
+    return std::rename(tmp_path.c_str(), path.c_str()) == 0;
+}
+
+bool BaseOtCache::load(const std::vector<solo::Byte>& label, std::vector<solo::Byte>& payload) const {
+    std::ifstream in(entry_path(label), std::ios::binary);
+    if (!in) {
+        return false;
+    }
+    std::vector<solo::Byte> entry;
+    std::transform(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>(), std::back_inserter(entry),
+            [](char c) { return static_cast<solo::Byte>(c); });
+
+    const std::size_t header_bytes =
+            sizeof(kEntryMagic) + sizeof(kEntryVersion) + sizeof(block) + sizeof(std::uint64_t);
+    if (entry.size() < header_bytes + kDigestBytes) {
+        return false;
+    }
+    std::size_t body_bytes = entry.size() - kDigestBytes;
+    std::vector<solo::Byte> authenticated(label);
+    append(authenticated, entry.data(), body_bytes);
+    auto tag = hmac_sha256(mac_key_, authenticated);
+    if (!equal_digest(tag.data(), entry.data() + body_bytes, kDigestBytes)) {
+        return false;
+    }
+
+    std::uint32_t version = 0;
+    block iv;
+    std::uint64_t length = 0;
+    const solo::Byte* cursor = entry.data() + sizeof(kEntryMagic);
+    std::memcpy(&version, cursor, sizeof(version));
+    cursor += sizeof(version);
+    std::memcpy(&iv, cursor, sizeof(iv));
+    cursor += sizeof(iv);
+    std::memcpy(&length, cursor, sizeof(length));
+    if (std::memcmp(entry.data(), kEntryMagic, sizeof(kEntryMagic)) != 0 || version != kEntryVersion ||
+            length != body_bytes - header_bytes) {
+        return false;
+    }
+    payload.assign(entry.begin() + static_cast<std::ptrdiff_t>(header_bytes),
+            entry.begin() + static_cast<std::ptrdiff_t>(body_bytes));
+    apply_keystream(enc_key_, iv, payload);
+    return true;
+}
+
+bool BaseOtCache::store_sender(const std::string& peer_id, std::uint64_t session_id, const block& cache_id,
+        const std::vector<std::array<block, 2>>& messages) const {
+    std::vector<solo::Byte> payload;
+    std::uint64_t count = messages.size();
+    append(payload, &cache_id, sizeof(cache_id));
+    append(payload, &count, sizeof(count));
+    append(payload, messages.data(), messages.size() * sizeof(messages[0]));
+    return store(entry_label(kSenderEntry, peer_id, session_id), payload);
+}
+
+bool BaseOtCache::load_sender(const std::string& peer_id, std::uint64_t session_id, block& cache_id,
+        std::vector<std::array<block, 2>>& messages) const {
+    std::vector<solo::Byte> payload;
+    if (!load(entry_label(kSenderEntry, peer_id, session_id), payload)) {
+        return false;
+    }
+    std::uint64_t count = 0;
+    if (payload.size() < sizeof(cache_id) + sizeof(count)) {
+        return false;
+    }
+    std::memcpy(&cache_id, payload.data(), sizeof(cache_id));
+    std::memcpy(&count, payload.data() + sizeof(cache_id), sizeof(count));
+    std::size_t offset = sizeof(cache_id) + sizeof(count);
+    if (payload.size() - offset != count * sizeof(messages[0])) {
+        return false;
+    }
+    messages.resize(count);
+    std::memcpy(messages.data(), payload.data() + offset, count * sizeof(messages[0]));
+    return true;
+}
+
+bool BaseOtCache::store_receiver(const std::string& peer_id, std::uint64_t session_id, const block& cache_id,
+        const std::vector<block>& choices, const std::vector<block>& messages) const {
+    std::vector<solo::Byte> payload;
+    std::uint64_t count = messages.size();
+    std::uint64_t choice_count = choices.size();
+    append(payload, &cache_id, sizeof(cache_id));
+    append(payload, &count, sizeof(count));
+    append(payload, &choice_count, sizeof(choice_count));
+    append(payload, choices.data(), choices.size() * sizeof(block));
+    append(payload, messages.data(), messages.size() * sizeof(block));
+    return store(entry_label(kReceiverEntry, peer_id, session_id), payload);
+}
+
+bool BaseOtCache::load_receiver(const std::string& peer_id, std::uint64_t session_id, block& cache_id,
+        std::vector<block>& choices, std::vector<block>& messages) const {
+    std::vector<solo::Byte> payload;
+    if (!load(entry_label(kReceiverEntry, peer_id, session_id), payload)) {
+        return false;
+    }
+    std::uint64_t count = 0;
+    std::uint64_t choice_count = 0;
+    std::size_t offset = sizeof(cache_id) + sizeof(count) + sizeof(choice_count);
+    if (payload.size() < offset) {
+        return false;
+    }
+    std::memcpy(&cache_id, payload.data(), sizeof(cache_id));
+    std::memcpy(&count, payload.data() + sizeof(cache_id), sizeof(count));
+    std::memcpy(&choice_count, payload.data() + sizeof(cache_id) + sizeof(count), sizeof(choice_count));
+    if (payload.size() - offset != (count + choice_count) * sizeof(block)) {
+        return false;
+    }
+    choices.resize(choice_count);
+    messages.resize(count);
+    std::memcpy(choices.data(), payload.data() + offset, choice_count * sizeof(block));
+    std::memcpy(messages.data(), payload.data() + offset + choice_count * sizeof(block), count * sizeof(block));
+    return true;
+}
+
+void BaseOtCache::erase(const std::string& peer_id, std::uint64_t session_id, bool is_sender) const {
+    auto label = entry_label(is_sender ? kSenderEntry : kReceiverEntry, peer_id, session_id);
+    std::remove(entry_path(label).c_str());
+}
+
+void rekey_base_ots(const block& nonce, std::vector<std::array<block, 2>>& messages) {
+    auto hash = solo::Hash::create(solo::HashScheme::SHA_256);
+    for (std::size_t i = 0; i < messages.size(); i++) {
+        messages[i][0] = rekey(*hash, messages[i][0], nonce, i);
+        messages[i][1] = rekey(*hash, messages[i][1], nonce, i);
+    }
+}
+
+void rekey_base_ots(const block& nonce, std::vector<block>& messages) {
+    auto hash = solo::Hash::create(solo::HashScheme::SHA_256);
+    for (std::size_t i = 0; i < messages.size(); i++) {
+        messages[i] = rekey(*hash, messages[i], nonce, i);
+    }
+}
+
+void cached_base_ot_send(const VerseParams& params, const BaseOtCache& cache, const std::string& peer_id,
+        std::uint64_t session_id, std::vector<std::array<block, 2>>& messages) {
+    check_cached_params(params);
+    block cache_id = _mm_setzero_si128();
+    if (!cache.load_sender(peer_id, session_id, cache_id, messages) || messages.size() != params.base_ot_sizes) {
+        cache_id = _mm_setzero_si128();
+    }
+    if (!exchange_cache_id(params.net, cache_id, true)) {
+        auto npot_sender = VerseFactory<BaseOtSender>::get_instance().build(OTScheme::NaorPinkasSender, params);
+        npot_sender->send(params.net, messages);
+        cache_id = agree_on_block(params.net, true);
+        cache.store_sender(peer_id, session_id, cache_id, messages);
+    }
+    rekey_base_ots(agree_on_block(params.net, true), messages);
+}
+
+void cached_base_ot_receive(const VerseParams& params, const BaseOtCache& cache, const std::string& peer_id,
+        std::uint64_t session_id, std::vector<block>& choices, std::vector<block>& messages) {
+    check_cached_params(params);
+    block cache_id = _mm_setzero_si128();
+    if (!cache.load_receiver(peer_id, session_id, cache_id, choices, messages) ||
+            messages.size() != params.base_ot_sizes) {
+        cache_id = _mm_setzero_si128();
+    }
+    if (!exchange_cache_id(params.net, cache_id, false)) {
+        choices.resize((params.base_ot_sizes + sizeof(block) * 8 - 1) / (sizeof(block) * 8));
+        for (auto& choice : choices) {
+            choice = read_block_from_dev_urandom();
+        }
+        auto npot_receiver = VerseFactory<BaseOtReceiver>::get_instance().build(OTScheme::NaorPinkasReceiver, params);
+        npot_receiver->receive(params.net, choices, messages);
+        cache_id = agree_on_block(params.net, false);
+        cache.store_receiver(peer_id, session_id, cache_id, choices, messages);
+    }
+    rekey_base_ots(agree_on_block(params.net, false), messages);
+}
+
+}  // namespace verse
+}  // namespace petace
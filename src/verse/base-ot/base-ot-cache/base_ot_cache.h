@@ -0,0 +1,180 @@
+// Copyright 2023 TikTok Pte. Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "network/network.h"
+#include "solo/prng.h"
+
+#include "verse/util/defines.h"
+
+namespace petace {
+namespace verse {
+
+/**
+ * @brief Opt-in on-disk cache of base ots, keyed by peer identity and session id.
+ *
+ * Every entry is encrypted with AES-128 in CTR mode and authenticated with HMAC-SHA256 under keys derived from a
+ * caller-provided secret. The entry also binds its peer identity, session id and role, so an entry copied to another
+ * name is rejected. A missing, truncated or tampered entry reads as a cache miss. Besides the base ots, an entry holds
+ * a cache id that both parties agreed on when the base ots were created; cached_base_ot_send and
+ * cached_base_ot_receive compare ids to make sure both sides hold the same run.
+ *
+ * @par Example.
+ * Refer to base_ot_cache_test.cpp.
+ */
+class BaseOtCache {
+public:
+    /**
+     * @brief Create a cache that stores its entries in directory.
+     *
+     * @param[in] directory An existing directory, readable and writable only by the owner of the secret.
+     * @param[in] key The secret from which the encryption and authentication keys are derived.
+     * @throws std::invalid_argument if directory is empty or key is shorter than 16 bytes.
+     */
+    BaseOtCache(const std::string& directory, const std::vector<solo::Byte>& key);
+
+    /**
+     * @brief Store the base ots of a base ot sender.
+     *
+     * @param[in] peer_id The identity of the peer.
+     * @param[in] session_id The session id.
+     * @param[in] cache_id The cache id both parties agreed on.
+     * @param[in] messages The base ot messages (m0, m1).
+     * @return Whether the entry was written.
+     */
+    bool store_sender(const std::string& peer_id, std::uint64_t session_id, const block& cache_id,
+            const std::vector<std::array<block, 2>>& messages) const;
+
+    /**
+     * @brief Load the base ots of a base ot sender.
+     *
+     * @param[in] peer_id The identity of the peer.
+     * @param[in] session_id The session id.
+     * @param[out] cache_id The cache id of the entry.
+     * @param[out] messages The base ot messages (m0, m1).
+     * @return Whether a valid entry was found.
+     */
+    bool load_sender(const std::string& peer_id, std::uint64_t session_id, block& cache_id,
+            std::vector<std::array<block, 2>>& messages) const;
+
+    /**
+     * @brief Store the base ots of a base ot receiver.
+     *
+     * @param[in] peer_id The identity of the peer.
+     * @param[in] session_id The session id.
+     * @param[in] cache_id The cache id both parties agreed on.
+     * @param[in] choices The chosen bits; one bit per message.
+     * @param[in] messages The chosen messages.
+     * @return Whether the entry was written.
+     */
+    bool store_receiver(const std::string& peer_id, std::uint64_t session_id, const block& cache_id,
+            const std::vector<block>& choices, const std::vector<block>& messages) const;
+
+    /**
+     * @brief Load the base ots of a base ot receiver.
+     *
+     * @param[in] peer_id The identity of the peer.
+     * @param[in] session_id The session id.
+     * @param[out] cache_id The cache id of the entry.
+     * @param[out] choices The chosen bits.
+     * @param[out] messages The chosen messages.
+     * @return Whether a valid entry was found.
+     */
+    bool load_receiver(const std::string& peer_id, std::uint64_t session_id, block& cache_id,
+            std::vector<block>& choices, std::vector<block>& messages) const;
+
+    /**
+     * @brief Remove an entry if it exists.
+     *
+     * @param[in] peer_id The identity of the peer.
+     * @param[in] session_id The session id.
+     * @param[in] is_sender Whether the entry belongs to the base ot sender.
+     */
+    void erase(const std::string& peer_id, std::uint64_t session_id, bool is_sender) const;
+
+private:
+    std::string entry_path(const std::vector<solo::Byte>& label) const;
+
+    bool store(const std::vector<solo::Byte>& label, const std::vector<solo::Byte>& payload) const;
+
+    bool load(const std::vector<solo::Byte>& label, std::vector<solo::Byte>& payload) const;
+
+    std::string directory_{};
+
+    std::vector<solo::Byte> enc_key_{};
+
+    std::vector<solo::Byte> mac_key_{};
+};
+
+/**
+ * @brief Derive fresh base ot messages of a base ot sender from cached ones.
+ *
+ * Message m_b of ot i becomes H(m_b || nonce || i), so a receiver that holds m_c derives the same fresh m_c.
+ *
+ * @param[in] nonce The session nonce both parties agreed on.
+ * @param[in,out] messages The base ot messages (m0, m1).
+ */
+void rekey_base_ots(const block& nonce, std::vector<std::array<block, 2>>& messages);
+
+/**
+ * @brief Derive fresh base ot messages of a base ot receiver from cached ones.
+ *
+ * @param[in] nonce The session nonce both parties agreed on.
+ * @param[in,out] messages The chosen messages.
+ */
+void rekey_base_ots(const block& nonce, std::vector<block>& messages);
+
+/**
+ * @brief Run the base ot sender through a cache.
+ *
+ * Both parties first compare their cache ids. If both hold the same entry, they agree on a fresh nonce and rekey the
+ * cached base ots, so no public-key operation is performed. Otherwise they run naor-pinkas, agree on a new cache id,
+ * store the result and rekey it as well. Every call therefore returns base ots that no other call has returned. Ids
+ * and nonce shares are exchanged by commit-then-reveal, so neither party can choose them after seeing the other's.
+ *
+ * @param[in] params Parameters of the base ots; params.net is the connection to the peer.
+ * @param[in] cache The cache.
+ * @param[in] peer_id The identity of the peer.
+ * @param[in] session_id The session id.
+ * @param[out] messages The base ot messages (m0, m1).
+ * @throws std::invalid_argument if params.net is null or params.base_ot_sizes is zero.
+ * @throws std::runtime_error if the peer opens a value other than the one it committed to.
+ */
+void cached_base_ot_send(const VerseParams& params, const BaseOtCache& cache, const std::string& peer_id,
+        std::uint64_t session_id, std::vector<std::array<block, 2>>& messages);
+
+/**
+ * @brief Run the base ot receiver through a cache.
+ *
+ * @param[in] params Parameters of the base ots; params.net is the connection to the peer.
+ * @param[in] cache The cache.
+ * @param[in] peer_id The identity of the peer.
+ * @param[in] session_id The session id.
+ * @param[out] choices The random chosen bits of the base ots.
+ * @param[out] messages The chosen messages.
+ * @throws std::invalid_argument if params.net is null or params.base_ot_sizes is zero.
+ * @throws std::runtime_error if the peer opens a value other than the one it committed to.
+ */
+void cached_base_ot_receive(const VerseParams& params, const BaseOtCache& cache, const std::string& peer_id,
+        std::uint64_t session_id, std::vector<block>& choices, std::vector<block>& messages);
+
+}  // namespace verse
+}  // namespace petace
@@ -0,0 +1,69 @@
+// Copyright 2023 TikTok Pte. Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "verse/base-ot/iknp-base-ot/iknp_base_ot.h"
+
+#include <stdexcept>
+
+#include "verse/util/common.h"
+#include "verse/verse_factory.h"
+
+namespace petace {
+namespace verse {
+
+namespace {
+
+VerseParams bootstrap_params(std::size_t base_ot_sizes) {
+    if (base_ot_sizes == 0 || base_ot_sizes % (sizeof(block) * 8) != 0) {
+        throw std::invalid_argument("OT base size is not supported.");
+    }
+    VerseParams params;
+    params.base_ot_sizes = kIknpBootstrapBaseOts;
+    params.ext_ot_sizes = base_ot_sizes;
+    return params;
+}
+
+}  // namespace
+
+void IknpBaseOtSender::send(const std::shared_ptr<network::Network>& net, std::vector<std::array<block, 2>>& messages) {
+    VerseParams params = bootstrap_params(base_ot_sizes_);
+    // The iknp sender is the receiver of the public-key base ots.
+    std::vector<block> base_choices(kIknpBootstrapBaseOts / (sizeof(block) * 8));
+    for (auto& choice : base_choices) {
+        choice = read_block_from_dev_urandom();
+    }
+    std::vector<block> base_recv_ots;
+    auto npot_receiver = VerseFactory<BaseOtReceiver>::get_instance().build(OTScheme::NaorPinkasReceiver, params);
+    npot_receiver->receive(net, base_choices, base_recv_ots);
+
+    auto iknp_sender = VerseFactory<OtExtSender>::get_instance().build(OTScheme::IknpSender, params);
+    iknp_sender->set_base_ots(base_choices, base_recv_ots);
+    iknp_sender->send(net, messages);
+}
+
+void IknpBaseOtReceiver::receive(
+        const std::shared_ptr<network::Network>& net, const std::vector<block>& choices, std::vector<block>& messages) {
+    VerseParams params = bootstrap_params(base_ot_sizes_);
+    // The iknp receiver is the sender of the public-key base ots.
+    std::vector<std::array<block, 2>> base_send_ots;
+    auto npot_sender = VerseFactory<BaseOtSender>::get_instance().build(OTScheme::NaorPinkasSender, params);
+    npot_sender->send(net, base_send_ots);
+
+    auto iknp_receiver = VerseFactory<OtExtReceiver>::get_instance().build(OTScheme::IknpReceiver, params);
+    iknp_receiver->set_base_ots(base_send_ots);
+    iknp_receiver->receive(net, choices, messages);
+}
+
+}  // namespace verse
+}  // namespace petace
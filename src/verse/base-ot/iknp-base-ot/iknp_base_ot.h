@@ -0,0 +1,102 @@
+// Copyright 2023 TikTok Pte. Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <array>
+#include <memory>
+#include <vector>
+
+#include "network/network.h"
+
+#include "verse/base-ot/base_ot_receiver.h"
+#include "verse/base-ot/base_ot_sender.h"
+#include "verse/util/defines.h"
+
+namespace petace {
+namespace verse {
+
+/**
+ * @brief The number of public-key base ots that seed an iknp-bootstrapped base ot.
+ */
+const std::size_t kIknpBootstrapBaseOts = 128;
+
+/**
+ * @brief 1-out-of-2 base ots produced by a 128-wide iknp extension [sender].
+ *
+ * Wide extensions such as kkrt need 512 or more base ots. Instead of running them all as public-key ots, the base
+ * ot sender plays the iknp sender: it first receives kIknpBootstrapBaseOts naor-pinkas ots with the roles reversed
+ * and then extends them to base_ot_sizes random ots.
+ *
+ * @see Refer to README.md for more details.
+ *
+ * @par Example.
+ * Refer to kkrt_ot_test.cpp.
+ */
+class IknpBaseOtSender : public BaseOtSender {
+public:
+    explicit IknpBaseOtSender(std::size_t base_ot_sizes) : BaseOtSender(base_ot_sizes) {
+    }
+
+    ~IknpBaseOtSender() {
+    }
+
+    /**
+     * @brief The sender gets the random messages of the bootstrapped base ots.
+     *
+     * @param[in] net The network interface (e.g., PETAce-Network interface).
+     * @param[out] messages The random output messages of the sender.
+     * @throws std::invalid_argument if base_ot_sizes is not a positive multiple of 128.
+     */
+    void send(const std::shared_ptr<network::Network>& net, std::vector<std::array<block, 2>>& messages) override;
+};
+
+/**
+ * @brief 1-out-of-2 base ots produced by a 128-wide iknp extension [receiver].
+ *
+ * @see Refer to README.md for more details.
+ *
+ * @par Example.
+ * Refer to kkrt_ot_test.cpp.
+ */
+class IknpBaseOtReceiver : public BaseOtReceiver {
+public:
+    explicit IknpBaseOtReceiver(std::size_t base_ot_sizes) : BaseOtReceiver(base_ot_sizes) {
+    }
+
+    ~IknpBaseOtReceiver() {
+    }
+
+    /**
+     * @brief The receiver gets chosen messages indexed by choices in the bootstrapped base ots.
+     *
+     * @param[in] net The network interface (e.g., PETAce-Network interface).
+     * @param[in] choices The chosen bits of receiver.
+     * @param[out] messages The chosen messages indexed by choices.
+     * @throws std::invalid_argument if base_ot_sizes is not a positive multiple of 128.
+     */
+    void receive(const std::shared_ptr<network::Network>& net, const std::vector<block>& choices,
+            std::vector<block>& messages) override;
+};
+
+inline std::unique_ptr<BaseOtReceiver> create_iknp_base_ot_receiver(const VerseParams& params) {
+    return std::make_unique<IknpBaseOtReceiver>(params.base_ot_sizes);
+}
+
+inline std::unique_ptr<BaseOtSender> create_iknp_base_ot_sender(const VerseParams& params) {
+    return std::make_unique<IknpBaseOtSender>(params.base_ot_sizes);
+}
+
+}  // namespace verse
+}  // namespace petace
@@ -15,6 +15,7 @@
 #include "verse/base-ot/naor-pinkas-ot/naor_pinkas_ot.h"
 
 #include "verse/util/common.h"
+#include "verse/util/ec_batch.h"
 #include "verse/verse_factory.h"
 
 namespace petace {
@@ -43,13 +44,9 @@ void NaorPinkasSender::send(const std::shared_ptr<network::Network>& net, std::v
     }
 
     std::vector<solo::Byte> buff(2 * base_ot_sizes_ * kEccPointLen);
-    for (std::size_t i = 0; i < base_ot_sizes_; i++) {
-        ec_->point_to_bytes(*c_pk[i], kEccPointLen, buff.data() + i * kEccPointLen);
-    }
-    for (std::size_t i = 0; i < base_ot_sizes_; i++) {
-        ec_->point_to_bytes(*gr_pk[i], kEccPointLen, buff.data() + i * kEccPointLen + base_ot_sizes_ * kEccPointLen);
-    }
-    net->send_data(buff.data(), buff.size());
+    points_to_bytes(*ec_, c_pk.data(), base_ot_sizes_, buff.data());
+    points_to_bytes(*ec_, gr_pk.data(), base_ot_sizes_, buff.data() + base_ot_sizes_ * kEccPointLen);
+    send_frame(net, buff.data(), buff.size());
 
     std::vector<std::shared_ptr<EC::Point>> pk0_pk(base_ot_sizes_);
     for (std::size_t i = 0; i < base_ot_sizes_; i++) {
@@ -59,9 +56,9 @@ void NaorPinkasSender::send(const std::shared_ptr<network::Network>& net, std::v
     for (std::size_t i = 0; i < base_ot_sizes_; i++) {
         pk0_r_pk[i] = std::make_shared<EC::Point>(*ec_);
     }
-    net->recv_data(buff.data(), base_ot_sizes_ * kEccPointLen);
+    recv_frame(net, buff.data(), base_ot_sizes_ * kEccPointLen);
+    points_from_bytes(*ec_, buff.data(), base_ot_sizes_, pk0_pk.data());
     for (std::size_t i = 0; i < base_ot_sizes_; i++) {
-        ec_->point_from_bytes(buff.data() + i * kEccPointLen, kEccPointLen, *pk0_pk[i]);
         ec_->encrypt(*pk0_pk[i], gr_sk[i], *pk0_r_pk[i]);
     }
 
@@ -82,11 +79,9 @@ void NaorPinkasSender::send(const std::shared_ptr<network::Network>& net, std::v
     }
 
     std::vector<solo::Byte> msg(2 * base_ot_sizes_ * kEccPointLen);
+    points_to_bytes(*ec_, pk0_r_pk.data(), base_ot_sizes_, msg.data());
+    points_to_bytes(*ec_, pk1_r_pk.data(), base_ot_sizes_, msg.data() + base_ot_sizes_ * kEccPointLen);
     for (std::size_t i = 0; i < base_ot_sizes_; i++) {
-        ec_->point_to_bytes(*pk0_r_pk[i], kEccPointLen, msg.data() + i * kEccPointLen);
-    }
-    for (std::size_t i = 0; i < base_ot_sizes_; i++) {
-        ec_->point_to_bytes(*pk1_r_pk[i], kEccPointLen, msg.data() + i * kEccPointLen + base_ot_sizes_ * kEccPointLen);
         msg[i * kEccPointLen + base_ot_sizes_ * kEccPointLen] = static_cast<solo::Byte>(
                 static_cast<unsigned char>(msg[i * kEccPointLen + base_ot_sizes_ * kEccPointLen]) ^ 1);
     }
@@ -117,13 +112,9 @@ void NaorPinkasReceiver::receive(
     }
 
     std::vector<solo::Byte> buff(2 * base_ot_sizes_ * kEccPointLen);
-    net->recv_data(buff.data(), buff.size());
-    for (std::size_t i = 0; i < base_ot_sizes_; i++) {
-        ec_->point_from_bytes(buff.data() + i * kEccPointLen, kEccPointLen, *c_pk[i]);
-    }
-    for (std::size_t i = 0; i < base_ot_sizes_; i++) {
-        ec_->point_from_bytes(buff.data() + i * kEccPointLen + base_ot_sizes_ * kEccPointLen, kEccPointLen, *gr_pk[i]);
-    }
+    recv_frame(net, buff.data(), buff.size());
+    points_from_bytes(*ec_, buff.data(), base_ot_sizes_, c_pk.data());
+    points_from_bytes(*ec_, buff.data() + base_ot_sizes_ * kEccPointLen, base_ot_sizes_, gr_pk.data());
 
     std::vector<EC::SecretKey> k_sigma_sk(base_ot_sizes_);
     std::vector<std::shared_ptr<EC::Point>> k_sigma_pk(base_ot_sizes_);
@@ -143,18 +134,16 @@ void NaorPinkasReceiver::receive(
         }
     }
 
-    for (std::size_t i = 0; i < base_ot_sizes_; i++) {
-        ec_->point_to_bytes(*k_sigma_pk[i], kEccPointLen, buff.data() + i * kEccPointLen);
-    }
-    net->send_data(buff.data(), base_ot_sizes_ * kEccPointLen);
+    points_to_bytes(*ec_, k_sigma_pk.data(), base_ot_sizes_, buff.data());
+    send_frame(net, buff.data(), base_ot_sizes_ * kEccPointLen);
 
     for (std::size_t i = 0; i < base_ot_sizes_; i++) {
         ec_->encrypt(*gr_pk[i], k_sigma_sk[i], *gr_pk[i]);
     }
 
     std::vector<solo::Byte> msg(base_ot_sizes_ * kEccPointLen);
+    points_to_bytes(*ec_, gr_pk.data(), base_ot_sizes_, msg.data());
     for (std::size_t i = 0; i < base_ot_sizes_; i++) {
-        ec_->point_to_bytes(*gr_pk[i], kEccPointLen, msg.data() + i * kEccPointLen);
         msg[i * kEccPointLen] =
                 static_cast<solo::Byte>(static_cast<int>(msg[i * kEccPointLen]) ^ bit_from_blocks(choices, i));
     }
@@ -0,0 +1,139 @@
+// Copyright 2023 TikTok Pte. Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "verse/base-ot/simplest-ot/simplest_ot.h"
+
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+#include "solo/hash.h"
+
+#include "verse/util/common.h"
+#include "verse/util/ec_batch.h"
+
+namespace petace {
+namespace verse {
+
+namespace {
+
+// key = SHA-256(i || A || B_i || point) truncated to one block, so a key depends on the whole transcript of its ot.
+void derive_key(solo::Hash& hash, std::uint64_t index, const solo::Byte* big_a, const solo::Byte* big_b,
+        const solo::Byte* point, block& key) {
+    solo::Byte input[sizeof(index) + 3 * kEccPointLen];
+    memcpy(input, &index, sizeof(index));
+    memcpy(input + sizeof(index), big_a, kEccPointLen);
+    memcpy(input + sizeof(index) + kEccPointLen, big_b, kEccPointLen);
+    memcpy(input + sizeof(index) + 2 * kEccPointLen, point, kEccPointLen);
+    hash.compute(input, sizeof(input), reinterpret_cast<solo::Byte*>(&key), sizeof(block));
+}
+
+// Decode n points from a peer, reporting any invalid encoding as std::runtime_error.
+void decode_points(const EC& ec, const solo::Byte* in, std::size_t n, const std::shared_ptr<EC::Point>* points,
+        const char* message) {
+    try {
+        points_from_bytes(ec, in, n, points);
+    } catch (const std::exception&) {
+        throw std::runtime_error(message);
+    }
+}
+
+}  // namespace
+
+void SimplestOtSender::send(const std::shared_ptr<network::Network>& net, std::vector<std::array<block, 2>>& messages) {
+    EC::SecretKey a;
+    ec_->create_secret_key(prng_, a);
+    auto big_a = std::make_shared<EC::Point>(*ec_);
+    ec_->create_public_key(a, *big_a);
+    solo::Byte buff_a[kEccPointLen];
+    ec_->point_to_bytes(*big_a, kEccPointLen, buff_a);
+    send_frame(net, buff_a, sizeof(buff_a));
+
+    std::vector<solo::Byte> buff_b(base_ot_sizes_ * kEccPointLen);
+    recv_frame(net, buff_b.data(), buff_b.size());
+    std::vector<std::shared_ptr<EC::Point>> big_b(base_ot_sizes_);
+    for (std::size_t i = 0; i < base_ot_sizes_; i++) {
+        big_b[i] = std::make_shared<EC::Point>(*ec_);
+    }
+    decode_points(*ec_, buff_b.data(), base_ot_sizes_, big_b.data(), "simplest ot receiver sent an invalid point.");
+
+    // -aA is added to aB_i for the second key.
+    EC::Point neg_a_big_a(*ec_);
+    ec_->encrypt(*big_a, a, neg_a_big_a);
+    ec_->invert(neg_a_big_a, neg_a_big_a);
+    std::vector<std::shared_ptr<EC::Point>> shared(2 * base_ot_sizes_);
+    for (std::size_t i = 0; i < base_ot_sizes_; i++) {
+        shared[2 * i] = std::make_shared<EC::Point>(*ec_);
+        shared[2 * i + 1] = std::make_shared<EC::Point>(*ec_);
+        ec_->encrypt(*big_b[i], a, *shared[2 * i]);
+        ec_->add(*shared[2 * i], neg_a_big_a, *shared[2 * i + 1]);
+    }
+
+    std::vector<solo::Byte> encoded(2 * base_ot_sizes_ * kEccPointLen);
+    points_to_bytes(*ec_, shared.data(), shared.size(), encoded.data());
+    auto hash = solo::Hash::create(solo::HashScheme::SHA_256);
+    messages.resize(base_ot_sizes_);
+    for (std::size_t i = 0; i < base_ot_sizes_; i++) {
+        const solo::Byte* b_i = buff_b.data() + i * kEccPointLen;
+        derive_key(*hash, i, buff_a, b_i, encoded.data() + 2 * i * kEccPointLen, messages[i][0]);
+        derive_key(*hash, i, buff_a, b_i, encoded.data() + (2 * i + 1) * kEccPointLen, messages[i][1]);
+    }
+    return;
+}
+
+void SimplestOtReceiver::receive(
+        const std::shared_ptr<network::Network>& net, const std::vector<block>& choices, std::vector<block>& messages) {
+    if (choices.size() * sizeof(block) * 8 < base_ot_sizes_) {
+        throw std::invalid_argument("choices are fewer than base ots.");
+    }
+    solo::Byte buff_a[kEccPointLen];
+    recv_frame(net, buff_a, sizeof(buff_a));
+    auto big_a = std::make_shared<EC::Point>(*ec_);
+    decode_points(*ec_, buff_a, 1, &big_a, "simplest ot sender sent an invalid point.");
+
+    // Both b_iG and b_iG + A are computed for every ot, so the work does not depend on the choice bit.
+    std::vector<EC::SecretKey> b(base_ot_sizes_);
+    std::vector<std::shared_ptr<EC::Point>> candidates(2 * base_ot_sizes_);
+    std::vector<std::shared_ptr<EC::Point>> big_b(base_ot_sizes_);
+    for (std::size_t i = 0; i < base_ot_sizes_; i++) {
+        candidates[2 * i] = std::make_shared<EC::Point>(*ec_);
+        candidates[2 * i + 1] = std::make_shared<EC::Point>(*ec_);
+        ec_->create_secret_key(prng_, b[i]);
+        ec_->create_public_key(b[i], *candidates[2 * i]);
+        ec_->add(*candidates[2 * i], *big_a, *candidates[2 * i + 1]);
+        big_b[i] = candidates[2 * i + bit_from_blocks(choices, i)];
+    }
+    std::vector<solo::Byte> buff_b(base_ot_sizes_ * kEccPointLen);
+    points_to_bytes(*ec_, big_b.data(), base_ot_sizes_, buff_b.data());
+    send_frame(net, buff_b.data(), buff_b.size());
+
+    std::vector<std::shared_ptr<EC::Point>> shared(base_ot_sizes_);
+    for (std::size_t i = 0; i < base_ot_sizes_; i++) {
+        shared[i] = std::make_shared<EC::Point>(*ec_);
+        ec_->encrypt(*big_a, b[i], *shared[i]);
+    }
+    std::vector<solo::Byte> encoded(base_ot_sizes_ * kEccPointLen);
+    points_to_bytes(*ec_, shared.data(), shared.size(), encoded.data());
+    auto hash = solo::Hash::create(solo::HashScheme::SHA_256);
+    messages.resize(base_ot_sizes_);
+    for (std::size_t i = 0; i < base_ot_sizes_; i++) {
+        derive_key(*hash, i, buff_a, buff_b.data() + i * kEccPointLen, encoded.data() + i * kEccPointLen,
+                messages[i]);
+    }
+    return;
+}
+
+}  // namespace verse
+}  // namespace petace
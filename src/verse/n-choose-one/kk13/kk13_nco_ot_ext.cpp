@@ -0,0 +1,222 @@
+// Copyright 2023 TikTok Pte. Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "verse/n-choose-one/kk13/kk13_nco_ot_ext.h"
+
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+#include "verse/util/common.h"
+
+namespace petace {
+namespace verse {
+
+namespace {
+
+// Blocks per codeword and per row of an ot.
+const std::size_t kRowBlocks = kKk13BaseOts / (sizeof(block) * 8);
+
+// Fill codes with the Walsh-Hadamard codewords of all choices: bit j of the codeword of x is the parity of x & j.
+// The code is linear, so every codeword is the xor of the codewords of its set bits.
+void walsh_hadamard_codes(std::vector<block>& codes) {
+    codes.assign(kKk13MaxChoices * kRowBlocks, _mm_setzero_si128());
+    for (std::size_t b = 0; (std::size_t(1) << b) < kKk13MaxChoices; b++) {
+        std::uint8_t* bits = reinterpret_cast<std::uint8_t*>(&codes[(std::size_t(1) << b) * kRowBlocks]);
+        for (std::size_t j = 0; j < kKk13BaseOts; j++) {
+            bits[j / 8] |= static_cast<std::uint8_t>(((j >> b) & 1) << (j % 8));
+        }
+    }
+    for (std::size_t x = 1; x < kKk13MaxChoices; x++) {
+        std::size_t low = x & (~x + 1);
+        for (std::size_t k = 0; k < kRowBlocks; k++) {
+            codes[x * kRowBlocks + k] = codes[(x ^ low) * kRowBlocks + k] ^ codes[low * kRowBlocks + k];
+        }
+    }
+}
+
+std::size_t checked_choice(const block& choice) {
+    std::uint64_t low = static_cast<std::uint64_t>(_mm_cvtsi128_si64(choice));
+    std::uint64_t high = static_cast<std::uint64_t>(_mm_cvtsi128_si64(_mm_unpackhi_epi64(choice, choice)));
+    if (high != 0 || low >= kKk13MaxChoices) {
+        throw std::invalid_argument("kk13 choice is out of range.");
+    }
+    return static_cast<std::size_t>(low);
+}
+
+// Transpose the kKk13BaseOts streams of cols blocks into rows of kRowBlocks blocks, one per ot.
+void transpose_streams(const block* streams, std::size_t cols, block* rows, block* scratch) {
+    block* input = scratch;
+    block* output = scratch + sizeof(block) * 8;
+    for (std::size_t i = 0; i < cols; i++) {
+        for (std::size_t j = 0; j < kRowBlocks; j++) {
+            for (std::size_t k = 0; k < sizeof(block) * 8; k++) {
+                input[k] = streams[(j * sizeof(block) * 8 + k) * cols + i];
+            }
+            matrix_transpose(input, sizeof(block) * 8, sizeof(block) * 8, output);
+            for (std::size_t k = 0; k < sizeof(block) * 8; k++) {
+                rows[(i * sizeof(block) * 8 + k) * kRowBlocks + j] = output[k];
+            }
+        }
+    }
+}
+
+// The ot message H(idx, row) with row being kRowBlocks blocks.
+inline block hash_row(const block* row, std::size_t idx) {
+    block input[kRowBlocks + 1];
+    for (std::size_t k = 0; k < kRowBlocks; k++) {
+        input[k] = row[k];
+    }
+    input[kRowBlocks] = _mm_set_epi64x(0, static_cast<long long>(idx));
+    block output;
+    thread_sha256().compute(reinterpret_cast<solo::Byte*>(input), sizeof(input),
+            reinterpret_cast<solo::Byte*>(&output), sizeof(block));
+    return output;
+}
+
+void check_sizes(std::size_t base_ot_sizes) {
+    if (base_ot_sizes != kKk13BaseOts) {
+        throw std::invalid_argument("OT base size is not supported.");
+    }
+}
+
+}  // namespace
+
+void Kk13NcoOtExtSender::set_base_ots(const std::vector<block>& choices, const std::vector<block>& base_recv_ots) {
+    check_sizes(base_ot_sizes_);
+    if (base_recv_ots.size() != kKk13BaseOts || choices.size() < kRowBlocks) {
+        throw std::invalid_argument("OT base size is not supported.");
+    }
+    prg_.reset(base_recv_ots.data(), base_recv_ots.size());
+    base_choices_.assign(choices.begin(), choices.begin() + kRowBlocks);
+    walsh_hadamard_codes(masked_codes_);
+    for (std::size_t i = 0; i < masked_codes_.size(); i++) {
+        masked_codes_[i] &= choices[i % kRowBlocks];
+    }
+    return;
+}
+
+void Kk13NcoOtExtSender::send(const std::shared_ptr<network::Network>& net, const std::size_t ext_ot_sizes) {
+    check_sizes(base_ot_sizes_);
+    ext_ot_sizes_ = ext_ot_sizes;
+    if (ext_ot_sizes_ % (sizeof(block) * 8) != 0) {
+        ext_ot_sizes_ += sizeof(block) * 8 - (ext_ot_sizes_ % (sizeof(block) * 8));
+    }
+
+    std::size_t cols = ext_ot_sizes_ / (sizeof(block) * 8);
+
+    // The receiver only sends the rows of real ots; the padded rows stay zero and are never encoded.
+    block* recv_matrix = recv_matrix_.resize(ext_ot_sizes_ * kRowBlocks);
+    recv_block(net, recv_matrix, ext_ot_sizes * kRowBlocks);
+    memset(recv_matrix + ext_ot_sizes * kRowBlocks, 0, (ext_ot_sizes_ - ext_ot_sizes) * kRowBlocks * sizeof(block));
+
+    block* ext_matrix = ext_matrix_.resize(kKk13BaseOts * cols);
+    prg_.generate(cols, ext_matrix, cols);
+
+    // Row i becomes q_i ^ (s & u_i) = t0_i ^ (s & C(x_i)), so encoding y only xors the masked codeword of y.
+    block* q_mat = q_mat_.resize(ext_ot_sizes_ * kRowBlocks);
+    transpose_streams(ext_matrix, cols, q_mat, scratch_.resize(2 * sizeof(block) * 8));
+    for (std::size_t i = 0; i < ext_ot_sizes_ * kRowBlocks; i++) {
+        q_mat[i] ^= recv_matrix[i] & base_choices_[i % kRowBlocks];
+    }
+
+    return;
+}
+
+void Kk13NcoOtExtSender::encode(const std::size_t idx, const block& input, block& output) {
+    std::size_t choice = checked_choice(input);
+    const block* q = q_mat_.data() + idx * kRowBlocks;
+    const block* mask = masked_codes_.data() + choice * kRowBlocks;
+    block row[kRowBlocks];
+    for (std::size_t k = 0; k < kRowBlocks; k++) {
+        row[k] = q[k] ^ mask[k];
+    }
+    output = hash_row(row, idx);
+}
+
+void Kk13NcoOtExtSender::encode_batch(std::size_t first, std::size_t count, std::size_t n, block* outputs) {
+    if (n > kKk13MaxChoices) {
+        throw std::invalid_argument("kk13 choice is out of range.");
+    }
+    block row[kRowBlocks];
+    for (std::size_t i = 0; i < count; i++) {
+        const block* q = q_mat_.data() + (first + i) * kRowBlocks;
+        for (std::size_t v = 0; v < n; v++) {
+            const block* mask = masked_codes_.data() + v * kRowBlocks;
+            for (std::size_t k = 0; k < kRowBlocks; k++) {
+                row[k] = q[k] ^ mask[k];
+            }
+            outputs[i * n + v] = hash_row(row, first + i);
+        }
+    }
+}
+
+void Kk13NcoOtExtReceiver::set_base_ots(const std::vector<std::array<block, 2>>& base_send_ots) {
+    check_sizes(base_ot_sizes_);
+    if (base_send_ots.size() != kKk13BaseOts) {
+        throw std::invalid_argument("OT base size is not supported.");
+    }
+    std::vector<block> keys(2 * base_send_ots.size());
+    for (std::size_t i = 0; i < base_send_ots.size(); i++) {
+        keys[i] = base_send_ots[i][0];
+        keys[base_send_ots.size() + i] = base_send_ots[i][1];
+    }
+    prg_.reset(keys.data(), keys.size());
+    walsh_hadamard_codes(codes_);
+    return;
+}
+
+void Kk13NcoOtExtReceiver::receive(
+        const std::shared_ptr<network::Network>& net, const std::vector<block>& choices, std::vector<block>& messages) {
+    check_sizes(base_ot_sizes_);
+    ext_ot_sizes_ = choices.size();
+    if (ext_ot_sizes_ % (sizeof(block) * 8) != 0) {
+        ext_ot_sizes_ += sizeof(block) * 8 - (ext_ot_sizes_ % (sizeof(block) * 8));
+    }
+
+    std::size_t cols = ext_ot_sizes_ / (sizeof(block) * 8);
+
+    // t0 holds the streams of all m0 and is followed by t1 with the streams of all m1.
+    block* t0 = t_.resize(2 * kKk13BaseOts * cols);
+    block* t1 = t0 + kKk13BaseOts * cols;
+    prg_.generate(cols, t0, cols);
+
+    block* scratch = scratch_.resize(2 * sizeof(block) * 8);
+    block* row_mat0 = row_mat0_.resize(ext_ot_sizes_ * kRowBlocks);
+    block* row_mat1 = row_mat1_.resize(ext_ot_sizes_ * kRowBlocks);
+    transpose_streams(t0, cols, row_mat0, scratch);
+    transpose_streams(t1, cols, row_mat1, scratch);
+
+    // Rows padding the ots to a multiple of 128 are never encoded by the sender, so they are not sent.
+    block* row_mat = row_mat_.resize(choices.size() * kRowBlocks);
+    for (std::size_t i = 0; i < choices.size(); i++) {
+        const block* code = codes_.data() + checked_choice(choices[i]) * kRowBlocks;
+        for (std::size_t k = 0; k < kRowBlocks; k++) {
+            std::size_t pos = i * kRowBlocks + k;
+            row_mat[pos] = row_mat0[pos] ^ row_mat1[pos] ^ code[k];
+        }
+    }
+
+    send_block(net, row_mat, choices.size() * kRowBlocks);
+
+    messages.resize(choices.size());
+    for (std::size_t i = 0; i < choices.size(); i++) {
+        messages[i] = hash_row(row_mat0 + i * kRowBlocks, i);
+    }
+
+    return;
+}
+
+}  // namespace verse
+}  // namespace petace
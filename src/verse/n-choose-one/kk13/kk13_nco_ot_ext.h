@@ -0,0 +1,217 @@
+// Copyright 2023 TikTok Pte. Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <array>
+#include <memory>
+#include <vector>
+
+#include "network/network.h"
+
+#include "verse/n-choose-one/nco_ot_ext_receiver.h"
+#include "verse/n-choose-one/nco_ot_ext_sender.h"
+#include "verse/util/aes.h"
+#include "verse/util/buffer.h"
+#include "verse/util/defines.h"
+
+namespace petace {
+namespace verse {
+
+// KK13 encodes choices with the 256-bit Walsh-Hadamard code, whose codewords are 128 bits apart.
+const std::size_t kKk13BaseOts = 256;
+
+// Choices, and the inputs of the sender, must lie in [0, kKk13MaxChoices).
+const std::size_t kKk13MaxChoices = 256;
+
+/**
+ * @brief 1-out-of-n kk13 ot extension for n up to 256 [sender].
+ *
+ * Unlike kkrt, the code is linear: the sender's mask of every input is precomputed once per set of base ots, so
+ * encoding an input is one table lookup, a mask-and-xor and a single hash.
+ *
+ * @see Refer to README.md for more details.
+ */
+class Kk13NcoOtExtSender : public NcoOtExtSender {
+public:
+    /**
+     * @brief Create a kk13 sender.
+     *
+     * @param[in] base_ot_sizes The number of base ots; must be 256.
+     * @param[in] allocator The memory of the work buffers, which are kept across calls; null uses the default.
+     */
+    explicit Kk13NcoOtExtSender(
+            const std::size_t base_ot_sizes, const std::shared_ptr<BufferAllocator>& allocator = nullptr)
+            : NcoOtExtSender(base_ot_sizes),
+              recv_matrix_(allocator),
+              ext_matrix_(allocator),
+              scratch_(allocator),
+              q_mat_(allocator) {
+    }
+
+    ~Kk13NcoOtExtSender() {
+    }
+
+    /**
+     * @brief Return kKk13MaxChoices.
+     */
+    std::size_t max_inputs() const override {
+        return kKk13MaxChoices;
+    }
+
+    /**
+     * @brief The sender sets the base ots that are used to extend.
+     *
+     * @param[in] choices The chosen bits in the base ot.
+     * @param[in] base_recv_ots Base OTs that are used for kk13 ot extension.
+     * @throws std::invalid_argument if there are not 256 base ots.
+     */
+    void set_base_ots(const std::vector<block>& choices, const std::vector<block>& base_recv_ots) override;
+
+    /**
+     * @brief The sender gets the random keys in the kk13 ot extension protocol.
+     *
+     * @param[in] net The network interface (e.g., PETAce-Network interface).
+     * @param[in] ext_ot_sizes The size of kk13 1-out-of-n ot.
+     * @throws std::invalid_argument.
+     */
+    void send(const std::shared_ptr<network::Network>& net, const std::size_t ext_ot_sizes) override;
+
+    /**
+     * @brief For the OT at index idx, the sender compute the OT with choice value input.
+     *
+     * @param[in] idx The OT index that should be encoded.
+     * @param[in] input The choice value that should be encoded, below 256.
+     * @param[out] output The OT message encoding the input.
+     * @throws std::invalid_argument if input is not below 256.
+     */
+    void encode(const std::size_t idx, const block& input, block& output) override;
+
+    using NcoOtExtSender::encode;
+
+    /**
+     * @brief For the OTs first to first + count - 1, the sender computes the encodings of all inputs 0 to n - 1.
+     *
+     * @param[in] first The first OT index.
+     * @param[in] count The number of OT indices.
+     * @param[in] n The number of inputs per OT, at most 256.
+     * @param[out] outputs The encoding of input v of OT first + i is written to outputs[i * n + v].
+     * @throws std::invalid_argument if n is above 256.
+     */
+    void encode_batch(std::size_t first, std::size_t count, std::size_t n, block* outputs) override;
+
+private:
+    std::vector<block> base_choices_{};
+
+    // One AES-CTR stream per base ot, keyed by the received base ot message.
+    MultiKeyPrg prg_{};
+
+    // Entry 2 * x and 2 * x + 1 hold the codeword of x masked by the base choices.
+    std::vector<block> masked_codes_{};
+
+    Buffer<block> recv_matrix_;
+
+    Buffer<block> ext_matrix_;
+
+    // Transpose input and output.
+    Buffer<block> scratch_;
+
+    // Row idx holds the two blocks of ot idx.
+    Buffer<block> q_mat_;
+};
+
+/**
+ * @brief 1-out-of-n kk13 ot extension for n up to 256 [receiver].
+ *
+ * @see Refer to README.md for more details.
+ */
+class Kk13NcoOtExtReceiver : public NcoOtExtReceiver {
+public:
+    /**
+     * @brief Create a kk13 receiver.
+     *
+     * @param[in] base_ot_sizes The number of base ots; must be 256.
+     * @param[in] allocator The memory of the work buffers, which are kept across calls; null uses the default.
+     */
+    explicit Kk13NcoOtExtReceiver(
+            const std::size_t base_ot_sizes, const std::shared_ptr<BufferAllocator>& allocator = nullptr)
+            : NcoOtExtReceiver(base_ot_sizes),
+              t_(allocator),
+              scratch_(allocator),
+              row_mat0_(allocator),
+              row_mat1_(allocator),
+              row_mat_(allocator) {
+    }
+
+    ~Kk13NcoOtExtReceiver() {
+    }
+
+    /**
+     * @brief Return kKk13MaxChoices.
+     */
+    std::size_t max_inputs() const override {
+        return kKk13MaxChoices;
+    }
+
+    /**
+     * @brief The receiver sets the base ots that are used to extend.
+     *
+     * @param[in] base_send_ots Base OTs that are used for kk13 ot extension.
+     * @throws std::invalid_argument if there are not 256 base ots.
+     */
+    void set_base_ots(const std::vector<std::array<block, 2>>& base_send_ots) override;
+
+    /**
+     * @brief The receiver gets chosen messages indexed by choices in the kk13 ot extension protocol.
+     *
+     * @param[in] net The network interface (e.g., PETAce-Network interface).
+     * @param[in] choices The receiver's chosen numbers, each below 256.
+     * @param[out] messages The chosen messages indexed by choices.
+     * @throws std::invalid_argument.
+     */
+    void receive(const std::shared_ptr<network::Network>& net, const std::vector<block>& choices,
+            std::vector<block>& messages) override;
+
+    using NcoOtExtReceiver::receive;
+
+private:
+    // Streams keyed by all m0 of the base ots followed by all m1.
+    MultiKeyPrg prg_{};
+
+    // Entry 2 * x and 2 * x + 1 hold the codeword of x.
+    std::vector<block> codes_{};
+
+    Buffer<block> t_;
+
+    // Transpose input and output.
+    Buffer<block> scratch_;
+
+    Buffer<block> row_mat0_;
+
+    Buffer<block> row_mat1_;
+
+    // The matrix sent to the sender.
+    Buffer<block> row_mat_;
+};
+
+inline std::unique_ptr<NcoOtExtSender> create_kk13_ext_sender(const VerseParams& params) {
+    return std::make_unique<Kk13NcoOtExtSender>(params.base_ot_sizes, buffer_allocator(params));
+}
+
+inline std::unique_ptr<NcoOtExtReceiver> create_kk13_ext_receiver(const VerseParams& params) {
+    return std::make_unique<Kk13NcoOtExtReceiver>(params.base_ot_sizes, buffer_allocator(params));
+}
+
+}  // namespace verse
+}  // namespace petace
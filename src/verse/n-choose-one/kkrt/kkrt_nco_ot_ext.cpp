@@ -14,7 +14,9 @@
 
 #include "verse/n-choose-one/kkrt/kkrt_nco_ot_ext.h"
 
+#include <algorithm>
 #include <cstring>
+#include <stdexcept>
 
 #include "verse/util/common.h"
 
@@ -22,13 +24,13 @@ namespace petace {
 namespace verse {
 
 void KkrtNcoOtExtSender::set_base_ots(const std::vector<block>& choices, const std::vector<block>& base_recv_ots) {
-    solo::PRNGFactory prng_factory(solo::PRNGScheme::AES_ECB_CTR);
-    for (std::size_t i = 0; i < base_recv_ots.size(); i++) {
-        std::vector<solo::Byte> seed(sizeof(block));
-        memcpy(seed.data(), reinterpret_cast<solo::Byte*>(const_cast<block*>(base_recv_ots.data() + i)), sizeof(block));
-        prng_.emplace_back(prng_factory.create(seed));
+    prg_.reset(base_recv_ots.data(), base_recv_ots.size());
+    base_choices_.assign(choices.begin(), choices.end());
+    {
+        std::lock_guard<std::mutex> lock(value_codes_mutex_);
+        value_codes_ = nullptr;
     }
-    base_choices_.insert(base_choices_.begin(), choices.begin(), choices.end());
+    base_epoch_++;
     return;
 }
 
@@ -46,34 +48,30 @@ void KkrtNcoOtExtSender::send(const std::shared_ptr<network::Network>& net, cons
 
     std::size_t rows = base_ot_sizes_;
     std::size_t cols = ext_ot_sizes_ / (sizeof(block) * 8);
+    std::size_t threshhold = rows / (sizeof(block) * 8);
 
-    std::vector<block> recv_matrix(rows * cols);
-    recv_block(net, recv_matrix.data(), rows * cols);
+    // The receiver only sends the rows of real ots; the padded rows stay zero and are never encoded.
+    block* recv_matrix = recv_matrix_.resize(rows * cols);
+    recv_block(net, recv_matrix, ext_ot_sizes * threshhold);
+    memset(recv_matrix + ext_ot_sizes * threshhold, 0, (rows * cols - ext_ot_sizes * threshhold) * sizeof(block));
 
-    std::vector<std::vector<block>> ext_matrix(rows, std::vector<block>(cols));
-    for (std::size_t i = 0; i < rows; i++) {
-        prng_[i]->generate(cols * sizeof(block), reinterpret_cast<solo::Byte*>(&(ext_matrix[i][0])));
-    }
+    block* ext_matrix = ext_matrix_.resize(rows * cols);
+    prg_.generate(cols, ext_matrix, cols);
 
-    std::vector<block> input(sizeof(block) * 8);
-    std::vector<block> output(sizeof(block) * 8);
-    std::size_t threshhold = rows / (sizeof(block) * 8);
+    block* input = scratch_.resize(2 * sizeof(block) * 8);
+    block* output = input + sizeof(block) * 8;
 
-    q_mat.resize(ext_ot_sizes_);
-    for (std::size_t i = 0; i < ext_ot_sizes_; i++) {
-        q_mat[i].resize(threshhold);
-    }
+    block* q_mat = q_mat_.resize(ext_ot_sizes_ * threshhold);
     for (std::size_t i = 0; i < cols; i++) {
         for (std::size_t j = 0; j < threshhold; j++) {
             for (std::size_t k = 0; k < sizeof(block) * 8; k++) {
-                input[k] = ext_matrix[j * sizeof(block) * 8 + k][i];
+                input[k] = ext_matrix[(j * sizeof(block) * 8 + k) * cols + i];
             }
             matrix_transpose(input, sizeof(block) * 8, sizeof(block) * 8, output);
 
             for (std::size_t k = 0; k < sizeof(block) * 8; k++) {
-                q_mat[i * sizeof(block) * 8 + k][j] = output[k];
-                q_mat[i * sizeof(block) * 8 + k][j] ^=
-                        (recv_matrix[(i * sizeof(block) * 8 + k) * threshhold + j] & base_choices_[j]);
+                q_mat[(i * sizeof(block) * 8 + k) * threshhold + j] =
+                        output[k] ^ (recv_matrix[(i * sizeof(block) * 8 + k) * threshhold + j] & base_choices_[j]);
             }
         }
     }
@@ -83,35 +81,103 @@ void KkrtNcoOtExtSender::send(const std::shared_ptr<network::Network>& net, cons
 
 void KkrtNcoOtExtSender::encode(const std::size_t idx, const block& input, block& output) {
     std::size_t threshhold = base_ot_sizes_ / (sizeof(block) * 8);
-    std::vector<block> enc_input(threshhold);
-    auto hash = solo::Hash::create(solo::HashScheme::SHA_256);
+    solo::Hash& hash = thread_sha256();
+    const block* q = q_mat_.data() + idx * threshhold;
 
+    block enc_output = _mm_set_epi64x(0, 0);
     for (std::size_t j = 0; j < threshhold; j++) {
+        block enc_input;
         auto hash_in = input ^ _mm_set_epi64x(0, j);
-        hash->compute(reinterpret_cast<solo::Byte*>(&hash_in), sizeof(block),
-                reinterpret_cast<solo::Byte*>(&enc_input[j]), sizeof(block));
-        enc_input[j] = base_choices_[j] & (enc_input[j] ^ input);
+        hash.compute(reinterpret_cast<solo::Byte*>(&hash_in), sizeof(block), reinterpret_cast<solo::Byte*>(&enc_input),
+                sizeof(block));
+        enc_input = base_choices_[j] & (enc_input ^ input);
+
+        enc_output ^= enc_input ^ q[j] ^ _mm_set_epi64x(0, idx);
+        hash.compute(reinterpret_cast<solo::Byte*>(&enc_output), sizeof(block),
+                reinterpret_cast<solo::Byte*>(&enc_output), sizeof(block));
     }
+    output = enc_output;
+}
 
+void KkrtNcoOtExtSender::code_input(const block& input, block* code) const {
+    std::size_t threshhold = base_ot_sizes_ / (sizeof(block) * 8);
+    solo::Hash& hash = thread_sha256();
+    for (std::size_t j = 0; j < threshhold; j++) {
+        block enc_input;
+        auto hash_in = input ^ _mm_set_epi64x(0, j);
+        hash.compute(reinterpret_cast<solo::Byte*>(&hash_in), sizeof(block), reinterpret_cast<solo::Byte*>(&enc_input),
+                sizeof(block));
+        code[j] = base_choices_[j] & (enc_input ^ input);
+    }
+}
+
+block KkrtNcoOtExtSender::hash_code(std::size_t idx, const block* code) const {
+    std::size_t threshhold = base_ot_sizes_ / (sizeof(block) * 8);
+    solo::Hash& hash = thread_sha256();
+    const block* q = q_mat_.data() + idx * threshhold;
+    block tweak = _mm_set_epi64x(0, static_cast<long long>(idx));
     block enc_output = _mm_set_epi64x(0, 0);
     for (std::size_t j = 0; j < threshhold; j++) {
-        enc_output ^= enc_input[j] ^ q_mat[idx][j] ^ _mm_set_epi64x(0, idx);
-        hash->compute(reinterpret_cast<solo::Byte*>(&enc_output), sizeof(block),
+        enc_output ^= code[j] ^ q[j] ^ tweak;
+        hash.compute(reinterpret_cast<solo::Byte*>(&enc_output), sizeof(block),
                 reinterpret_cast<solo::Byte*>(&enc_output), sizeof(block));
     }
-    output = enc_output;
+    return enc_output;
+}
+
+std::shared_ptr<const std::vector<block>> KkrtNcoOtExtSender::code_values(std::size_t n) {
+    std::size_t threshhold = base_ot_sizes_ / (sizeof(block) * 8);
+    std::lock_guard<std::mutex> lock(value_codes_mutex_);
+    std::size_t coded = value_codes_ == nullptr ? 0 : value_codes_->size() / threshhold;
+    if (coded >= n) {
+        return value_codes_;
+    }
+    auto codes = std::make_shared<std::vector<block>>(n * threshhold);
+    if (coded != 0) {
+        std::copy(value_codes_->begin(), value_codes_->end(), codes->begin());
+    }
+    for (std::size_t v = coded; v < n; v++) {
+        code_input(_mm_set_epi64x(0, static_cast<long long>(v)), codes->data() + v * threshhold);
+    }
+    value_codes_ = codes;
+    return value_codes_;
+}
+
+void KkrtNcoOtExtSender::encode_batch(std::size_t first, std::size_t count, std::size_t n, block* outputs) {
+    std::size_t threshhold = base_ot_sizes_ / (sizeof(block) * 8);
+    auto codes = code_values(n);
+    for (std::size_t i = 0; i < count; i++) {
+        for (std::size_t v = 0; v < n; v++) {
+            outputs[i * n + v] = hash_code(first + i, codes->data() + v * threshhold);
+        }
+    }
+}
+
+KkrtCodeword KkrtNcoOtExtSender::precompute(const block& input) const {
+    if (base_choices_.empty()) {
+        throw std::logic_error("base ots are not set.");
+    }
+    KkrtCodeword codeword;
+    codeword.code.resize(base_ot_sizes_ / (sizeof(block) * 8));
+    codeword.base_epoch = base_epoch_;
+    code_input(input, codeword.code.data());
+    return codeword;
+}
+
+void KkrtNcoOtExtSender::encode(const std::size_t idx, const KkrtCodeword& codeword, block& output) const {
+    if (codeword.base_epoch != base_epoch_ || codeword.code.size() != base_ot_sizes_ / (sizeof(block) * 8)) {
+        throw std::invalid_argument("code word does not belong to the current base ots.");
+    }
+    output = hash_code(idx, codeword.code.data());
 }
 
 void KkrtNcoOtExtReceiver::set_base_ots(const std::vector<std::array<block, 2>>& base_send_ots) {
-    solo::PRNGFactory prng_factory(solo::PRNGScheme::AES_ECB_CTR);
+    std::vector<block> keys(2 * base_send_ots.size());
     for (std::size_t i = 0; i < base_send_ots.size(); i++) {
-        std::vector<solo::Byte> seed0(sizeof(block));
-        std::vector<solo::Byte> seed1(sizeof(block));
-        memcpy(seed0.data(), reinterpret_cast<solo::Byte*>(const_cast<block*>(&base_send_ots[i][0])), sizeof(block));
-        memcpy(seed1.data(), reinterpret_cast<solo::Byte*>(const_cast<block*>(&base_send_ots[i][1])), sizeof(block));
-        std::array<std::shared_ptr<solo::PRNG>, 2> values{prng_factory.create(seed0), prng_factory.create(seed1)};
-        prng_.emplace_back(values);
+        keys[i] = base_send_ots[i][0];
+        keys[base_send_ots.size() + i] = base_send_ots[i][1];
     }
+    prg_.reset(keys.data(), keys.size());
     return;
 }
 
@@ -131,72 +197,65 @@ void KkrtNcoOtExtReceiver::receive(
     std::size_t rows = base_ot_sizes_;
     std::size_t cols = ext_ot_sizes_ / (sizeof(block) * 8);
 
-    std::vector<std::vector<block>> t0(rows, std::vector<block>(cols));
-    std::vector<std::vector<block>> t1(rows, std::vector<block>(cols));
-
-    for (std::size_t i = 0; i < rows; i++) {
-        prng_[i][0]->generate(cols * sizeof(block), reinterpret_cast<solo::Byte*>(&(t0[i][0])));
-        prng_[i][1]->generate(cols * sizeof(block), reinterpret_cast<solo::Byte*>(&(t1[i][0])));
-    }
+    // t0 holds the streams of all m0 and is followed by t1 with the streams of all m1.
+    block* t0 = t_.resize(2 * rows * cols);
+    block* t1 = t0 + rows * cols;
+    prg_.generate(cols, t0, cols);
 
     std::size_t threshhold = rows / (sizeof(block) * 8);
-    std::vector<block> input(sizeof(block) * 8);
-    std::vector<block> output(sizeof(block) * 8);
+    block* input = scratch_.resize(2 * sizeof(block) * 8);
+    block* output = input + sizeof(block) * 8;
 
-    std::vector<std::vector<block>> row_mat0(ext_ot_sizes_, std::vector<block>(threshhold));
+    // Row i of row_mat0 and row_mat1 holds the threshhold blocks of ot i.
+    block* row_mat0 = row_mat0_.resize(ext_ot_sizes_ * threshhold);
+    block* row_mat1 = row_mat1_.resize(ext_ot_sizes_ * threshhold);
     for (std::size_t i = 0; i < cols; i++) {
         for (std::size_t j = 0; j < threshhold; j++) {
             for (std::size_t k = 0; k < sizeof(block) * 8; k++) {
-                input[k] = t0[j * sizeof(block) * 8 + k][i];
+                input[k] = t0[(j * sizeof(block) * 8 + k) * cols + i];
             }
             matrix_transpose(input, sizeof(block) * 8, sizeof(block) * 8, output);
 
             for (std::size_t k = 0; k < sizeof(block) * 8; k++) {
-                row_mat0[i * sizeof(block) * 8 + k][j] = output[k];
+                row_mat0[(i * sizeof(block) * 8 + k) * threshhold + j] = output[k];
             }
         }
     }
 
-    std::vector<std::vector<block>> row_mat1(ext_ot_sizes_, std::vector<block>(threshhold));
     for (std::size_t i = 0; i < cols; i++) {
         for (std::size_t j = 0; j < threshhold; j++) {
             for (std::size_t k = 0; k < sizeof(block) * 8; k++) {
-                input[k] = t1[j * sizeof(block) * 8 + k][i];
+                input[k] = t1[(j * sizeof(block) * 8 + k) * cols + i];
             }
             matrix_transpose(input, sizeof(block) * 8, sizeof(block) * 8, output);
 
             for (std::size_t k = 0; k < sizeof(block) * 8; k++) {
-                row_mat1[i * sizeof(block) * 8 + k][j] = output[k];
+                row_mat1[(i * sizeof(block) * 8 + k) * threshhold + j] = output[k];
             }
         }
     }
 
-    auto hash = solo::Hash::create(solo::HashScheme::SHA_256);
-    std::vector<block> row_mat(ext_ot_sizes_ * threshhold);
-    for (std::size_t i = 0; i < ext_ot_sizes_; i++) {
+    solo::Hash& hash = thread_sha256();
+    // Rows padding the ots to a multiple of 128 are never encoded by the sender, so they are not sent.
+    block* row_mat = row_mat_.resize(choices.size() * threshhold);
+    for (std::size_t i = 0; i < choices.size(); i++) {
         for (std::size_t j = 0; j < threshhold; j++) {
-            if (i < choices.size()) {
-                auto hash_in = choices[i] ^ _mm_set_epi64x(0, j);
-                hash->compute(reinterpret_cast<solo::Byte*>(&hash_in), sizeof(block),
-                        reinterpret_cast<solo::Byte*>(&row_mat[i * threshhold + j]), sizeof(block));
-                row_mat[i * threshhold + j] ^= row_mat0[i][j] ^ row_mat1[i][j] ^ choices[i];
-            } else {
-                auto hash_in = _mm_set_epi64x(0, j);
-                hash->compute(reinterpret_cast<solo::Byte*>(&hash_in), sizeof(block),
-                        reinterpret_cast<solo::Byte*>(&row_mat[i * threshhold + j]), sizeof(block));
-                row_mat[i * threshhold + j] ^= row_mat0[i][j] ^ row_mat1[i][j];
-            }
+            std::size_t pos = i * threshhold + j;
+            auto hash_in = choices[i] ^ _mm_set_epi64x(0, j);
+            hash.compute(reinterpret_cast<solo::Byte*>(&hash_in), sizeof(block),
+                    reinterpret_cast<solo::Byte*>(&row_mat[pos]), sizeof(block));
+            row_mat[pos] ^= row_mat0[pos] ^ row_mat1[pos] ^ choices[i];
         }
     }
 
-    send_block(net, row_mat.data(), ext_ot_sizes_ * threshhold);
+    send_block(net, row_mat, choices.size() * threshhold);
 
     messages.resize(choices.size());
     for (std::size_t i = 0; i < choices.size(); i++) {
         block hash_in = _mm_set_epi64x(0, 0);
         for (std::size_t j = 0; j < threshhold; j++) {
-            hash_in ^= row_mat0[i][j] ^ _mm_set_epi64x(0, i);
-            hash->compute(reinterpret_cast<solo::Byte*>(&hash_in), sizeof(block),
+            hash_in ^= row_mat0[i * threshhold + j] ^ _mm_set_epi64x(0, i);
+            hash.compute(reinterpret_cast<solo::Byte*>(&hash_in), sizeof(block),
                     reinterpret_cast<solo::Byte*>(&hash_in), sizeof(block));
         }
         messages[i] = hash_in;
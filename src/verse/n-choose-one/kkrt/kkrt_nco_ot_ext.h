@@ -14,7 +14,9 @@
 
 #pragma once
 
+#include <cstdint>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -22,11 +24,27 @@
 
 #include "verse/n-choose-one/nco_ot_ext_receiver.h"
 #include "verse/n-choose-one/nco_ot_ext_sender.h"
+#include "verse/util/aes.h"
+#include "verse/util/buffer.h"
 #include "verse/util/defines.h"
 
 namespace petace {
 namespace verse {
 
+/**
+ * @brief The code word of one input under the base ots of a kkrt sender, made by KkrtNcoOtExtSender::precompute.
+ *
+ * A code word does not depend on the OT index, so one precompute serves every index the input is encoded at. It is
+ * bound to the base ots it was made under.
+ */
+struct KkrtCodeword {
+    // The base_ot_sizes / 128 blocks of the code of the input masked by the base choices.
+    std::vector<block> code{};
+
+    // The set of base ots, counted by set_base_ots calls, the code belongs to.
+    std::uint64_t base_epoch = 0;
+};
+
 /**
  * @brief 1-out-of-n kkrt ot extension [sender].
  *
@@ -37,7 +55,19 @@ namespace verse {
  */
 class KkrtNcoOtExtSender : public NcoOtExtSender {
 public:
-    explicit KkrtNcoOtExtSender(const std::size_t base_ot_sizes) : NcoOtExtSender(base_ot_sizes) {
+    /**
+     * @brief Create a kkrt sender.
+     *
+     * @param[in] base_ot_sizes The number of base ots; a multiple of 128.
+     * @param[in] allocator The memory of the work buffers, which are kept across calls; null uses the default.
+     */
+    explicit KkrtNcoOtExtSender(
+            const std::size_t base_ot_sizes, const std::shared_ptr<BufferAllocator>& allocator = nullptr)
+            : NcoOtExtSender(base_ot_sizes),
+              recv_matrix_(allocator),
+              ext_matrix_(allocator),
+              scratch_(allocator),
+              q_mat_(allocator) {
     }
 
     ~KkrtNcoOtExtSender() {
@@ -69,12 +99,75 @@ class KkrtNcoOtExtSender : public NcoOtExtSender {
      */
     void encode(const std::size_t idx, const block& input, block& output) override;
 
+    using NcoOtExtSender::encode;
+
+    /**
+     * @brief For the OTs first to first + count - 1, the sender computes the encodings of all inputs 0 to n - 1.
+     *
+     * The pseudorandom codes of the inputs do not depend on the OT index, so they are computed once per set of base
+     * ots and only the chained hash of each (index, input) remains.
+     *
+     * @param[in] first The first OT index.
+     * @param[in] count The number of OT indices.
+     * @param[in] n The number of inputs per OT.
+     * @param[out] outputs The encoding of input v of OT first + i is written to outputs[i * n + v].
+     */
+    void encode_batch(std::size_t first, std::size_t count, std::size_t n, block* outputs) override;
+
+    /**
+     * @brief Compute the code word of an input once, so that it can be encoded at many OT indices.
+     *
+     * @param[in] input The choice value.
+     * @return The code word; valid until the next set_base_ots.
+     * @throws std::logic_error if set_base_ots has not been called.
+     */
+    KkrtCodeword precompute(const block& input) const;
+
+    /**
+     * @brief For the OT at index idx, compute the same output as encode(idx, input) from the code word of input.
+     *
+     * Only the chained hash of the code word with row idx remains per call.
+     *
+     * @param[in] idx The OT index that should be encoded.
+     * @param[in] codeword The code word returned by precompute.
+     * @param[out] output The OT message encoding the input.
+     * @throws std::invalid_argument if the code word was made under other base ots.
+     */
+    void encode(const std::size_t idx, const KkrtCodeword& codeword, block& output) const;
+
 private:
+    // Write the base_ot_sizes / 128 blocks of the masked code of input to code.
+    void code_input(const block& input, block* code) const;
+
+    // Return the chained hash of the masked code with row idx of q_mat_.
+    block hash_code(std::size_t idx, const block* code) const;
+
+    // Return codes of at least the inputs 0 to n - 1. A shorter table is replaced rather than grown in place, so
+    // concurrent encode_batch calls keep reading the table they started with.
+    std::shared_ptr<const std::vector<block>> code_values(std::size_t n);
+
+    // Incremented by set_base_ots so that code words of earlier base ots are rejected.
+    std::uint64_t base_epoch_ = 0;
+
     std::vector<block> base_choices_{};
 
-    std::vector<std::shared_ptr<solo::PRNG>> prng_{};
+    // Row v holds the base_ot_sizes / 128 blocks of the code of input v masked by the base choices.
+    std::shared_ptr<const std::vector<block>> value_codes_ = nullptr;
+
+    std::mutex value_codes_mutex_{};
+
+    // One AES-CTR stream per base ot, keyed by the received base ot message.
+    MultiKeyPrg prg_{};
+
+    Buffer<block> recv_matrix_;
+
+    Buffer<block> ext_matrix_;
 
-    std::vector<std::vector<block>> q_mat{};
+    // Transpose input and output.
+    Buffer<block> scratch_;
+
+    // Row idx holds the base_ot_sizes / 128 blocks of ot idx.
+    Buffer<block> q_mat_;
 };
 
 /**
@@ -87,7 +180,20 @@ class KkrtNcoOtExtSender : public NcoOtExtSender {
  */
 class KkrtNcoOtExtReceiver : public NcoOtExtReceiver {
 public:
-    explicit KkrtNcoOtExtReceiver(const std::size_t base_ot_sizes) : NcoOtExtReceiver(base_ot_sizes) {
+    /**
+     * @brief Create a kkrt receiver.
+     *
+     * @param[in] base_ot_sizes The number of base ots; a multiple of 128.
+     * @param[in] allocator The memory of the work buffers, which are kept across calls; null uses the default.
+     */
+    explicit KkrtNcoOtExtReceiver(
+            const std::size_t base_ot_sizes, const std::shared_ptr<BufferAllocator>& allocator = nullptr)
+            : NcoOtExtReceiver(base_ot_sizes),
+              t_(allocator),
+              scratch_(allocator),
+              row_mat0_(allocator),
+              row_mat1_(allocator),
+              row_mat_(allocator) {
     }
 
     ~KkrtNcoOtExtReceiver() {
@@ -111,18 +217,33 @@ class KkrtNcoOtExtReceiver : public NcoOtExtReceiver {
     void receive(const std::shared_ptr<network::Network>& net, const std::vector<block>& choices,
             std::vector<block>& messages);
 
+    using NcoOtExtReceiver::receive;
+
 private:
     std::vector<block> base_choices{};
 
-    std::vector<std::array<std::shared_ptr<solo::PRNG>, 2>> prng_{};
+    // Streams keyed by all m0 of the base ots followed by all m1.
+    MultiKeyPrg prg_{};
+
+    Buffer<block> t_;
+
+    // Transpose input and output.
+    Buffer<block> scratch_;
+
+    Buffer<block> row_mat0_;
+
+    Buffer<block> row_mat1_;
+
+    // The matrix sent to the sender.
+    Buffer<block> row_mat_;
 };
 
 inline std::unique_ptr<NcoOtExtSender> create_kkrt_ext_sender(const VerseParams& params) {
-    return std::make_unique<KkrtNcoOtExtSender>(params.base_ot_sizes);
+    return std::make_unique<KkrtNcoOtExtSender>(params.base_ot_sizes, buffer_allocator(params));
 }
 
 inline std::unique_ptr<NcoOtExtReceiver> create_kkrt_ext_receiver(const VerseParams& params) {
-    return std::make_unique<KkrtNcoOtExtReceiver>(params.base_ot_sizes);
+    return std::make_unique<KkrtNcoOtExtReceiver>(params.base_ot_sizes, buffer_allocator(params));
 }
 
 }  // namespace verse
@@ -0,0 +1,70 @@
+// Copyright 2023 TikTok Pte. Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "verse/n-choose-one/nco_ot_ext_receiver.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+
+#include "verse/util/aes.h"
+#include "verse/util/common.h"
+
+namespace petace {
+namespace verse {
+
+void NcoOtExtReceiver::receive(const std::shared_ptr<network::Network>& net, const std::vector<block>& choices,
+        std::vector<solo::Byte>& messages, std::size_t msg_len) {
+    std::vector<block> seeds;
+    receive(net, choices, seeds);
+    messages.resize(seeds.size() * msg_len);
+    prg_stretch(seeds.data(), seeds.size(), msg_len, messages.data());
+}
+
+void NcoOtExtReceiver::receive_chosen(const std::shared_ptr<network::Network>& net, const std::vector<block>& choices,
+        std::size_t n, std::vector<block>& messages) {
+    if (n == 0) {
+        throw std::invalid_argument("chosen messages do not match the number of inputs.");
+    }
+    if (choices.empty()) {
+        throw std::invalid_argument("choices are empty.");
+    }
+    if (n > max_inputs()) {
+        throw std::invalid_argument("number of inputs is not supported.");
+    }
+    for (auto& choice : choices) {
+        if (_mm_cvtsi128_si64(_mm_unpackhi_epi64(choice, choice)) != 0 ||
+                static_cast<std::uint64_t>(_mm_cvtsi128_si64(choice)) >= n) {
+            throw std::invalid_argument("choice is out of range.");
+        }
+    }
+    std::vector<block> keys;
+    receive(net, choices, keys);
+
+    std::size_t ots = choices.size();
+    std::size_t chunk = std::max<std::size_t>(1, kNcoChosenChunkBlocks / n);
+    std::vector<block> masked(std::min(chunk, ots) * n);
+    messages.resize(ots);
+    for (std::size_t begin = 0; begin < ots; begin += chunk) {
+        std::size_t len = std::min(chunk, ots - begin);
+        recv_block(net, masked.data(), len * n);
+        for (std::size_t i = 0; i < len; i++) {
+            std::size_t choice = static_cast<std::size_t>(_mm_cvtsi128_si64(choices[begin + i]));
+            messages[begin + i] = masked[i * n + choice] ^ keys[begin + i];
+        }
+    }
+}
+
+}  // namespace verse
+}  // namespace petace
@@ -15,10 +15,12 @@
 #pragma once
 
 #include <array>
+#include <limits>
 #include <memory>
 #include <vector>
 
 #include "network/network.h"
+#include "solo/prng.h"
 
 #include "verse/util/defines.h"
 
@@ -41,6 +43,13 @@ class NcoOtExtReceiver {
     virtual ~NcoOtExtReceiver() {
     }
 
+    /**
+     * @brief Return the largest number of inputs per OT that the scheme supports.
+     */
+    virtual std::size_t max_inputs() const {
+        return std::numeric_limits<std::size_t>::max();
+    }
+
     /**
      * @brief The receiver sets the base ots that are used to extend.
      *
@@ -59,6 +68,31 @@ class NcoOtExtReceiver {
     virtual void receive(const std::shared_ptr<network::Network>& net, const std::vector<block>& choices,
             std::vector<block>& messages) = 0;
 
+    /**
+     * @brief The receiver gets chosen messages of msg_len bytes; each block message is stretched by a PRG.
+     *
+     * @param[in] net The network interface (e.g., PETAce-Network interface).
+     * @param[in] choices The receiver's chosen number, which is stored in 128 bits block.
+     * @param[out] messages The chosen messages; the message of ot i starts at byte i * msg_len.
+     * @param[in] msg_len The byte length of each message.
+     * @throws std::invalid_argument.
+     */
+    virtual void receive(const std::shared_ptr<network::Network>& net, const std::vector<block>& choices,
+            std::vector<solo::Byte>& messages, std::size_t msg_len);
+
+    /**
+     * @brief The receiver gets one of n chosen messages per OT, matching NcoOtExtSender::send_chosen.
+     *
+     * @param[in] net The network interface (e.g., PETAce-Network interface).
+     * @param[in] choices The receiver's chosen numbers, each below n.
+     * @param[in] n The number of messages per OT.
+     * @param[out] messages The chosen messages indexed by choices.
+     * @throws std::invalid_argument if choices is empty, n is zero or above max_inputs(), or a choice is not below n;
+     * nothing is sent then.
+     */
+    virtual void receive_chosen(const std::shared_ptr<network::Network>& net, const std::vector<block>& choices,
+            std::size_t n, std::vector<block>& messages);
+
 protected:
     std::size_t base_ot_sizes_ = 0;
 
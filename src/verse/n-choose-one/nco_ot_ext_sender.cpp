@@ -0,0 +1,128 @@
+// Copyright 2023 TikTok Pte. Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "verse/n-choose-one/nco_ot_ext_sender.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+
+#include "verse/util/aes.h"
+#include "verse/util/common.h"
+
+namespace petace {
+namespace verse {
+
+void NcoOtExtSender::encode(const std::size_t idx, const block& input, solo::Byte* output, std::size_t msg_len) {
+    block seed;
+    encode(idx, input, seed);
+    prg_stretch(&seed, 1, msg_len, output);
+}
+
+void NcoOtExtSender::encode_batch(std::size_t first, std::size_t count, std::size_t n, block* outputs) {
+    for (std::size_t i = 0; i < count; i++) {
+        for (std::size_t v = 0; v < n; v++) {
+            encode(first + i, _mm_set_epi64x(0, static_cast<long long>(v)), outputs[i * n + v]);
+        }
+    }
+}
+
+void NcoOtExtSender::send_chosen(
+        const std::shared_ptr<network::Network>& net, const std::vector<block>& messages, std::size_t n) {
+    if (n == 0 || messages.empty() || messages.size() % n != 0) {
+        throw std::invalid_argument("chosen messages do not match the number of inputs.");
+    }
+    if (n > max_inputs()) {
+        throw std::invalid_argument("number of inputs is not supported.");
+    }
+    std::size_t ots = messages.size() / n;
+    send(net, ots);
+
+    // Keys and masked messages of a chunk of ots are computed in one batch and sent as one frame.
+    std::size_t chunk = std::max<std::size_t>(1, kNcoChosenChunkBlocks / n);
+    std::vector<block> masked(std::min(chunk, ots) * n);
+    for (std::size_t begin = 0; begin < ots; begin += chunk) {
+        std::size_t len = std::min(chunk, ots - begin);
+        encode_batch(begin, len, n, masked.data());
+        const block* inputs = messages.data() + begin * n;
+        for (std::size_t i = 0; i < len * n; i++) {
+            masked[i] ^= inputs[i];
+        }
+        send_block(net, masked.data(), len * n);
+    }
+}
+
+namespace {
+
+// Completion of the ranges of one encode_batch_async call; the last range to finish fulfills the promise.
+struct EncodeBatchJob {
+    std::promise<void> done{};
+    std::atomic<std::size_t> pending{0};
+    std::mutex mutex{};
+    std::exception_ptr error = nullptr;
+
+    void finish(std::exception_ptr e) {
+        if (e != nullptr) {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (error == nullptr) {
+                error = e;
+            }
+        }
+        if (pending.fetch_sub(1) == 1) {
+            if (error != nullptr) {
+                done.set_exception(error);
+            } else {
+                done.set_value();
+            }
+        }
+    }
+};
+
+}  // namespace
+
+std::future<void> NcoOtExtSender::encode_batch_async(
+        ThreadPool& pool, std::size_t first, std::size_t count, std::size_t n, block* outputs) {
+    auto job = std::make_shared<EncodeBatchJob>();
+    std::future<void> ret = job->done.get_future();
+    if (count == 0) {
+        job->done.set_value();
+        return ret;
+    }
+    std::size_t parts = std::min(pool.size(), count);
+    std::size_t step = (count + parts - 1) / parts;
+    parts = (count + step - 1) / step;
+    job->pending = parts;
+    for (std::size_t begin = 0; begin < count; begin += step) {
+        std::size_t len = std::min(step, count - begin);
+        try {
+            pool.submit([this, job, first, begin, len, n, outputs] {
+                try {
+                    encode_batch(first + begin, len, n, outputs + begin * n);
+                } catch (...) {
+                    job->finish(std::current_exception());
+                    return;
+                }
+                job->finish(nullptr);
+            });
+        } catch (...) {
+            job->finish(std::current_exception());
+        }
+    }
+    return ret;
+}
+
+}  // namespace verse
+}  // namespace petace
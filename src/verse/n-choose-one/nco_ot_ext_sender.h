@@ -14,12 +14,16 @@
 
 #pragma once
 
+#include <future>
+#include <limits>
 #include <memory>
 #include <vector>
 
 #include "network/network.h"
+#include "solo/prng.h"
 
 #include "verse/util/defines.h"
+#include "verse/util/thread_pool.h"
 
 namespace petace {
 namespace verse {
@@ -40,6 +44,13 @@ class NcoOtExtSender {
     virtual ~NcoOtExtSender() {
     }
 
+    /**
+     * @brief Return the largest number of inputs per OT that the scheme supports.
+     */
+    virtual std::size_t max_inputs() const {
+        return std::numeric_limits<std::size_t>::max();
+    }
+
     /**
      * @brief The sender sets the base ots that are used to extend.
      *
@@ -66,6 +77,65 @@ class NcoOtExtSender {
      */
     virtual void encode(const std::size_t idx, const block& input, block& output) = 0;
 
+    /**
+     * @brief For the OT at index idx, the sender compute the OT message of msg_len bytes with choice value input.
+     *
+     * The block encoding is stretched by a PRG, matching NcoOtExtReceiver::receive with msg_len.
+     *
+     * @param[in] idx The OT index that should be encoded.
+     * @param[in] input The choice value that should be encoded.
+     * @param[out] output The msg_len bytes of the OT message encoding the input.
+     * @param[in] msg_len The byte length of the message.
+     */
+    virtual void encode(const std::size_t idx, const block& input, solo::Byte* output, std::size_t msg_len);
+
+    /**
+     * @brief For the OTs first to first + count - 1, the sender computes the encodings of all inputs 0 to n - 1.
+     *
+     * Matches encode(idx, _mm_set_epi64x(0, v)). The default loops over encode; schemes override it to share the
+     * per-index state and the codes of the inputs across the batch. Overrides must be safe to call concurrently on
+     * disjoint ranges, with the same or different n.
+     *
+     * @param[in] first The first OT index.
+     * @param[in] count The number of OT indices.
+     * @param[in] n The number of inputs per OT.
+     * @param[out] outputs The encoding of input v of OT first + i is written to outputs[i * n + v].
+     */
+    virtual void encode_batch(std::size_t first, std::size_t count, std::size_t n, block* outputs);
+
+    /**
+     * @brief The sender transfers n chosen messages per OT; the receiver of OT i gets messages[i * n + c_i].
+     *
+     * Runs send for messages.size() / n OTs, then streams the messages masked by their keys in chunks of
+     * kNcoChosenChunkBlocks blocks; the matching call is NcoOtExtReceiver::receive_chosen.
+     *
+     * @param[in] net The network interface (e.g., PETAce-Network interface).
+     * @param[in] messages The chosen messages; message v of OT i is messages[i * n + v].
+     * @param[in] n The number of messages per OT.
+     * @throws std::invalid_argument if messages is empty or not a multiple of n, or n is above max_inputs(); nothing
+     * is sent then.
+     */
+    virtual void send_chosen(
+            const std::shared_ptr<network::Network>& net, const std::vector<block>& messages, std::size_t n);
+
+    /**
+     * @brief Queue encode_batch on a thread pool, split into one range per worker, and return at once.
+     *
+     * Encoding is pure computation, so the ranges never wait on the network or on each other and cannot deadlock a
+     * pool that is busy with other jobs. This object must not be used for anything but encoding until the future is
+     * ready.
+     *
+     * @param[in] pool The pool that runs the ranges.
+     * @param[in] first The first OT index.
+     * @param[in] count The number of OT indices.
+     * @param[in] n The number of inputs per OT.
+     * @param[out] outputs The encoding of input v of OT first + i is written to outputs[i * n + v]; must stay alive
+     * until the future is ready.
+     * @return A future that becomes ready when every range is encoded and rethrows the first exception, if any.
+     */
+    std::future<void> encode_batch_async(
+            ThreadPool& pool, std::size_t first, std::size_t count, std::size_t n, block* outputs);
+
 protected:
     std::size_t base_ot_sizes_ = 0;
 
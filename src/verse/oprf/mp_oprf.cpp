@@ -0,0 +1,261 @@
+// Copyright 2023 TikTok Pte. Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "verse/oprf/mp_oprf.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+#include "solo/prng.h"
+
+#include "verse/util/common.h"
+#include "verse/verse_factory.h"
+
+namespace petace {
+namespace verse {
+
+namespace {
+
+// Items are evaluated in tiles of 128, so their gathered bits form one 128-column matrix to transpose.
+const std::size_t kTileItems = sizeof(block) * 8;
+
+// Every prf block yields four 32-bit positions.
+const std::size_t kPositionsPerBlock = sizeof(block) / sizeof(std::uint32_t);
+
+// The matrix is streamed in frames of about this many blocks, a few rows of every column each.
+const std::size_t kMatrixChunkBlocks = std::size_t(1) << 16;
+
+std::size_t checked_width(std::size_t width) {
+    if (width == 0 || width % (sizeof(block) * 8) != 0) {
+        throw std::invalid_argument("OT base size is not supported.");
+    }
+    return width;
+}
+
+// The number of matrix rows for n receiver items: a power of two, so positions are masked prf words.
+std::size_t matrix_height(std::size_t n) {
+    std::size_t height = sizeof(block) * 8;
+    while (height < n) {
+        height <<= 1;
+    }
+    return height;
+}
+
+struct TileScratch {
+    // Position v_i of item j is word j * width + i of the prf output, masked by the height.
+    std::vector<block> prf{};
+    std::vector<block> gathered{};
+    std::vector<block> rows{};
+    std::array<block, kTileItems> hashes{};
+    std::array<block, kTileItems> inputs{};
+};
+
+// Compute the prf output F_k(H_1(x)) holding the width positions of up to 128 items.
+void tile_positions(
+        const AesRoundKeys& prf_keys, const block* items, std::size_t count, std::size_t width, TileScratch& scratch) {
+    std::size_t per_item = width / kPositionsPerBlock;
+    for (std::size_t j = 0; j < count; j++) {
+        scratch.inputs[j] = items[j];
+    }
+    aes_ecb_encrypt(fixed_aes_keys(), scratch.inputs.data(), count);
+    scratch.prf.resize(kTileItems * per_item);
+    for (std::size_t j = 0; j < count; j++) {
+        block hashed = scratch.inputs[j] ^ items[j];
+        for (std::size_t t = 0; t < per_item; t++) {
+            scratch.prf[j * per_item + t] = hashed ^ _mm_set_epi64x(0, static_cast<long long>(t));
+        }
+    }
+    aes_ecb_encrypt(prf_keys, scratch.prf.data(), count * per_item);
+}
+
+// Gather bit v_i(y) of every column i for a tile of items, transpose and hash each item's width bits with H_2.
+void tile_outputs(const block* matrix, std::size_t height, std::size_t width, std::size_t count, TileScratch& scratch,
+        block* outputs) {
+    std::size_t column_blocks = height / (sizeof(block) * 8);
+    std::uint32_t mask = static_cast<std::uint32_t>(height - 1);
+    const std::uint32_t* words = reinterpret_cast<const std::uint32_t*>(scratch.prf.data());
+    scratch.gathered.resize(width);
+    for (std::size_t i = 0; i < width; i++) {
+        const std::uint8_t* column = reinterpret_cast<const std::uint8_t*>(matrix + i * column_blocks);
+        std::uint64_t half[2] = {0, 0};
+        for (std::size_t j = 0; j < count; j++) {
+            std::uint32_t p = words[j * width + i] & mask;
+            half[j / 64] |= static_cast<std::uint64_t>((column[p / 8] >> (p % 8)) & 1) << (j % 64);
+        }
+        scratch.gathered[i] = _mm_set_epi64x(static_cast<long long>(half[1]), static_cast<long long>(half[0]));
+    }
+    // Row j of the transpose holds the width bits of item j.
+    scratch.rows.resize(width);
+    matrix_transpose(scratch.gathered.data(), width, kTileItems, scratch.rows.data());
+
+    // H_2 chains h = pi(h ^ x) ^ h ^ x over the 128-bit pieces of a row, for the whole tile at once.
+    std::size_t row_blocks = width / (sizeof(block) * 8);
+    scratch.hashes.fill(_mm_setzero_si128());
+    for (std::size_t b = 0; b < row_blocks; b++) {
+        for (std::size_t j = 0; j < kTileItems; j++) {
+            scratch.inputs[j] = scratch.hashes[j] ^ scratch.rows[j * row_blocks + b];
+            scratch.hashes[j] = scratch.inputs[j];
+        }
+        aes_ecb_encrypt(fixed_aes_keys(), scratch.inputs.data(), kTileItems);
+        for (std::size_t j = 0; j < kTileItems; j++) {
+            scratch.hashes[j] ^= scratch.inputs[j];
+        }
+    }
+    std::copy(scratch.hashes.begin(), scratch.hashes.begin() + count, outputs);
+}
+
+void evaluate_items(ThreadPool* pool, const AesRoundKeys& prf_keys, const block* matrix, std::size_t height,
+        std::size_t width, const std::vector<block>& items, std::vector<block>& outputs) {
+    outputs.resize(items.size());
+    std::size_t tiles = (items.size() + kTileItems - 1) / kTileItems;
+    std::vector<TileScratch> scratch(parallel_parts(pool));
+    parallel_for_parts(pool, tiles, [&](std::size_t part, std::size_t first, std::size_t last) {
+        for (std::size_t t = first; t < last; t++) {
+            std::size_t begin = t * kTileItems;
+            std::size_t count = std::min(kTileItems, items.size() - begin);
+            tile_positions(prf_keys, items.data() + begin, count, width, scratch[part]);
+            tile_outputs(matrix, height, width, count, scratch[part], outputs.data() + begin);
+        }
+    });
+}
+
+VerseParams base_ot_params(std::size_t width) {
+    VerseParams params;
+    params.base_ot_sizes = width;
+    params.ext_ot_sizes = width;
+    return params;
+}
+
+}  // namespace
+
+MpOprfSender::MpOprfSender(const VerseParams& params)
+        : width_(checked_width(params.base_ot_sizes)), matrix_(buffer_allocator(params)) {
+    if (params.num_threads > 1) {
+        pool_.reset(new ThreadPool(params.num_threads - 1));
+    }
+}
+
+void MpOprfSender::setup(const std::shared_ptr<network::Network>& net, std::size_t receiver_size) {
+    std::vector<block> choices(width_ / (sizeof(block) * 8));
+    solo::PRNG::get_random_byte_array(choices.size() * sizeof(block), reinterpret_cast<solo::Byte*>(choices.data()));
+    std::vector<block> keys;
+    auto base_receiver =
+            VerseFactory<BaseOtReceiver>::get_instance().build(OTScheme::IknpBaseOtReceiver, base_ot_params(width_));
+    base_receiver->receive(net, choices, keys);
+
+    block prf_key = read_block_from_dev_urandom();
+    send_block(net, &prf_key, 1);
+    aes_expand_key(prf_key, prf_keys_);
+
+    // C_i = PRG(k_{i, s_i}) ^ s_i * r_i, expanded and corrected a few rows of every column at a time.
+    height_ = matrix_height(receiver_size);
+    std::size_t column_blocks = height_ / (sizeof(block) * 8);
+    block* matrix = matrix_.resize(width_ * column_blocks);
+    MultiKeyPrg prg(keys.data(), keys.size());
+    std::size_t chunk = std::max<std::size_t>(1, kMatrixChunkBlocks / width_);
+    std::vector<block> received(width_ * std::min(chunk, column_blocks));
+    for (std::size_t begin = 0; begin < column_blocks; begin += chunk) {
+        std::size_t len = std::min(chunk, column_blocks - begin);
+        prg.generate_at(begin, len, matrix + begin, column_blocks);
+        recv_block(net, received.data(), width_ * len);
+        for (std::size_t i = 0; i < width_; i++) {
+            if (bit_from_blocks(choices, i)) {
+                block* column = matrix + i * column_blocks + begin;
+                for (std::size_t t = 0; t < len; t++) {
+                    column[t] ^= received[i * len + t];
+                }
+            }
+        }
+    }
+}
+
+void MpOprfSender::evaluate(const std::vector<block>& items, std::vector<block>& outputs) const {
+    if (height_ == 0) {
+        throw std::logic_error("oprf sender is not set up.");
+    }
+    evaluate_items(pool_.get(), prf_keys_, matrix_.data(), height_, width_, items, outputs);
+}
+
+MpOprfReceiver::MpOprfReceiver(const VerseParams& params)
+        : width_(checked_width(params.base_ot_sizes)), matrix_(buffer_allocator(params)) {
+    if (params.num_threads > 1) {
+        pool_.reset(new ThreadPool(params.num_threads - 1));
+    }
+}
+
+void MpOprfReceiver::receive(
+        const std::shared_ptr<network::Network>& net, const std::vector<block>& items, std::vector<block>& outputs) {
+    std::vector<std::array<block, 2>> base_ots;
+    auto base_sender =
+            VerseFactory<BaseOtSender>::get_instance().build(OTScheme::IknpBaseOtSender, base_ot_params(width_));
+    base_sender->send(net, base_ots);
+
+    block prf_key;
+    recv_block(net, &prf_key, 1);
+    AesRoundKeys prf_keys;
+    aes_expand_key(prf_key, prf_keys);
+
+    // D is all ones except at the positions of the items.
+    std::size_t height = matrix_height(items.size());
+    std::size_t column_blocks = height / (sizeof(block) * 8);
+    block* matrix = matrix_.resize(width_ * column_blocks);
+    memset(matrix, 0xFF, width_ * column_blocks * sizeof(block));
+    TileScratch scratch;
+    for (std::size_t begin = 0; begin < items.size(); begin += kTileItems) {
+        std::size_t count = std::min(kTileItems, items.size() - begin);
+        tile_positions(prf_keys, items.data() + begin, count, width_, scratch);
+        const std::uint32_t* words = reinterpret_cast<const std::uint32_t*>(scratch.prf.data());
+        for (std::size_t j = 0; j < count; j++) {
+            for (std::size_t i = 0; i < width_; i++) {
+                std::uint32_t p = words[j * width_ + i] & static_cast<std::uint32_t>(height - 1);
+                reinterpret_cast<std::uint8_t*>(matrix + i * column_blocks)[p / 8] &=
+                        static_cast<std::uint8_t>(~(1u << (p % 8)));
+            }
+        }
+    }
+
+    // Send r_i = A_i ^ B_i ^ D_i a few rows at a time and keep A_i in place of D_i.
+    std::vector<block> keys0(width_);
+    std::vector<block> keys1(width_);
+    for (std::size_t i = 0; i < width_; i++) {
+        keys0[i] = base_ots[i][0];
+        keys1[i] = base_ots[i][1];
+    }
+    MultiKeyPrg prg0(keys0.data(), width_);
+    MultiKeyPrg prg1(keys1.data(), width_);
+    std::size_t chunk = std::max<std::size_t>(1, kMatrixChunkBlocks / width_);
+    std::vector<block> a(width_ * std::min(chunk, column_blocks));
+    std::vector<block> r(a.size());
+    for (std::size_t begin = 0; begin < column_blocks; begin += chunk) {
+        std::size_t len = std::min(chunk, column_blocks - begin);
+        prg0.generate_at(begin, len, a.data(), len);
+        prg1.generate_at(begin, len, r.data(), len);
+        for (std::size_t i = 0; i < width_; i++) {
+            block* column = matrix + i * column_blocks + begin;
+            for (std::size_t t = 0; t < len; t++) {
+                r[i * len + t] ^= a[i * len + t] ^ column[t];
+                column[t] = a[i * len + t];
+            }
+        }
+        send_block(net, r.data(), width_ * len);
+    }
+
+    evaluate_items(pool_.get(), prf_keys, matrix, height, width_, items, outputs);
+}
+
+}  // namespace verse
+}  // namespace petace
@@ -0,0 +1,129 @@
+// Copyright 2023 TikTok Pte. Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "network/network.h"
+
+#include "verse/util/aes.h"
+#include "verse/util/buffer.h"
+#include "verse/util/defines.h"
+#include "verse/util/thread_pool.h"
+
+namespace petace {
+namespace verse {
+
+/*
+ * Multi-point oprf of Chase and Miao (CRYPTO 2020).
+ * The matrices below have m rows, m being the receiver's set size rounded up to a power of two, and w columns.
+ * 1. The sender picks random choices s in {0, 1}^w and gets w base ots k_{i, s_i} from iknp-bootstrapped base ots.
+ * 2. The sender sends a prf key; every item x maps to w positions v_i(x) in [0, m) with F_k(H_1(x)).
+ * 3. The receiver sets D to all ones except D_i[v_i(x)] = 0 for its items, and sends r_i = A_i ^ B_i ^ D_i with
+ *    A_i = PRG(k_{i, 0}) and B_i = PRG(k_{i, 1}).
+ * 4. The sender keeps C_i = PRG(k_{i, s_i}) ^ s_i * r_i, which equals A_i wherever D_i is zero.
+ * 5. The output on y is H_2(C_1[v_1(y)] || ... || C_w[v_w(y)]); the receiver evaluates its own items on A.
+ * H_1 and H_2 are built from fixed-key AES, F_k is AES under the sender's key.
+ */
+
+/**
+ * @brief The default matrix width; enough for 2^24 receiver items with 40-bit statistical security.
+ */
+const std::size_t kMpOprfWidth = 640;
+
+/**
+ * @brief Multi-point oprf [sender], which learns the key and evaluates any number of items.
+ *
+ * @see Refer to README.md for more details.
+ */
+class MpOprfSender {
+public:
+    /**
+     * @brief Create a sender.
+     *
+     * @param[in] params base_ot_sizes is the matrix width w, a multiple of 128 (e.g., kMpOprfWidth); num_threads
+     * parallelizes evaluation and the allocator options place the matrix.
+     * @throws std::invalid_argument if the width is not supported.
+     */
+    explicit MpOprfSender(const VerseParams& params);
+
+    /**
+     * @brief Run the base ots and receive the oprf matrix for a receiver set of receiver_size items.
+     *
+     * @param[in] net The network interface (e.g., PETAce-Network interface).
+     * @param[in] receiver_size The number of items of the receiver.
+     */
+    void setup(const std::shared_ptr<network::Network>& net, std::size_t receiver_size);
+
+    /**
+     * @brief Evaluate the oprf on items, 128 at a time and spread across threads.
+     *
+     * @param[in] items The items.
+     * @param[out] outputs The oprf values of the items.
+     * @throws std::logic_error if setup has not been called.
+     */
+    void evaluate(const std::vector<block>& items, std::vector<block>& outputs) const;
+
+private:
+    std::size_t width_ = kMpOprfWidth;
+
+    std::size_t height_ = 0;
+
+    AesRoundKeys prf_keys_{};
+
+    // Column i of the matrix C holds height_ / 128 blocks.
+    Buffer<block> matrix_;
+
+    std::unique_ptr<ThreadPool> pool_ = nullptr;
+};
+
+/**
+ * @brief Multi-point oprf [receiver], which learns the oprf values of its own items.
+ *
+ * @see Refer to README.md for more details.
+ */
+class MpOprfReceiver {
+public:
+    /**
+     * @brief Create a receiver.
+     *
+     * @param[in] params base_ot_sizes is the matrix width w, a multiple of 128 and the same as the sender's.
+     * @throws std::invalid_argument if the width is not supported.
+     */
+    explicit MpOprfReceiver(const VerseParams& params);
+
+    /**
+     * @brief Run the oprf on items; the sender calls setup with items.size().
+     *
+     * @param[in] net The network interface (e.g., PETAce-Network interface).
+     * @param[in] items The items.
+     * @param[out] outputs The oprf values of the items.
+     */
+    void receive(const std::shared_ptr<network::Network>& net, const std::vector<block>& items,
+            std::vector<block>& outputs);
+
+private:
+    std::size_t width_ = kMpOprfWidth;
+
+    // Column i of the matrix D, then of A, holds m / 128 blocks.
+    Buffer<block> matrix_;
+
+    std::unique_ptr<ThreadPool> pool_ = nullptr;
+};
+
+}  // namespace verse
+}  // namespace petace
@@ -0,0 +1,236 @@
+// Copyright 2023 TikTok Pte. Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "verse/session/ot_session_manager.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+#include "verse/util/common.h"
+#include "verse/verse_factory.h"
+
+namespace petace {
+namespace verse {
+
+struct OtSessionManager::Session {
+    OtRole role = OtRole::Sender;
+
+    VerseParams params{};
+
+    std::unique_ptr<OtExtSender> sender = nullptr;
+
+    std::unique_ptr<OtExtReceiver> receiver = nullptr;
+
+    std::mutex mutex{};
+
+    std::condition_variable cv{};
+
+    std::deque<std::packaged_task<void()>> tasks{};
+
+    // Set by stop; the thread finishes the queued requests and exits.
+    bool stopping = false;
+
+    OtSessionStats stats{};
+
+    // The only thread that runs requests of this session and so the only one that uses params.net.
+    std::thread thread{};
+};
+
+OtSessionManager::OtSessionManager(std::size_t num_threads) : pool_(std::make_shared<ThreadPool>(num_threads)) {
+}
+
+OtSessionManager::~OtSessionManager() {
+    std::map<std::size_t, std::shared_ptr<Session>> sessions;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        sessions.swap(sessions_);
+    }
+    for (auto& session : sessions) {
+        stop(session.second);
+    }
+}
+
+std::size_t OtSessionManager::open_session(const VerseParams& params, OtRole role) {
+    if (params.net == nullptr) {
+        throw std::invalid_argument("session network is not set.");
+    }
+    auto session = std::make_shared<Session>();
+    session->role = role;
+    session->params = params;
+    session->params.pool = pool_;
+    if (role == OtRole::Sender) {
+        session->sender = VerseFactory<OtExtSender>::get_instance().build(OTScheme::IknpSender, params);
+    } else {
+        session->receiver = VerseFactory<OtExtReceiver>::get_instance().build(OTScheme::IknpReceiver, params);
+    }
+
+    session->thread = std::thread(run, session.get());
+
+    std::size_t session_id = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        session_id = next_session_id_++;
+        sessions_.emplace(session_id, session);
+    }
+
+    Session* raw = session.get();
+    enqueue(session, [raw]() -> std::size_t {
+        const auto& net = raw->params.net;
+        if (raw->role == OtRole::Sender) {
+            std::vector<block> base_choices((raw->params.base_ot_sizes + 127) / 128);
+            for (auto& choice : base_choices) {
+                choice = read_block_from_dev_urandom();
+            }
+            std::vector<block> base_recv_ots;
+            auto npot_receiver = VerseFactory<BaseOtReceiver>::get_instance().build(
+                    OTScheme::NaorPinkasReceiver, raw->params);
+            npot_receiver->receive(net, base_choices, base_recv_ots);
+            raw->sender->set_base_ots(base_choices, base_recv_ots);
+        } else {
+            std::vector<std::array<block, 2>> base_send_ots;
+            auto npot_sender =
+                    VerseFactory<BaseOtSender>::get_instance().build(OTScheme::NaorPinkasSender, raw->params);
+            npot_sender->send(net, base_send_ots);
+            raw->receiver->set_base_ots(base_send_ots);
+        }
+        return 0;
+    });
+    return session_id;
+}
+
+void OtSessionManager::close_session(std::size_t session_id) {
+    std::shared_ptr<Session> session = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto where = sessions_.find(session_id);
+        if (where == sessions_.end()) {
+            throw std::invalid_argument("ot session does not exist.");
+        }
+        session = where->second;
+        sessions_.erase(where);
+    }
+    stop(session);
+}
+
+std::future<void> OtSessionManager::send(std::size_t session_id, std::vector<std::array<block, 2>>& messages) {
+    auto session = find_session(session_id);
+    if (session->role != OtRole::Sender) {
+        throw std::invalid_argument("session is not a sender session.");
+    }
+    Session* raw = session.get();
+    return enqueue(session, [raw, &messages]() -> std::size_t {
+        raw->sender->send(raw->params.net, messages);
+        return messages.size();
+    });
+}
+
+std::future<void> OtSessionManager::receive(
+        std::size_t session_id, const std::vector<block>& choices, std::vector<block>& messages) {
+    auto session = find_session(session_id);
+    if (session->role != OtRole::Receiver) {
+        throw std::invalid_argument("session is not a receiver session.");
+    }
+    Session* raw = session.get();
+    return enqueue(session, [raw, &choices, &messages]() -> std::size_t {
+        raw->receiver->receive(raw->params.net, choices, messages);
+        return messages.size();
+    });
+}
+
+OtSessionStats OtSessionManager::get_stats(std::size_t session_id) const {
+    auto session = find_session(session_id);
+    std::lock_guard<std::mutex> lock(session->mutex);
+    return session->stats;
+}
+
+std::size_t OtSessionManager::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return sessions_.size();
+}
+
+std::shared_ptr<OtSessionManager::Session> OtSessionManager::find_session(std::size_t session_id) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto where = sessions_.find(session_id);
+    if (where == sessions_.end()) {
+        throw std::invalid_argument("ot session does not exist.");
+    }
+    return where->second;
+}
+
+std::future<void> OtSessionManager::enqueue(
+        const std::shared_ptr<Session>& session, std::function<std::size_t()> work) {
+    Session* raw = session.get();
+    std::packaged_task<void()> task([raw, work]() {
+        auto net = raw->params.net;
+        std::size_t sent = net->get_bytes_sent();
+        std::size_t received = net->get_bytes_received();
+        auto begin = std::chrono::steady_clock::now();
+        std::size_t ots = work();
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+
+        std::lock_guard<std::mutex> lock(raw->mutex);
+        if (ots != 0) {
+            raw->stats.batches++;
+            raw->stats.ots += ots;
+        }
+        raw->stats.busy_seconds += elapsed.count();
+        raw->stats.bytes_sent += net->get_bytes_sent() - sent;
+        raw->stats.bytes_received += net->get_bytes_received() - received;
+    });
+    std::future<void> ret = task.get_future();
+    {
+        std::lock_guard<std::mutex> lock(session->mutex);
+        if (session->stopping) {
+            throw std::invalid_argument("ot session is closed.");
+        }
+        session->tasks.emplace_back(std::move(task));
+    }
+    session->cv.notify_one();
+    return ret;
+}
+
+void OtSessionManager::run(Session* session) {
+    for (;;) {
+        std::packaged_task<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(session->mutex);
+            session->cv.wait(lock, [session] { return session->stopping || !session->tasks.empty(); });
+            if (session->tasks.empty()) {
+                return;
+            }
+            task = std::move(session->tasks.front());
+            session->tasks.pop_front();
+        }
+        // Exceptions are stored in the future of the request.
+        task();
+    }
+}
+
+void OtSessionManager::stop(const std::shared_ptr<Session>& session) {
+    {
+        std::lock_guard<std::mutex> lock(session->mutex);
+        session->stopping = true;
+    }
+    session->cv.notify_one();
+    if (session->thread.joinable()) {
+        session->thread.join();
+    }
+}
+
+}  // namespace verse
+}  // namespace petace
@@ -0,0 +1,169 @@
+// Copyright 2023 TikTok Pte. Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "network/network.h"
+
+#include "verse/util/defines.h"
+#include "verse/util/thread_pool.h"
+
+namespace petace {
+namespace verse {
+
+enum class OtRole : std::uint32_t { Sender = 0, Receiver = 1 };
+
+/**
+ * @brief Accumulated statistics of one ot session.
+ */
+struct OtSessionStats {
+    // Number of completed ot extension batches.
+    std::size_t batches = 0;
+    // Number of extended ots over all completed batches.
+    std::size_t ots = 0;
+    // Wall-clock seconds the session thread spent on requests, including base ot setup and waits for the peer.
+    double busy_seconds = 0.0;
+    std::size_t bytes_sent = 0;
+    std::size_t bytes_received = 0;
+
+    /**
+     * @brief Return extended ots per busy second.
+     */
+    double ots_per_second() const {
+        return busy_seconds > 0.0 ? static_cast<double>(ots) / busy_seconds : 0.0;
+    }
+};
+
+/**
+ * @brief Serves 1-out-of-2 ot extension to many peers from one process.
+ *
+ * Every session owns its network, its base ots and its iknp instance, so the PRNG state of one peer is never shared
+ * with another. Each session runs its requests in order on a thread of its own, which is the only thread that talks to
+ * its peer, so a slow peer delays only its own session. The transposes and hashes of all sessions are spread over one
+ * shared pool whose tasks never wait on the network.
+ *
+ * @par Limits.
+ * The manager keeps one thread per open session, so it suits tens to hundreds of peers rather than thousands. Requests
+ * have no timeout: a peer that stops answering blocks its session until its network fails, and close_session and the
+ * destructor wait for that session just as long.
+ *
+ * @par Example.
+ * Refer to ot_session_test.cpp.
+ */
+class OtSessionManager {
+public:
+    /**
+     * @brief Create a manager with a compute pool of num_threads workers.
+     *
+     * @param[in] num_threads The number of compute threads shared by all sessions.
+     * @throws std::invalid_argument if num_threads is zero.
+     */
+    explicit OtSessionManager(std::size_t num_threads);
+
+    /**
+     * @brief Wait for all queued requests, close all sessions and join their threads.
+     */
+    ~OtSessionManager();
+
+    OtSessionManager(const OtSessionManager&) = delete;
+    OtSessionManager& operator=(const OtSessionManager&) = delete;
+
+    /**
+     * @brief Open a session with a peer and queue its base ot setup.
+     *
+     * The local party plays role in the ot extension; the peer must run the matching base ot (naor-pinkas with the
+     * opposite role) followed by iknp on the other end of params.net.
+     *
+     * @param[in] params Parameters of the session; params.net is the connection to the peer.
+     * @param[in] role The role of the local party in the ot extension.
+     * @return The session id.
+     * @throws std::invalid_argument if params.net is null.
+     */
+    std::size_t open_session(const VerseParams& params, OtRole role);
+
+    /**
+     * @brief Wait for all queued requests of a session, join its thread and remove it.
+     *
+     * @param[in] session_id The session id returned by open_session.
+     * @throws std::invalid_argument if the session does not exist.
+     */
+    void close_session(std::size_t session_id);
+
+    /**
+     * @brief Queue a batch of random ots for a sender session.
+     *
+     * @param[in] session_id The session id returned by open_session.
+     * @param[out] messages The random output messages; must stay alive until the future is ready.
+     * @return A future that becomes ready when the batch completes.
+     * @throws std::invalid_argument if the session does not exist or is not a sender session.
+     */
+    std::future<void> send(std::size_t session_id, std::vector<std::array<block, 2>>& messages);
+
+    /**
+     * @brief Queue a batch of chosen-bit ots for a receiver session.
+     *
+     * @param[in] session_id The session id returned by open_session.
+     * @param[in] choices The chosen bits; must stay alive until the future is ready.
+     * @param[out] messages The chosen messages; must stay alive until the future is ready.
+     * @return A future that becomes ready when the batch completes.
+     * @throws std::invalid_argument if the session does not exist or is not a receiver session.
+     */
+    std::future<void> receive(
+            std::size_t session_id, const std::vector<block>& choices, std::vector<block>& messages);
+
+    /**
+     * @brief Return a snapshot of the statistics of a session.
+     *
+     * @param[in] session_id The session id returned by open_session.
+     * @throws std::invalid_argument if the session does not exist.
+     */
+    OtSessionStats get_stats(std::size_t session_id) const;
+
+    /**
+     * @brief Return the number of open sessions.
+     */
+    std::size_t size() const;
+
+private:
+    struct Session;
+
+    std::shared_ptr<Session> find_session(std::size_t session_id) const;
+
+    static std::future<void> enqueue(const std::shared_ptr<Session>& session, std::function<std::size_t()> work);
+
+    static void run(Session* session);
+
+    static void stop(const std::shared_ptr<Session>& session);
+
+    mutable std::mutex mutex_{};
+
+    std::map<std::size_t, std::shared_ptr<Session>> sessions_{};
+
+    std::size_t next_session_id_ = 0;
+
+    // Shared by the iknp instances of all sessions, which keep it alive until they are destroyed.
+    std::shared_ptr<ThreadPool> pool_ = nullptr;
+};
+
+}  // namespace verse
+}  // namespace petace
@@ -0,0 +1,210 @@
+// Copyright 2023 TikTok Pte. Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "verse/triple/arithmetic_triple.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <stdexcept>
+
+#include "solo/prng.h"
+
+#include "verse/two-choose-one/iknp/iknp_pair.h"
+#include "verse/util/aes.h"
+#include "verse/util/common.h"
+
+namespace petace {
+namespace verse {
+
+namespace {
+
+// Triples whose packed corrections fill a whole number of 64-bit words, so ranges of groups never share a word.
+const std::size_t kPackGroup = 64;
+
+// Ots per triple are at most the largest supported k.
+const std::size_t kMaxBitLength = 64;
+
+inline std::uint64_t low_mask(std::size_t width) {
+    return width >= 64 ? ~std::uint64_t(0) : (std::uint64_t(1) << width) - 1;
+}
+
+inline std::uint64_t low_word(const block& b) {
+    return static_cast<std::uint64_t>(_mm_cvtsi128_si64(b));
+}
+
+// Or the low width bits of value into the bit stream at bit offset pos.
+inline void put_bits(std::uint64_t* words, std::size_t pos, std::uint64_t value, std::size_t width) {
+    std::size_t shift = pos % 64;
+    words[pos / 64] |= value << shift;
+    if (shift + width > 64) {
+        words[pos / 64 + 1] |= value >> (64 - shift);
+    }
+}
+
+inline std::uint64_t get_bits(const std::uint64_t* words, std::size_t pos, std::size_t width) {
+    std::size_t shift = pos % 64;
+    std::uint64_t value = words[pos / 64] >> shift;
+    if (shift + width > 64) {
+        value |= words[pos / 64 + 1] << (64 - shift);
+    }
+    return value & low_mask(width);
+}
+
+// Write the low words of tccr_hash(rows[j] ^ offset) with tweaks index + j for j < n <= 64.
+inline void hash_words(const block* rows, const block& offset, std::uint64_t index, std::size_t n, std::uint64_t* out) {
+    block hashes[kMaxBitLength];
+    tccr_hash(rows, offset, index, hashes, n);
+    for (std::size_t j = 0; j < n; j++) {
+        out[j] = low_word(hashes[j]);
+    }
+}
+
+}  // namespace
+
+ArithmeticTripleGenerator::ArithmeticTripleGenerator(const VerseParams& params, std::size_t bit_length, bool is_leader)
+        : params_(params), bit_length_(bit_length), is_leader_(is_leader) {
+    if (bit_length_ != 32 && bit_length_ != 64) {
+        throw std::invalid_argument("bit length is not supported.");
+    }
+    if (params_.base_ot_sizes != sizeof(block) * 8) {
+        throw std::invalid_argument("OT base size is not supported.");
+    }
+    if (params_.ext_ot_sizes == 0 || params_.ext_ot_sizes % (sizeof(block) * 8) != 0) {
+        throw std::invalid_argument("OT extension size is not supported.");
+    }
+    if (params_.num_threads > 1) {
+        pool_.reset(new ThreadPool(params_.num_threads - 1));
+    }
+}
+
+void ArithmeticTripleGenerator::setup(const std::shared_ptr<network::Network>& net) {
+    setup_iknp_pair(net, params_, is_leader_, ot_sender_, ot_receiver_);
+    send_index_ = 0;
+    recv_index_ = 0;
+}
+
+void ArithmeticTripleGenerator::generate(const std::shared_ptr<network::Network>& net, std::size_t n,
+        std::vector<std::uint64_t>& a, std::vector<std::uint64_t>& b, std::vector<std::uint64_t>& c) {
+    if (ot_sender_ == nullptr) {
+        throw std::logic_error("triple generator is not set up.");
+    }
+    std::uint64_t mask = low_mask(bit_length_);
+    a.resize(n);
+    b.resize(n);
+    c.resize(n);
+    solo::PRNG::get_random_byte_array(n * sizeof(std::uint64_t), reinterpret_cast<solo::Byte*>(a.data()));
+    solo::PRNG::get_random_byte_array(n * sizeof(std::uint64_t), reinterpret_cast<solo::Byte*>(b.data()));
+    for (std::size_t i = 0; i < n; i++) {
+        a[i] &= mask;
+        b[i] &= mask;
+    }
+
+    std::vector<std::uint64_t> sender_share(n);
+    std::vector<std::uint64_t> receiver_share(n);
+    if (is_leader_) {
+        multiply_as_sender(net, a.data(), n, sender_share.data());
+        multiply_as_receiver(net, b.data(), n, receiver_share.data());
+    } else {
+        multiply_as_receiver(net, b.data(), n, receiver_share.data());
+        multiply_as_sender(net, a.data(), n, sender_share.data());
+    }
+    for (std::size_t i = 0; i < n; i++) {
+        c[i] = (a[i] * b[i] + sender_share[i] + receiver_share[i]) & mask;
+    }
+}
+
+void ArithmeticTripleGenerator::multiply_as_sender(const std::shared_ptr<network::Network>& net,
+        const std::uint64_t* a, std::size_t count, std::uint64_t* share) {
+    std::size_t k = bit_length_;
+    std::size_t packed_bits = k * (k + 1) / 2;
+    std::size_t batch = params_.ext_ot_sizes / k;
+    for (std::size_t begin = 0; begin < count; begin += batch) {
+        std::size_t len = std::min(batch, count - begin);
+        ot_sender_->send_correlated(net, rows_);
+        block delta = ot_sender_->delta();
+        block zero = _mm_setzero_si128();
+        std::uint64_t index = send_index_;
+        corrections_.resize((len * packed_bits + 63) / 64);
+        std::size_t groups = (len + kPackGroup - 1) / kPackGroup;
+        parallel_for(pool_.get(), groups, [&](std::size_t first, std::size_t last) {
+            std::size_t word_begin = first * packed_bits;
+            std::size_t word_end = std::min(last * packed_bits, corrections_.size());
+            std::fill(corrections_.begin() + word_begin, corrections_.begin() + word_end, 0);
+            for (std::size_t j = first * kPackGroup; j < std::min(last * kPackGroup, len); j++) {
+                std::uint64_t aj = a[begin + j];
+                std::uint64_t sum = 0;
+                std::size_t pos = j * packed_bits;
+                std::array<std::uint64_t, kMaxBitLength> x0;
+                std::array<std::uint64_t, kMaxBitLength> x1;
+                hash_words(rows_.data() + j * k, zero, index + j * k, k, x0.data());
+                hash_words(rows_.data() + j * k, delta, index + j * k, k, x1.data());
+                for (std::size_t i = 0; i < k; i++) {
+                    std::size_t width = k - i;
+                    std::uint64_t m0 = x0[i];
+                    std::uint64_t m1 = x1[i];
+                    put_bits(corrections_.data(), pos, (m1 - m0 - aj) & low_mask(width), width);
+                    sum += (m0 & low_mask(width)) << i;
+                    pos += width;
+                }
+                share[begin + j] = 0 - sum;
+            }
+        });
+        send_frame(net, corrections_.data(), corrections_.size() * sizeof(std::uint64_t));
+        send_index_ += params_.ext_ot_sizes;
+    }
+}
+
+void ArithmeticTripleGenerator::multiply_as_receiver(const std::shared_ptr<network::Network>& net,
+        const std::uint64_t* b, std::size_t count, std::uint64_t* share) {
+    std::size_t k = bit_length_;
+    std::size_t packed_bits = k * (k + 1) / 2;
+    std::size_t batch = params_.ext_ot_sizes / k;
+    for (std::size_t begin = 0; begin < count; begin += batch) {
+        std::size_t len = std::min(batch, count - begin);
+        // Bit i of b_j chooses ot j * k + i, so the choice bits are the k-bit values of b laid end to end.
+        choices_.assign(params_.ext_ot_sizes / (sizeof(block) * 8), _mm_setzero_si128());
+        std::uint8_t* bits = reinterpret_cast<std::uint8_t*>(choices_.data());
+        for (std::size_t j = 0; j < len; j++) {
+            memcpy(bits + j * k / 8, b + begin + j, k / 8);
+        }
+        ot_receiver_->receive_correlated(net, choices_, rows_);
+        block zero = _mm_setzero_si128();
+        std::uint64_t index = recv_index_;
+        corrections_.resize((len * packed_bits + 63) / 64);
+        recv_frame(net, corrections_.data(), corrections_.size() * sizeof(std::uint64_t));
+        std::size_t groups = (len + kPackGroup - 1) / kPackGroup;
+        parallel_for(pool_.get(), groups, [&](std::size_t first, std::size_t last) {
+            for (std::size_t j = first * kPackGroup; j < std::min(last * kPackGroup, len); j++) {
+                std::uint64_t bj = b[begin + j];
+                std::uint64_t sum = 0;
+                std::size_t pos = j * packed_bits;
+                std::array<std::uint64_t, kMaxBitLength> xb;
+                hash_words(rows_.data() + j * k, zero, index + j * k, k, xb.data());
+                for (std::size_t i = 0; i < k; i++) {
+                    std::size_t width = k - i;
+                    std::uint64_t d = get_bits(corrections_.data(), pos, width);
+                    std::uint64_t choice = 0 - ((bj >> i) & 1);
+                    sum += ((xb[i] - (d & choice)) & low_mask(width)) << i;
+                    pos += width;
+                }
+                share[begin + j] = sum;
+            }
+        });
+        recv_index_ += params_.ext_ot_sizes;
+    }
+}
+
+}  // namespace verse
+}  // namespace petace
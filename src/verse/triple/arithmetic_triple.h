@@ -0,0 +1,123 @@
+// Copyright 2023 TikTok Pte. Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "network/network.h"
+
+#include "verse/two-choose-one/iknp/iknp_ot_ext.h"
+#include "verse/util/defines.h"
+#include "verse/util/thread_pool.h"
+
+namespace petace {
+namespace verse {
+
+/*
+ * Beaver triples over Z_2^k from correlated ots (Gilboa multiplication).
+ * Each party samples a and b and computes its own product a * b. The two cross products a_0 * b_1 and a_1 * b_0 are
+ * secret-shared with one extension each, in opposite directions:
+ * 1. For bit i of its b, the receiver picks m_{b_i} of a random ot (m_0, m_1) of the sender.
+ * 2. The sender keeps x_i = m_0 mod 2^(k - i) and sends d_i = m_1 - m_0 - a mod 2^(k - i), so the receiver gets
+ *    y_i = m_{b_i} - b_i * d_i = x_i + b_i * a. Only the k - i low bits matter once scaled by 2^i, so each d_i is
+ *    packed into k - i bits, k * (k + 1) / 2 bits per triple.
+ * 3. The sender's share of a * b is -sum 2^i x_i and the receiver's share is sum 2^i y_i.
+ * The random ots are the low words of a fixed-key AES hash of correlated iknp rows, m_0 = H(j, q_j) and
+ * m_1 = H(j, q_j ^ delta), so no SHA-256 hashing or message expansion is needed.
+ */
+
+/**
+ * @brief Generates arithmetic Beaver triples over Z_2^32 or Z_2^64 on top of iknp ot extension.
+ *
+ * Both parties construct a generator with the same parameters, one of them as leader, and make matching calls.
+ */
+class ArithmeticTripleGenerator {
+public:
+    /**
+     * @brief Create a generator.
+     *
+     * @param[in] params The parameters of the extensions; base_ot_sizes must be 128 and ext_ot_sizes, the ots per
+     * extension call, a multiple of 128. num_threads also parallelizes packing.
+     * @param[in] bit_length k, either 32 or 64.
+     * @param[in] is_leader Whether the local party plays the leader; exactly one party must.
+     * @throws std::invalid_argument if bit_length, base_ot_sizes or ext_ot_sizes is not supported.
+     */
+    ArithmeticTripleGenerator(const VerseParams& params, std::size_t bit_length, bool is_leader);
+
+    /**
+     * @brief Run the base ots of both extensions.
+     *
+     * @param[in] net The network interface (e.g., PETAce-Network interface).
+     */
+    void setup(const std::shared_ptr<network::Network>& net);
+
+    /**
+     * @brief Generate shares of n triples with (a_0 + a_1) * (b_0 + b_1) = c_0 + c_1 mod 2^k.
+     *
+     * @param[in] net The network interface (e.g., PETAce-Network interface).
+     * @param[in] n The number of triples.
+     * @param[out] a The local shares of a, each below 2^k.
+     * @param[out] b The local shares of b, each below 2^k.
+     * @param[out] c The local shares of c, each below 2^k.
+     * @throws std::logic_error if setup has not been called.
+     */
+    void generate(const std::shared_ptr<network::Network>& net, std::size_t n, std::vector<std::uint64_t>& a,
+            std::vector<std::uint64_t>& b, std::vector<std::uint64_t>& c);
+
+    /**
+     * @brief Return k.
+     */
+    std::size_t bit_length() const {
+        return bit_length_;
+    }
+
+private:
+    // Secret-share a[i] * b_peer[i] for count triples as the ot sender; share[i] receives -sum 2^i x_i.
+    void multiply_as_sender(const std::shared_ptr<network::Network>& net, const std::uint64_t* a, std::size_t count,
+            std::uint64_t* share);
+
+    // Secret-share a_peer[i] * b[i] for count triples as the ot receiver; share[i] receives sum 2^i y_i.
+    void multiply_as_receiver(const std::shared_ptr<network::Network>& net, const std::uint64_t* b, std::size_t count,
+            std::uint64_t* share);
+
+    VerseParams params_{};
+
+    std::size_t bit_length_ = 64;
+
+    bool is_leader_ = false;
+
+    std::unique_ptr<IknpOtExtSender> ot_sender_ = nullptr;
+
+    std::unique_ptr<IknpOtExtReceiver> ot_receiver_ = nullptr;
+
+    std::unique_ptr<ThreadPool> pool_ = nullptr;
+
+    // Hash tweaks must not repeat under one delta, so each direction numbers its ots across calls.
+    std::uint64_t send_index_ = 0;
+
+    std::uint64_t recv_index_ = 0;
+
+    std::vector<block> rows_{};
+
+    std::vector<block> choices_{};
+
+    std::vector<std::uint64_t> corrections_{};
+};
+
+}  // namespace verse
+}  // namespace petace
@@ -0,0 +1,126 @@
+// Copyright 2023 TikTok Pte. Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "verse/triple/boolean_triple.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "solo/prng.h"
+
+#include "verse/two-choose-one/iknp/iknp_pair.h"
+#include "verse/util/aes.h"
+
+namespace petace {
+namespace verse {
+
+namespace {
+
+// Hash 64 rows per call, a whole word of triples.
+const std::size_t kWordBits = 64;
+
+// Return the low bits of tccr_hash(rows[j] ^ offset) with tweaks index + j for j < 64.
+inline std::uint64_t hash_bits(const block* rows, const block& offset, std::uint64_t index) {
+    block hashes[kWordBits];
+    tccr_hash(rows, offset, index, hashes, kWordBits);
+    std::uint64_t bits = 0;
+    for (std::size_t j = 0; j < kWordBits; j++) {
+        bits |= (static_cast<std::uint64_t>(_mm_cvtsi128_si64(hashes[j])) & 1) << j;
+    }
+    return bits;
+}
+
+}  // namespace
+
+BooleanTripleGenerator::BooleanTripleGenerator(const VerseParams& params, bool is_leader)
+        : params_(params), is_leader_(is_leader) {
+    if (params_.base_ot_sizes != sizeof(block) * 8) {
+        throw std::invalid_argument("OT base size is not supported.");
+    }
+    if (params_.ext_ot_sizes == 0 || params_.ext_ot_sizes % (sizeof(block) * 8) != 0) {
+        throw std::invalid_argument("OT extension size is not supported.");
+    }
+    if (params_.num_threads > 1) {
+        pool_.reset(new ThreadPool(params_.num_threads - 1));
+    }
+}
+
+void BooleanTripleGenerator::setup(const std::shared_ptr<network::Network>& net) {
+    setup_iknp_pair(net, params_, is_leader_, ot_sender_, ot_receiver_);
+    send_index_ = 0;
+    recv_index_ = 0;
+}
+
+void BooleanTripleGenerator::generate(const std::shared_ptr<network::Network>& net, std::size_t words,
+        std::uint64_t* a, std::uint64_t* b, std::uint64_t* c) {
+    if (ot_sender_ == nullptr) {
+        throw std::logic_error("triple generator is not set up.");
+    }
+    std::size_t batch = params_.ext_ot_sizes / kWordBits;
+    for (std::size_t begin = 0; begin < words; begin += batch) {
+        std::size_t len = std::min(batch, words - begin);
+        std::fill(c + begin, c + begin + len, 0);
+        if (is_leader_) {
+            run_sender(net, len, a + begin, c + begin);
+            run_receiver(net, len, b + begin, c + begin);
+        } else {
+            run_receiver(net, len, b + begin, c + begin);
+            run_sender(net, len, a + begin, c + begin);
+        }
+        // c already holds the cross terms; add the local product.
+        for (std::size_t w = begin; w < begin + len; w++) {
+            c[w] ^= a[w] & b[w];
+        }
+    }
+}
+
+void BooleanTripleGenerator::run_sender(
+        const std::shared_ptr<network::Network>& net, std::size_t words, std::uint64_t* a, std::uint64_t* c) {
+    ot_sender_->send_correlated(net, rows_);
+    block delta = ot_sender_->delta();
+    block zero = _mm_setzero_si128();
+    std::uint64_t index = send_index_;
+    parallel_for(pool_.get(), words, [&](std::size_t first, std::size_t last) {
+        for (std::size_t w = first; w < last; w++) {
+            const block* rows = rows_.data() + w * kWordBits;
+            std::uint64_t x0 = hash_bits(rows, zero, index + w * kWordBits);
+            std::uint64_t x1 = hash_bits(rows, delta, index + w * kWordBits);
+            a[w] = x0 ^ x1;
+            c[w] ^= x0;
+        }
+    });
+    send_index_ += params_.ext_ot_sizes;
+}
+
+void BooleanTripleGenerator::run_receiver(
+        const std::shared_ptr<network::Network>& net, std::size_t words, std::uint64_t* b, std::uint64_t* c) {
+    choices_.resize(params_.ext_ot_sizes / (sizeof(block) * 8));
+    solo::PRNG::get_random_byte_array(
+            choices_.size() * sizeof(block), reinterpret_cast<solo::Byte*>(choices_.data()));
+    ot_receiver_->receive_correlated(net, choices_, rows_);
+    // Choice bit j of the extension is bit j % 64 of word j / 64, so the choices are already packed.
+    const std::uint64_t* r = reinterpret_cast<const std::uint64_t*>(choices_.data());
+    block zero = _mm_setzero_si128();
+    std::uint64_t index = recv_index_;
+    parallel_for(pool_.get(), words, [&](std::size_t first, std::size_t last) {
+        for (std::size_t w = first; w < last; w++) {
+            b[w] = r[w];
+            c[w] ^= hash_bits(rows_.data() + w * kWordBits, zero, index + w * kWordBits);
+        }
+    });
+    recv_index_ += params_.ext_ot_sizes;
+}
+
+}  // namespace verse
+}  // namespace petace
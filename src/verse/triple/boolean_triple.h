@@ -0,0 +1,108 @@
+// Copyright 2023 TikTok Pte. Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "network/network.h"
+
+#include "verse/two-choose-one/iknp/iknp_ot_ext.h"
+#include "verse/util/defines.h"
+#include "verse/util/thread_pool.h"
+
+namespace petace {
+namespace verse {
+
+/*
+ * Boolean AND triples from two random ot extensions in opposite directions.
+ * The leader holds random ots (x_0, x_1) of which the follower learns x_{r_B}; the follower holds (y_0, y_1) of which
+ * the leader learns y_{r_A}. Setting a_A = x_0 ^ x_1, b_A = r_A, a_B = y_0 ^ y_1, b_B = r_B gives the cross terms
+ * a_A & b_B = x_0 ^ x_{r_B} and a_B & b_A = y_0 ^ y_{r_A}, so
+ *     c_A = (a_A & b_A) ^ x_0 ^ y_{r_A},    c_B = (a_B & b_B) ^ x_{r_B} ^ y_0.
+ * Each random ot bit is the low bit of a fixed-key AES hash of an iknp row, so only one bit per row is derived and
+ * the triples are computed 64 at a time on packed words.
+ */
+
+/**
+ * @brief Generates boolean AND triples on top of iknp ot extension, packed 64 per word.
+ *
+ * Both parties construct a generator with the same parameters, one of them as leader, and make matching calls.
+ */
+class BooleanTripleGenerator {
+public:
+    /**
+     * @brief Create a generator.
+     *
+     * @param[in] params The parameters of the extensions; base_ot_sizes must be 128 and ext_ot_sizes, the triples per
+     * extension call, a multiple of 128. num_threads also parallelizes hashing.
+     * @param[in] is_leader Whether the local party plays the leader; exactly one party must.
+     * @throws std::invalid_argument if base_ot_sizes or ext_ot_sizes is not supported.
+     */
+    BooleanTripleGenerator(const VerseParams& params, bool is_leader);
+
+    /**
+     * @brief Run the base ots of both extensions.
+     *
+     * @param[in] net The network interface (e.g., PETAce-Network interface).
+     */
+    void setup(const std::shared_ptr<network::Network>& net);
+
+    /**
+     * @brief Generate shares of 64 * words triples with (a_0 ^ a_1) & (b_0 ^ b_1) = c_0 ^ c_1 bitwise.
+     *
+     * @param[in] net The network interface (e.g., PETAce-Network interface).
+     * @param[in] words The number of 64-bit words of triples.
+     * @param[out] a The local shares of a; bit i of a[w] belongs to triple 64 * w + i.
+     * @param[out] b The local shares of b in the same layout.
+     * @param[out] c The local shares of c in the same layout.
+     * @throws std::logic_error if setup has not been called.
+     */
+    void generate(const std::shared_ptr<network::Network>& net, std::size_t words, std::uint64_t* a, std::uint64_t* b,
+            std::uint64_t* c);
+
+private:
+    // Run one extension as sender: a[w] = x_0 ^ x_1 and c[w] ^= x_0 for the words of this call.
+    void run_sender(const std::shared_ptr<network::Network>& net, std::size_t words, std::uint64_t* a,
+            std::uint64_t* c);
+
+    // Run one extension as receiver with random choices: b[w] = r and c[w] ^= x_r for the words of this call.
+    void run_receiver(const std::shared_ptr<network::Network>& net, std::size_t words, std::uint64_t* b,
+            std::uint64_t* c);
+
+    VerseParams params_{};
+
+    bool is_leader_ = false;
+
+    std::unique_ptr<IknpOtExtSender> ot_sender_ = nullptr;
+
+    std::unique_ptr<IknpOtExtReceiver> ot_receiver_ = nullptr;
+
+    std::unique_ptr<ThreadPool> pool_ = nullptr;
+
+    // Hash tweaks must not repeat under one delta, so each direction numbers its ots across calls.
+    std::uint64_t send_index_ = 0;
+
+    std::uint64_t recv_index_ = 0;
+
+    std::vector<block> rows_{};
+
+    std::vector<block> choices_{};
+};
+
+}  // namespace verse
+}  // namespace petace
@@ -0,0 +1,303 @@
+// Copyright 2023 TikTok Pte. Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "verse/tuning/auto_tuner.h"
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "solo/hash.h"
+#include "solo/prng.h"
+
+#include "verse/util/common.h"
+
+namespace petace {
+namespace verse {
+
+namespace {
+
+const std::uint32_t kTunedConfigVersion = 1;
+const std::size_t kPingRounds = 8;
+const std::size_t kBandwidthBytes = std::size_t(1) << 20;
+const std::size_t kMinChunkSize = std::size_t(1) << 10;
+const std::size_t kMaxChunkSize = std::size_t(1) << 16;
+const std::size_t kDefaultL2Bytes = std::size_t(1) << 20;
+
+double micros_since(const std::chrono::steady_clock::time_point& begin) {
+    std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - begin;
+    return elapsed.count();
+}
+
+double time_transpose() {
+    const std::size_t rounds = 64;
+    std::vector<block> in(128);
+    std::vector<block> out(128);
+    for (auto& value : in) {
+        value = read_block_from_dev_urandom();
+    }
+    auto begin = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < rounds; i++) {
+        matrix_transpose(in, 128, 128, out);
+        in[i % 128] = out[(i + 1) % 128];
+    }
+    return micros_since(begin) / rounds;
+}
+
+double time_hash() {
+    const std::size_t rounds = 4096;
+    auto hash = solo::Hash::create(solo::HashScheme::SHA_256);
+    block value = read_block_from_dev_urandom();
+    auto begin = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < rounds; i++) {
+        hash->compute(reinterpret_cast<solo::Byte*>(&value), sizeof(block), reinterpret_cast<solo::Byte*>(&value),
+                sizeof(block));
+    }
+    return micros_since(begin) / rounds;
+}
+
+double time_prg() {
+    solo::PRNGFactory prng_factory(solo::PRNGScheme::AES_ECB_CTR);
+    auto prng = prng_factory.create();
+    std::vector<solo::Byte> out(kBandwidthBytes);
+    auto begin = std::chrono::steady_clock::now();
+    prng->generate(out.size(), out.data());
+    double micros = std::max(micros_since(begin), 1.0);
+    return static_cast<double>(out.size()) * 1e6 / micros;
+}
+
+// The leader times ping-pongs and a bulk transfer, then shares the result with the follower.
+void measure_link(const std::shared_ptr<network::Network>& net, bool is_leader, CalibrationResult& result) {
+    std::uint8_t ping = 0;
+    std::vector<std::uint8_t> bulk(kBandwidthBytes);
+    double measured[2] = {0.0, 0.0};
+    if (is_leader) {
+        auto begin = std::chrono::steady_clock::now();
+        for (std::size_t i = 0; i < kPingRounds; i++) {
+            net->send_data(&ping, sizeof(ping));
+            net->recv_data(&ping, sizeof(ping));
+        }
+        measured[0] = micros_since(begin) / kPingRounds;
+
+        begin = std::chrono::steady_clock::now();
+        send_frame(net, bulk.data(), bulk.size());
+        net->recv_data(&ping, sizeof(ping));
+        double micros = std::max(micros_since(begin) - measured[0], 1.0);
+        measured[1] = static_cast<double>(bulk.size()) * 1e6 / micros;
+        net->send_data(measured, sizeof(measured));
+    } else {
+        for (std::size_t i = 0; i < kPingRounds; i++) {
+            net->recv_data(&ping, sizeof(ping));
+            net->send_data(&ping, sizeof(ping));
+        }
+        recv_frame(net, bulk.data(), bulk.size());
+        net->send_data(&ping, sizeof(ping));
+        net->recv_data(measured, sizeof(measured));
+    }
+    result.rtt_micros = measured[0];
+    result.link_bytes_per_second = measured[1];
+}
+
+std::size_t l2_cache_bytes() {
+#ifdef _SC_LEVEL2_CACHE_SIZE
+    long bytes = sysconf(_SC_LEVEL2_CACHE_SIZE);
+    if (bytes > 0) {
+        return static_cast<std::size_t>(bytes);
+    }
+#endif
+    return kDefaultL2Bytes;
+}
+
+std::size_t hardware_threads() {
+    return std::max<std::size_t>(1, std::thread::hardware_concurrency());
+}
+
+struct BaseOtPair {
+    OTScheme sender;
+    OTScheme receiver;
+};
+
+const BaseOtPair kBaseOtPairs[] = {{OTScheme::NaorPinkasSender, OTScheme::NaorPinkasReceiver},
+        {OTScheme::SimplestOtSender, OTScheme::SimplestOtReceiver},
+        {OTScheme::IknpBaseOtSender, OTScheme::IknpBaseOtReceiver}};
+
+void exchange(const std::shared_ptr<network::Network>& net, bool is_leader, void* local, void* remote,
+        std::size_t nbyte) {
+    if (is_leader) {
+        net->send_data(local, nbyte);
+        net->recv_data(remote, nbyte);
+    } else {
+        net->recv_data(remote, nbyte);
+        net->send_data(local, nbyte);
+    }
+}
+
+}  // namespace
+
+CalibrationResult calibrate(const std::shared_ptr<network::Network>& net, bool is_leader) {
+    CalibrationResult result;
+    result.transpose_micros = time_transpose();
+    result.hash_micros = time_hash();
+    result.prg_bytes_per_second = time_prg();
+    measure_link(net, is_leader, result);
+    return result;
+}
+
+TunedConfig tune(const CalibrationResult& calibration, const VerseParams& params) {
+    TunedConfig config;
+    config.calibration = calibration;
+
+    // Per-ot costs of the iknp sender: 1/128 of a transpose, two hashes and 32 bytes of PRG output.
+    double compute_micros = calibration.transpose_micros / 128.0 + 2.0 * calibration.hash_micros;
+    if (calibration.prg_bytes_per_second > 0.0) {
+        compute_micros += 2.0 * sizeof(block) * 1e6 / calibration.prg_bytes_per_second;
+    }
+    double link_micros = 0.0;
+    if (calibration.link_bytes_per_second > 0.0) {
+        link_micros = sizeof(block) * 1e6 / calibration.link_bytes_per_second;
+    }
+    std::size_t wanted = link_micros > 0.0 ? static_cast<std::size_t>(std::ceil(compute_micros / link_micros))
+                                           : hardware_threads();
+    config.num_threads = std::max<std::size_t>(1, std::min(wanted, hardware_threads()));
+
+    std::size_t chunk = l2_cache_bytes() / (3 * sizeof(block));
+    std::size_t power = kMinChunkSize;
+    while (power * 2 <= chunk && power * 2 <= kMaxChunkSize) {
+        power *= 2;
+    }
+    config.chunk_size = power;
+
+    auto& sender_factory = VerseFactory<BaseOtSender>::get_instance();
+    double best_micros = -1.0;
+    for (const auto& pair : kBaseOtPairs) {
+        const SchemeDescriptor* descriptor = nullptr;
+        try {
+            descriptor = &sender_factory.describe(pair.sender);
+        } catch (const std::invalid_argument&) {
+            continue;
+        }
+        if (params.base_ot_sizes == 0 || params.base_ot_sizes % descriptor->base_ot_multiple != 0) {
+            continue;
+        }
+        double micros = descriptor->estimate_micros(params.base_ot_sizes);
+        if (calibration.link_bytes_per_second > 0.0) {
+            micros += descriptor->bytes_per_ot * static_cast<double>(params.base_ot_sizes) * 1e6 /
+                      calibration.link_bytes_per_second;
+        }
+        if (best_micros < 0.0 || micros < best_micros) {
+            best_micros = micros;
+            config.base_ot_sender = pair.sender;
+            config.base_ot_receiver = pair.receiver;
+        }
+    }
+    return config;
+}
+
+bool load_tuned_config(const std::string& path, const VerseParams& params, TunedConfig& config) {
+    std::ifstream in(path);
+    if (!in) {
+        return false;
+    }
+    std::map<std::string, double> values;
+    std::string key;
+    double value = 0.0;
+    while (in >> key >> value) {
+        values[key] = value;
+    }
+    const char* keys[] = {"version", "base_ot_sizes", "hardware_threads", "num_threads", "chunk_size",
+            "base_ot_sender", "base_ot_receiver", "transpose_micros", "hash_micros", "prg_bytes_per_second",
+            "rtt_micros", "link_bytes_per_second"};
+    for (auto name : keys) {
+        if (values.find(name) == values.end()) {
+            return false;
+        }
+    }
+    if (values["version"] != kTunedConfigVersion || values["base_ot_sizes"] != params.base_ot_sizes ||
+            values["hardware_threads"] != hardware_threads() || values["num_threads"] < 1) {
+        return false;
+    }
+    config.num_threads = static_cast<std::size_t>(values["num_threads"]);
+    config.chunk_size = static_cast<std::size_t>(values["chunk_size"]);
+    config.base_ot_sender = static_cast<OTScheme>(static_cast<std::uint32_t>(values["base_ot_sender"]));
+    config.base_ot_receiver = static_cast<OTScheme>(static_cast<std::uint32_t>(values["base_ot_receiver"]));
+    config.calibration.transpose_micros = values["transpose_micros"];
+    config.calibration.hash_micros = values["hash_micros"];
+    config.calibration.prg_bytes_per_second = values["prg_bytes_per_second"];
+    config.calibration.rtt_micros = values["rtt_micros"];
+    config.calibration.link_bytes_per_second = values["link_bytes_per_second"];
+    return true;
+}
+
+bool save_tuned_config(const std::string& path, const VerseParams& params, const TunedConfig& config) {
+    std::ofstream out(path, std::ios::trunc);
+    if (!out) {
+        return false;
+    }
+    out.precision(17);
+    out << "version " << kTunedConfigVersion << "\n";
+    out << "base_ot_sizes " << params.base_ot_sizes << "\n";
+    out << "hardware_threads " << hardware_threads() << "\n";
+    out << "num_threads " << config.num_threads << "\n";
+    out << "chunk_size " << config.chunk_size << "\n";
+    out << "base_ot_sender " << static_cast<std::uint32_t>(config.base_ot_sender) << "\n";
+    out << "base_ot_receiver " << static_cast<std::uint32_t>(config.base_ot_receiver) << "\n";
+    out << "transpose_micros " << config.calibration.transpose_micros << "\n";
+    out << "hash_micros " << config.calibration.hash_micros << "\n";
+    out << "prg_bytes_per_second " << config.calibration.prg_bytes_per_second << "\n";
+    out << "rtt_micros " << config.calibration.rtt_micros << "\n";
+    out << "link_bytes_per_second " << config.calibration.link_bytes_per_second << "\n";
+    return static_cast<bool>(out);
+}
+
+TunedConfig auto_tune(const VerseParams& params, bool is_leader, const std::string& cache_path) {
+    if (params.net == nullptr) {
+        throw std::invalid_argument("network is not set.");
+    }
+    TunedConfig config;
+    std::uint8_t need_calibration = 1;
+    if (!cache_path.empty() && load_tuned_config(cache_path, params, config)) {
+        need_calibration = 0;
+    }
+    std::uint8_t peer_needs_calibration = 1;
+    exchange(params.net, is_leader, &need_calibration, &peer_needs_calibration, sizeof(need_calibration));
+    if (need_calibration || peer_needs_calibration) {
+        config = tune(calibrate(params.net, is_leader), params);
+    }
+
+    // The leader's shared settings win, so both parties stream and set up identically.
+    std::uint64_t shared[3] = {config.chunk_size, static_cast<std::uint64_t>(config.base_ot_sender),
+            static_cast<std::uint64_t>(config.base_ot_receiver)};
+    std::uint64_t peer_shared[3] = {0, 0, 0};
+    exchange(params.net, is_leader, shared, peer_shared, sizeof(shared));
+    if (!is_leader) {
+        config.chunk_size = static_cast<std::size_t>(peer_shared[0]);
+        config.base_ot_sender = static_cast<OTScheme>(peer_shared[1]);
+        config.base_ot_receiver = static_cast<OTScheme>(peer_shared[2]);
+    }
+    if (!cache_path.empty()) {
+        save_tuned_config(cache_path, params, config);
+    }
+    return config;
+}
+
+}  // namespace verse
+}  // namespace petace
@@ -0,0 +1,127 @@
+// Copyright 2023 TikTok Pte. Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+#include "network/network.h"
+
+#include "verse/util/defines.h"
+#include "verse/verse_factory.h"
+
+namespace petace {
+namespace verse {
+
+/**
+ * @brief Measurements of one calibration run.
+ */
+struct CalibrationResult {
+    // Microseconds to transpose one 128x128 bit matrix.
+    double transpose_micros = 0.0;
+    // Microseconds to hash one block with SHA-256.
+    double hash_micros = 0.0;
+    // PRNG output bytes per second.
+    double prg_bytes_per_second = 0.0;
+    // Round-trip time of a one-byte message.
+    double rtt_micros = 0.0;
+    // One-way link bandwidth.
+    double link_bytes_per_second = 0.0;
+};
+
+/**
+ * @brief A tuned configuration of the extension engines.
+ *
+ * chunk_size and the base ot schemes are shared by both parties; num_threads is local to each host.
+ */
+struct TunedConfig {
+    std::size_t num_threads = 1;
+    std::size_t chunk_size = 0;
+    OTScheme base_ot_sender = OTScheme::NaorPinkasSender;
+    OTScheme base_ot_receiver = OTScheme::NaorPinkasReceiver;
+    CalibrationResult calibration{};
+
+    /**
+     * @brief Feed the configuration into the parameters of an extension.
+     *
+     * @param[in,out] params The parameters; num_threads and chunk_size are overwritten.
+     */
+    void apply(VerseParams& params) const {
+        params.num_threads = num_threads;
+        params.chunk_size = chunk_size;
+    }
+};
+
+/**
+ * @brief Run short benchmarks of the transpose, hash and PRG kernels and measure the link to the peer.
+ *
+ * Both parties must call it at the same time. The leader drives the link measurement and shares the result.
+ *
+ * @param[in] net The network interface (e.g., PETAce-Network interface).
+ * @param[in] is_leader Whether the local party drives the measurement; exactly one party must be the leader.
+ * @return The measurements.
+ */
+CalibrationResult calibrate(const std::shared_ptr<network::Network>& net, bool is_leader);
+
+/**
+ * @brief Derive a configuration for the local host from a calibration.
+ *
+ * The thread count grows while the kernels are slower than the link, up to the number of cores. A chunk of the
+ * iknp receiver (three 128-bit rows per ot) is sized to fit the L2 cache. The base ot scheme minimizes the
+ * factory's cost estimate plus the measured transfer time for params.base_ot_sizes ots.
+ *
+ * @param[in] calibration The calibration.
+ * @param[in] params Parameters of the extension.
+ * @return The configuration.
+ */
+TunedConfig tune(const CalibrationResult& calibration, const VerseParams& params);
+
+/**
+ * @brief Read a configuration cached by save_tuned_config.
+ *
+ * @param[in] path The file path.
+ * @param[in] params Parameters of the extension; a cache tuned for other base ot sizes or cores is ignored.
+ * @param[out] config The configuration.
+ * @return Whether a valid configuration was read.
+ */
+bool load_tuned_config(const std::string& path, const VerseParams& params, TunedConfig& config);
+
+/**
+ * @brief Cache a configuration on disk.
+ *
+ * @param[in] path The file path.
+ * @param[in] params Parameters of the extension.
+ * @param[in] config The configuration.
+ * @return Whether the file was written.
+ */
+bool save_tuned_config(const std::string& path, const VerseParams& params, const TunedConfig& config);
+
+/**
+ * @brief Load the cached configuration or calibrate, then agree with the peer on the shared settings.
+ *
+ * If either party has no valid cache, both calibrate. The leader's chunk size and base ot schemes are adopted by
+ * both parties, and the result is cached at cache_path.
+ *
+ * @param[in] params Parameters of the extension; params.net is the connection to the peer.
+ * @param[in] is_leader Whether the local party leads; exactly one party must be the leader.
+ * @param[in] cache_path The cache file; empty disables caching.
+ * @return The configuration.
+ * @throws std::invalid_argument if params.net is null.
+ */
+TunedConfig auto_tune(const VerseParams& params, bool is_leader, const std::string& cache_path);
+
+}  // namespace verse
+}  // namespace petace
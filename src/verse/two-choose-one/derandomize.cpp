@@ -0,0 +1,200 @@
+// Copyright 2023 TikTok Pte. Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "verse/two-choose-one/derandomize.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+
+#include "verse/util/aes.h"
+#include "verse/util/common.h"
+
+namespace petace {
+namespace verse {
+
+namespace {
+
+// Number of ots whose long messages are stretched, masked and sent together.
+const std::size_t kDerandomizeChunk = 1024;
+
+inline std::uint8_t correction_bit(const std::vector<std::uint8_t>& corrections, std::size_t i) {
+    return static_cast<std::uint8_t>((corrections[i / 8] >> (i % 8)) & 1);
+}
+
+// y0 = m0 ^ k_d and y1 = m1 ^ k_{1 - d}, where mask is all ones iff d = 1.
+void mask_pair(const std::uint8_t* m0, const std::uint8_t* m1, const std::uint8_t* k0, const std::uint8_t* k1,
+        std::uint8_t mask, std::uint8_t* y0, std::uint8_t* y1, std::size_t len) {
+    block vmask = _mm_set1_epi8(static_cast<char>(mask));
+    std::size_t j = 0;
+    for (; j + sizeof(block) <= len; j += sizeof(block)) {
+        block vk0 = _mm_loadu_si128(reinterpret_cast<const block*>(k0 + j));
+        block vk1 = _mm_loadu_si128(reinterpret_cast<const block*>(k1 + j));
+        block diff = _mm_and_si128(_mm_xor_si128(vk0, vk1), vmask);
+        block vm0 = _mm_loadu_si128(reinterpret_cast<const block*>(m0 + j));
+        block vm1 = _mm_loadu_si128(reinterpret_cast<const block*>(m1 + j));
+        _mm_storeu_si128(reinterpret_cast<block*>(y0 + j), _mm_xor_si128(vm0, _mm_xor_si128(vk0, diff)));
+        _mm_storeu_si128(reinterpret_cast<block*>(y1 + j), _mm_xor_si128(vm1, _mm_xor_si128(vk1, diff)));
+    }
+    for (; j < len; j++) {
+        std::uint8_t diff = static_cast<std::uint8_t>((k0[j] ^ k1[j]) & mask);
+        y0[j] = static_cast<std::uint8_t>(m0[j] ^ k0[j] ^ diff);
+        y1[j] = static_cast<std::uint8_t>(m1[j] ^ k1[j] ^ diff);
+    }
+}
+
+// out = y_c ^ k, where mask is all ones iff c = 1.
+void unmask_chosen(const std::uint8_t* y0, const std::uint8_t* y1, const std::uint8_t* k, std::uint8_t mask,
+        std::uint8_t* out, std::size_t len) {
+    block vmask = _mm_set1_epi8(static_cast<char>(mask));
+    std::size_t j = 0;
+    for (; j + sizeof(block) <= len; j += sizeof(block)) {
+        block vy0 = _mm_loadu_si128(reinterpret_cast<const block*>(y0 + j));
+        block vy1 = _mm_loadu_si128(reinterpret_cast<const block*>(y1 + j));
+        block vk = _mm_loadu_si128(reinterpret_cast<const block*>(k + j));
+        block chosen = _mm_xor_si128(vy0, _mm_and_si128(_mm_xor_si128(vy0, vy1), vmask));
+        _mm_storeu_si128(reinterpret_cast<block*>(out + j), _mm_xor_si128(chosen, vk));
+    }
+    for (; j < len; j++) {
+        std::uint8_t chosen = static_cast<std::uint8_t>(y0[j] ^ ((y0[j] ^ y1[j]) & mask));
+        out[j] = static_cast<std::uint8_t>(chosen ^ k[j]);
+    }
+}
+
+void send_corrections(const std::shared_ptr<network::Network>& net, const std::vector<block>& random_choices,
+        const std::vector<block>& choices, std::size_t n) {
+    std::size_t nblock = (n + sizeof(block) * 8 - 1) / (sizeof(block) * 8);
+    if (random_choices.size() < nblock || choices.size() < nblock) {
+        throw std::invalid_argument("choices are fewer than ots.");
+    }
+    std::vector<block> corrections(nblock);
+    for (std::size_t i = 0; i < nblock; i++) {
+        corrections[i] = _mm_xor_si128(random_choices[i], choices[i]);
+    }
+    send_frame(net, corrections.data(), (n + 7) / 8);
+}
+
+std::vector<std::uint8_t> recv_corrections(const std::shared_ptr<network::Network>& net, std::size_t n) {
+    std::vector<std::uint8_t> corrections((n + 7) / 8);
+    recv_frame(net, corrections.data(), corrections.size());
+    return corrections;
+}
+
+}  // namespace
+
+void send_chosen_messages(const std::shared_ptr<network::Network>& net,
+        const std::vector<std::array<block, 2>>& random_ots, const std::vector<std::array<block, 2>>& inputs) {
+    std::size_t n = random_ots.size();
+    if (inputs.size() != n) {
+        throw std::invalid_argument("chosen messages do not match random ots.");
+    }
+    // Both sides return before any traffic when there is nothing to transfer.
+    if (n == 0) {
+        return;
+    }
+    auto corrections = recv_corrections(net, n);
+
+    std::vector<std::array<block, 2>> masked(n);
+    for (std::size_t i = 0; i < n; i++) {
+        block mask = _mm_set1_epi64x(-static_cast<std::int64_t>(correction_bit(corrections, i)));
+        block diff = _mm_and_si128(_mm_xor_si128(random_ots[i][0], random_ots[i][1]), mask);
+        masked[i][0] = _mm_xor_si128(inputs[i][0], _mm_xor_si128(random_ots[i][0], diff));
+        masked[i][1] = _mm_xor_si128(inputs[i][1], _mm_xor_si128(random_ots[i][1], diff));
+    }
+    send_block(net, masked.data()->data(), 2 * n);
+}
+
+void send_chosen_messages(const std::shared_ptr<network::Network>& net,
+        const std::vector<std::array<block, 2>>& random_ots, const std::vector<solo::Byte>& inputs,
+        std::size_t msg_len) {
+    std::size_t n = random_ots.size();
+    if (msg_len == 0 || inputs.size() != 2 * n * msg_len) {
+        throw std::invalid_argument("chosen messages do not match random ots.");
+    }
+    if (n == 0) {
+        return;
+    }
+    auto corrections = recv_corrections(net, n);
+
+    std::size_t chunk = std::min(n, kDerandomizeChunk);
+    std::vector<solo::Byte> pads(2 * chunk * msg_len);
+    std::vector<solo::Byte> masked(2 * chunk * msg_len);
+    const std::uint8_t* in = reinterpret_cast<const std::uint8_t*>(inputs.data());
+    const std::uint8_t* k = reinterpret_cast<const std::uint8_t*>(pads.data());
+    std::uint8_t* y = reinterpret_cast<std::uint8_t*>(masked.data());
+    for (std::size_t begin = 0; begin < n; begin += chunk) {
+        std::size_t len = std::min(chunk, n - begin);
+        prg_stretch(&random_ots[begin][0], 2 * len, msg_len, pads.data());
+        for (std::size_t i = 0; i < len; i++) {
+            std::uint8_t mask = static_cast<std::uint8_t>(0 - correction_bit(corrections, begin + i));
+            const std::uint8_t* m = in + 2 * (begin + i) * msg_len;
+            mask_pair(m, m + msg_len, k + 2 * i * msg_len, k + (2 * i + 1) * msg_len, mask, y + 2 * i * msg_len,
+                    y + (2 * i + 1) * msg_len, msg_len);
+        }
+        send_frame(net, masked.data(), 2 * len * msg_len);
+    }
+}
+
+void receive_chosen_messages(const std::shared_ptr<network::Network>& net, const std::vector<block>& random_choices,
+        const std::vector<block>& random_messages, const std::vector<block>& choices, std::vector<block>& messages) {
+    std::size_t n = random_messages.size();
+    if (n == 0) {
+        messages.clear();
+        return;
+    }
+    send_corrections(net, random_choices, choices, n);
+
+    std::vector<std::array<block, 2>> masked(n);
+    recv_block(net, masked.data()->data(), 2 * n);
+    messages.resize(n);
+    for (std::size_t i = 0; i < n; i++) {
+        block mask = _mm_set1_epi64x(-static_cast<std::int64_t>(bit_from_blocks(choices, i)));
+        block chosen = _mm_xor_si128(masked[i][0], _mm_and_si128(_mm_xor_si128(masked[i][0], masked[i][1]), mask));
+        messages[i] = _mm_xor_si128(chosen, random_messages[i]);
+    }
+}
+
+void receive_chosen_messages(const std::shared_ptr<network::Network>& net, const std::vector<block>& random_choices,
+        const std::vector<block>& random_messages, const std::vector<block>& choices,
+        std::vector<solo::Byte>& messages, std::size_t msg_len) {
+    std::size_t n = random_messages.size();
+    if (msg_len == 0) {
+        throw std::invalid_argument("message length is not supported.");
+    }
+    if (n == 0) {
+        messages.clear();
+        return;
+    }
+    send_corrections(net, random_choices, choices, n);
+
+    std::size_t chunk = std::min(n, kDerandomizeChunk);
+    std::vector<solo::Byte> masked(2 * chunk * msg_len);
+    messages.resize(n * msg_len);
+    const std::uint8_t* y = reinterpret_cast<const std::uint8_t*>(masked.data());
+    std::uint8_t* out = reinterpret_cast<std::uint8_t*>(messages.data());
+    for (std::size_t begin = 0; begin < n; begin += chunk) {
+        std::size_t len = std::min(chunk, n - begin);
+        // Stretch the random messages in place; they are the pads x_r.
+        prg_stretch(random_messages.data() + begin, len, msg_len, messages.data() + begin * msg_len);
+        recv_frame(net, masked.data(), 2 * len * msg_len);
+        for (std::size_t i = 0; i < len; i++) {
+            std::uint8_t mask = static_cast<std::uint8_t>(0 - bit_from_blocks(choices, begin + i));
+            std::uint8_t* m = out + (begin + i) * msg_len;
+            unmask_chosen(y + 2 * i * msg_len, y + (2 * i + 1) * msg_len, m, mask, m, msg_len);
+        }
+    }
+}
+
+}  // namespace verse
+}  // namespace petace
@@ -0,0 +1,91 @@
+// Copyright 2023 TikTok Pte. Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <array>
+#include <memory>
+#include <vector>
+
+#include "network/network.h"
+#include "solo/prng.h"
+
+#include "verse/util/defines.h"
+
+namespace petace {
+namespace verse {
+
+/*
+ * Beaver's derandomization turns n random ots into n chosen-input ots.
+ * The sender holds random pairs (x0, x1); the receiver holds random choices r and x_r.
+ * 1. The receiver sends the packed correction bits d = c ^ r for its real choices c.
+ * 2. The sender sends y_b = m_b ^ x_{b ^ d} for both of its real messages.
+ * 3. The receiver outputs y_c ^ x_r = m_c.
+ * Long messages use the random ots as PRG seeds, so x_b above is the stretched seed.
+ */
+
+/**
+ * @brief The sender transfers chosen messages by derandomizing random ots.
+ *
+ * @param[in] net The network interface (e.g., PETAce-Network interface).
+ * @param[in] random_ots The random ots (x0, x1) of the sender.
+ * @param[in] inputs The chosen messages (m0, m1); one pair per random ot.
+ * @throws std::invalid_argument if the sizes do not match.
+ */
+void send_chosen_messages(const std::shared_ptr<network::Network>& net,
+        const std::vector<std::array<block, 2>>& random_ots, const std::vector<std::array<block, 2>>& inputs);
+
+/**
+ * @brief The sender transfers chosen messages of msg_len bytes by derandomizing random ots.
+ *
+ * @param[in] net The network interface (e.g., PETAce-Network interface).
+ * @param[in] random_ots The random ots (x0, x1) of the sender.
+ * @param[in] inputs The chosen messages; m_b of ot i starts at byte (2 * i + b) * msg_len.
+ * @param[in] msg_len The byte length of each message.
+ * @throws std::invalid_argument if the sizes do not match.
+ */
+void send_chosen_messages(const std::shared_ptr<network::Network>& net,
+        const std::vector<std::array<block, 2>>& random_ots, const std::vector<solo::Byte>& inputs,
+        std::size_t msg_len);
+
+/**
+ * @brief The receiver gets chosen messages by derandomizing random ots.
+ *
+ * @param[in] net The network interface (e.g., PETAce-Network interface).
+ * @param[in] random_choices The random choice bits r of the random ots.
+ * @param[in] random_messages The random messages x_r.
+ * @param[in] choices The real chosen bits c.
+ * @param[out] messages The chosen messages m_c.
+ * @throws std::invalid_argument if the sizes do not match.
+ */
+void receive_chosen_messages(const std::shared_ptr<network::Network>& net, const std::vector<block>& random_choices,
+        const std::vector<block>& random_messages, const std::vector<block>& choices, std::vector<block>& messages);
+
+/**
+ * @brief The receiver gets chosen messages of msg_len bytes by derandomizing random ots.
+ *
+ * @param[in] net The network interface (e.g., PETAce-Network interface).
+ * @param[in] random_choices The random choice bits r of the random ots.
+ * @param[in] random_messages The random messages x_r.
+ * @param[in] choices The real chosen bits c.
+ * @param[out] messages The chosen messages; m_c of ot i starts at byte i * msg_len.
+ * @param[in] msg_len The byte length of each message.
+ * @throws std::invalid_argument if the sizes do not match.
+ */
+void receive_chosen_messages(const std::shared_ptr<network::Network>& net, const std::vector<block>& random_choices,
+        const std::vector<block>& random_messages, const std::vector<block>& choices,
+        std::vector<solo::Byte>& messages, std::size_t msg_len);
+
+}  // namespace verse
+}  // namespace petace
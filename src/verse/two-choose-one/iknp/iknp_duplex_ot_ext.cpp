@@ -0,0 +1,58 @@
+// Copyright 2023 TikTok Pte. Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "verse/two-choose-one/iknp/iknp_duplex_ot_ext.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace petace {
+namespace verse {
+
+void IknpDuplexOtExt::set_base_ots(const std::vector<block>& choices, const std::vector<block>& base_recv_ots,
+        const std::vector<std::array<block, 2>>& base_send_ots) {
+    sender_.set_base_ots(choices, base_recv_ots);
+    receiver_.set_base_ots(base_send_ots);
+}
+
+void IknpDuplexOtExt::extend(const std::shared_ptr<network::Network>& net,
+        std::vector<std::array<block, 2>>& send_messages, const std::vector<block>& choices,
+        std::vector<block>& recv_messages) {
+    // Check everything up front: a role that fails after its peer has started would leave the peer blocked.
+    if (base_ot_sizes_ != 128) {
+        throw std::invalid_argument("IKNP is only supported by 128-bit base-OT.");
+    }
+    if (ext_ot_sizes_ % (sizeof(block) * 8) != 0) {
+        throw std::invalid_argument("OT extension size is not supported.");
+    }
+    if (choices.size() * sizeof(block) * 8 < ext_ot_sizes_) {
+        throw std::invalid_argument("choices do not cover the extended ots.");
+    }
+
+    std::size_t cols = ext_ot_sizes_ / (sizeof(block) * 8);
+    std::size_t chunk = sender_.prepare(chunk_size_);
+    receiver_.prepare(chunk_size_);
+    send_messages.resize(ext_ot_sizes_);
+    recv_messages.resize(ext_ot_sizes_);
+    // The local receiver's chunk is on the wire while the peer's chunk for the local sender is read and both are hashed.
+    for (std::size_t begin = 0; begin < cols; begin += chunk) {
+        std::size_t len = std::min(chunk, cols - begin);
+        receiver_.send_chunk(net, choices, begin, len);
+        sender_.send_chunk(net, begin, len, send_messages);
+        receiver_.receive_chunk(begin, len, recv_messages);
+    }
+}
+
+}  // namespace verse
+}  // namespace petace
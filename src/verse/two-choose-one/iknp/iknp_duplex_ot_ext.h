@@ -0,0 +1,116 @@
+// Copyright 2023 TikTok Pte. Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <vector>
+
+#include "network/network.h"
+
+#include "verse/two-choose-one/iknp/iknp_ot_ext.h"
+#include "verse/util/defines.h"
+
+namespace petace {
+namespace verse {
+
+// Ots per interleaved chunk of the duplex extension: a 64 KB matrix, small enough for the socket buffers to hold.
+const std::size_t kDuplexChunkOts = 4096;
+
+/**
+ * @brief Runs an iknp sender and an iknp receiver over one connection at the same time.
+ *
+ * In iknp the receiver only sends and the sender only receives. The local receiver's matrix therefore has the
+ * outgoing direction of the link to itself, and the peer's matrix for the local sender has the incoming direction.
+ * Both roles run chunk by chunk on the calling thread: each party sends a chunk of its receiver's matrix, then reads
+ * the peer's chunk for its sender and hashes both while the next chunks are in flight. Both directions therefore carry
+ * data at once instead of idling in turn, without using the network from two threads. Both parties construct an
+ * instance with the same parameters and call extend together.
+ *
+ * @par Example.
+ * Refer to iknp_ot_test.cpp.
+ */
+class IknpDuplexOtExt {
+public:
+    /**
+     * @brief Create a duplex extension.
+     *
+     * @param[in] base_ot_sizes The number of base ots of each role; must be 128.
+     * @param[in] ext_ot_sizes The number of ots per role and extend call; a multiple of 128.
+     * @param[in] num_threads The threads each role uses to transpose and hash.
+     * @param[in] chunk_size The ots per interleaved chunk, at most kDuplexChunkOts; 0 uses kDuplexChunkOts. Must match
+     * the peer.
+     * @param[in] allocator The memory of the work buffers, which are kept across calls; null uses the default.
+     * @param[in] numa_node The NUMA node the worker threads are bound to; -1 leaves them unbound. The calling thread
+     * is never rebound.
+     */
+    IknpDuplexOtExt(std::size_t base_ot_sizes, std::size_t ext_ot_sizes, std::size_t num_threads = 1,
+            std::size_t chunk_size = 0, const std::shared_ptr<BufferAllocator>& allocator = nullptr,
+            int numa_node = -1)
+            : base_ot_sizes_(base_ot_sizes),
+              ext_ot_sizes_(ext_ot_sizes),
+              chunk_size_(chunk_size == 0 ? kDuplexChunkOts : std::min(chunk_size, kDuplexChunkOts)),
+              sender_(base_ot_sizes, ext_ot_sizes, num_threads, chunk_size_, allocator, numa_node),
+              receiver_(base_ot_sizes, ext_ot_sizes, num_threads, chunk_size_, allocator, numa_node) {
+    }
+
+    /**
+     * @brief Set the base ots of both roles.
+     *
+     * @param[in] choices The chosen bits of the base ots received for the local sender.
+     * @param[in] base_recv_ots The base ots received for the local sender.
+     * @param[in] base_send_ots The base ots sent for the local receiver.
+     */
+    void set_base_ots(const std::vector<block>& choices, const std::vector<block>& base_recv_ots,
+            const std::vector<std::array<block, 2>>& base_send_ots);
+
+    /**
+     * @brief Extend ots in both directions; the peer's receiver learns from send_messages and its sender from the
+     * local choices.
+     *
+     * Each party sends a chunk before it reads one, so the socket buffers of the link must hold one chunk in each
+     * direction; kDuplexChunkOts keeps that within the default buffers of TCP.
+     *
+     * @param[in] net The network interface (e.g., PETAce-Network interface).
+     * @param[out] send_messages The random messages of the local sender.
+     * @param[in] choices The chosen bits of the local receiver.
+     * @param[out] recv_messages The chosen messages of the local receiver.
+     * @throws std::invalid_argument if the sizes are not supported or choices hold fewer bits than ext_ot_sizes.
+     */
+    void extend(const std::shared_ptr<network::Network>& net, std::vector<std::array<block, 2>>& send_messages,
+            const std::vector<block>& choices, std::vector<block>& recv_messages);
+
+    /**
+     * @brief Return the global correlation of the local sender; valid after set_base_ots.
+     */
+    block delta() const {
+        return sender_.delta();
+    }
+
+private:
+    std::size_t base_ot_sizes_ = 0;
+
+    std::size_t ext_ot_sizes_ = 0;
+
+    std::size_t chunk_size_ = 0;
+
+    IknpOtExtSender sender_;
+
+    IknpOtExtReceiver receiver_;
+};
+
+}  // namespace verse
+}  // namespace petace
@@ -14,7 +14,7 @@
 
 #include "verse/two-choose-one/iknp/iknp_ot_ext.h"
 
-#include <cstring>
+#include <algorithm>
 #include <stdexcept>
 
 #include "verse/util/common.h"
@@ -22,18 +22,58 @@
 namespace petace {
 namespace verse {
 
+namespace {
+
+// Number of 128-ot columns per streamed chunk.
+std::size_t chunk_columns(std::size_t chunk_size, std::size_t cols) {
+    std::size_t chunk = chunk_size / (sizeof(block) * 8);
+    return chunk_size == 0 || chunk >= cols ? cols : std::max<std::size_t>(chunk, 1);
+}
+
+// Columns per fused tile. A tile of 128 rows holds one AES batch per stream (16 KB), so it stays in L1 from expansion
+// to hashing.
+constexpr std::size_t kTileColumns = 8;
+
+// Process a rows x len chunk one tile of columns at a time: expand the tile from prg at the tile's counter, let
+// mix(tile, column, width) combine it with the peer's matrix, then transpose every column of the tile and hand the
+// rows x rows result of column c to emit(hash, c, output). Tiles are spread over the pool; each range of tiles works in
+// its own slice of scratch, and the shared counter is left untouched.
+template <class Mix, class Emit>
+void fused_tiles(ThreadPool* pool, const MultiKeyPrg& prg, std::uint64_t counter, std::size_t rows, std::size_t len,
+        Buffer<block>& scratch, const Mix& mix, const Emit& emit) {
+    std::size_t tiles = (len + kTileColumns - 1) / kTileColumns;
+    std::size_t slice = prg.size() * kTileColumns + 2 * rows;
+    scratch.resize(parallel_parts(pool) * slice);
+    parallel_for_parts(pool, tiles, [&](std::size_t part, std::size_t first, std::size_t last) {
+        solo::Hash& hash = thread_sha256();
+        block* tile = scratch.data() + part * slice;
+        block* input = tile + prg.size() * kTileColumns;
+        block* output = input + rows;
+        for (std::size_t t = first; t < last; t++) {
+            std::size_t column = t * kTileColumns;
+            std::size_t width = std::min(kTileColumns, len - column);
+            prg.generate_at(counter + column, width, tile, width);
+            mix(tile, column, width);
+            for (std::size_t c = 0; c < width; c++) {
+                for (std::size_t j = 0; j < rows; j++) {
+                    input[j] = tile[j * width + c];
+                }
+                matrix_transpose(input, rows, rows, output);
+                emit(hash, column + c, output);
+            }
+        }
+    });
+}
+
+}  // namespace
+
 void IknpOtExtSender::set_base_ots(const std::vector<block>& choices, const std::vector<block>& base_recv_ots) {
-    solo::PRNGFactory prng_factory(solo::PRNGScheme::AES_ECB_CTR);
-    for (std::size_t i = 0; i < base_recv_ots.size(); i++) {
-        std::vector<solo::Byte> seed(sizeof(block));
-        memcpy(seed.data(), reinterpret_cast<solo::Byte*>(const_cast<block*>(base_recv_ots.data() + i)), sizeof(block));
-        prng_.emplace_back(prng_factory.create(seed));
-    }
-    base_choices_.insert(base_choices_.begin(), choices.begin(), choices.end());
+    prg_.reset(base_recv_ots.data(), base_recv_ots.size());
+    base_choices_.assign(choices.begin(), choices.end());
     return;
 }
 
-void IknpOtExtSender::send(const std::shared_ptr<network::Network>& net, std::vector<std::array<block, 2>>& messages) {
+std::size_t IknpOtExtSender::prepare(std::size_t chunk_size) {
     if (base_ot_sizes_ > 128) {
         throw std::invalid_argument("IKNP is only supported by 128-bit base-OT.");
     }
@@ -43,104 +83,194 @@ void IknpOtExtSender::send(const std::shared_ptr<network::Network>& net, std::ve
     if (ext_ot_sizes_ % (sizeof(block) * 8) != 0) {
         throw std::invalid_argument("OT extension size is not supported.");
     }
+    std::size_t chunk = chunk_columns(chunk_size, ext_ot_sizes_ / (sizeof(block) * 8));
+    // Only the received matrix is materialized; the sender's own rows are expanded tile by tile.
+    recv_matrix_.resize(base_ot_sizes_ * chunk);
+    return chunk;
+}
 
-    std::size_t rows = base_ot_sizes_;
+template <class Emit>
+void IknpOtExtSender::extend(const std::shared_ptr<network::Network>& net, const Emit& emit) {
     std::size_t cols = ext_ot_sizes_ / (sizeof(block) * 8);
+    std::size_t chunk = prepare(chunk_size_);
+    // Every row has its own AES-CTR stream, so streaming the columns chunk by chunk yields the same ots as one batch.
+    for (std::size_t begin = 0; begin < cols; begin += chunk) {
+        extend_chunk(net, begin, std::min(chunk, cols - begin), emit);
+    }
+}
 
-    std::vector<block> recv_matrix(rows * cols);
-    recv_block(net, recv_matrix.data(), rows * cols);
-
-    std::vector<block> ext_matrix(rows * cols);
-    for (std::size_t i = 0; i < rows; i++) {
-        prng_[i]->generate(cols * sizeof(block), reinterpret_cast<solo::Byte*>(&(ext_matrix[i * cols])));
-        if (bit_from_blocks(base_choices_, i)) {
-            for (std::size_t j = 0; j < cols; j++) {
-                ext_matrix[i * cols + j] ^= recv_matrix[i * cols + j];
+template <class Emit>
+void IknpOtExtSender::extend_chunk(
+        const std::shared_ptr<network::Network>& net, std::size_t begin, std::size_t len, const Emit& emit) {
+    std::size_t rows = base_ot_sizes_;
+    block* recv_matrix = recv_matrix_.data();
+    recv_block(net, recv_matrix, rows * len);
+    std::uint64_t counter = prg_.counter();
+    auto mix = [&](block* q, std::size_t column, std::size_t width) {
+        for (std::size_t i = 0; i < rows; i++) {
+            if (bit_from_blocks(base_choices_, i)) {
+                for (std::size_t j = 0; j < width; j++) {
+                    q[i * width + j] ^= recv_matrix[i * len + column + j];
+                }
             }
         }
-    }
+    };
+    fused_tiles(pool_.get(), prg_, counter, rows, len, scratch_, mix,
+            [&](solo::Hash& hash, std::size_t column, block* q) { emit(hash, (begin + column) * rows, q); });
+    prg_.set_counter(counter + len);
+}
 
-    std::vector<block> input(rows);
-    std::vector<std::vector<block>> output(cols, std::vector<block>(rows));
-    for (std::size_t i = 0; i < cols; i++) {
+void IknpOtExtSender::send_chunk(const std::shared_ptr<network::Network>& net, std::size_t begin, std::size_t len,
+        std::vector<std::array<block, 2>>& messages) {
+    std::size_t rows = base_ot_sizes_;
+    block delta = base_choices_.front();
+    extend_chunk(net, begin, len, [&](solo::Hash& hash, std::size_t first, block* q) {
         for (std::size_t j = 0; j < rows; j++) {
-            input[j] = ext_matrix[j * cols + i];
+            std::size_t idx = first + j;
+            q[j] ^= _mm_set_epi64x(0, idx);
+            hash.compute(reinterpret_cast<solo::Byte*>(&q[j]), sizeof(block),
+                    reinterpret_cast<solo::Byte*>(&messages[idx][0]), sizeof(block));
+            q[j] ^= delta;
+            hash.compute(reinterpret_cast<solo::Byte*>(&q[j]), sizeof(block),
+                    reinterpret_cast<solo::Byte*>(&messages[idx][1]), sizeof(block));
         }
-        matrix_transpose(input, rows, rows, output[i]);
-    }
+    });
+}
 
-    auto hash = solo::Hash::create(solo::HashScheme::SHA_256);
+void IknpOtExtSender::send(const std::shared_ptr<network::Network>& net, std::vector<std::array<block, 2>>& messages) {
+    std::size_t cols = ext_ot_sizes_ / (sizeof(block) * 8);
+    std::size_t chunk = prepare(chunk_size_);
     messages.resize(ext_ot_sizes_);
-    for (std::size_t i = 0; i < ext_ot_sizes_; i++) {
-        output[i / rows][i % rows] ^= _mm_set_epi64x(0, i);
-        hash->compute(reinterpret_cast<solo::Byte*>(&output[i / rows][i % rows]), sizeof(block),
-                reinterpret_cast<solo::Byte*>(&messages[i][0]), sizeof(block));
-        output[i / rows][i % rows] ^= base_choices_.front();
-        hash->compute(reinterpret_cast<solo::Byte*>(&output[i / rows][i % rows]), sizeof(block),
-                reinterpret_cast<solo::Byte*>(&messages[i][1]), sizeof(block));
+    for (std::size_t begin = 0; begin < cols; begin += chunk) {
+        send_chunk(net, begin, std::min(chunk, cols - begin), messages);
     }
 
     return;
 }
 
+void IknpOtExtSender::send_correlated(const std::shared_ptr<network::Network>& net, std::vector<block>& correlations) {
+    std::size_t rows = base_ot_sizes_;
+    correlations.resize(ext_ot_sizes_);
+    extend(net, [&](solo::Hash&, std::size_t first, block* q) {
+        std::copy(q, q + rows, correlations.begin() + static_cast<std::ptrdiff_t>(first));
+    });
+
+    return;
+}
+
 void IknpOtExtReceiver::set_base_ots(const std::vector<std::array<block, 2>>& base_send_ots) {
-    solo::PRNGFactory prng_factory(solo::PRNGScheme::AES_ECB_CTR);
+    std::vector<block> keys(2 * base_send_ots.size());
     for (std::size_t i = 0; i < base_send_ots.size(); i++) {
-        std::vector<solo::Byte> seed0(sizeof(block));
-        std::vector<solo::Byte> seed1(sizeof(block));
-        memcpy(seed0.data(), reinterpret_cast<solo::Byte*>(const_cast<block*>(&base_send_ots[i][0])), sizeof(block));
-        memcpy(seed1.data(), reinterpret_cast<solo::Byte*>(const_cast<block*>(&base_send_ots[i][1])), sizeof(block));
-        std::array<std::shared_ptr<solo::PRNG>, 2> values{prng_factory.create(seed0), prng_factory.create(seed1)};
-        prng_.emplace_back(values);
+        keys[i] = base_send_ots[i][0];
+        keys[base_send_ots.size() + i] = base_send_ots[i][1];
     }
+    prg0_.reset(keys.data(), base_send_ots.size());
+    prg1_.reset(keys.data() + base_send_ots.size(), base_send_ots.size());
     return;
 }
 
-void IknpOtExtReceiver::receive(
-        const std::shared_ptr<network::Network>& net, const std::vector<block>& choices, std::vector<block>& messages) {
+std::size_t IknpOtExtReceiver::prepare(std::size_t chunk_size) {
     if (base_ot_sizes_ % (sizeof(block) * 8) != 0) {
         throw std::invalid_argument("OT base size is not supported.");
     }
     if (ext_ot_sizes_ % (sizeof(block) * 8) != 0) {
         throw std::invalid_argument("OT extension size is not supported.");
     }
+    std::size_t chunk = chunk_columns(chunk_size, ext_ot_sizes_ / (sizeof(block) * 8));
+    // Only the matrix sent to the peer is materialized.
+    send_matrix_.resize(base_ot_sizes_ * chunk);
+    scratch_.resize(parallel_parts(pool_.get()) * 2 * base_ot_sizes_ * kTileColumns);
+    return chunk;
+}
 
-    std::size_t rows = base_ot_sizes_;
+template <class Emit>
+void IknpOtExtReceiver::extend(
+        const std::shared_ptr<network::Network>& net, const std::vector<block>& choices, const Emit& emit) {
     std::size_t cols = ext_ot_sizes_ / (sizeof(block) * 8);
+    std::size_t chunk = prepare(chunk_size_);
+    for (std::size_t begin = 0; begin < cols; begin += chunk) {
+        std::size_t len = std::min(chunk, cols - begin);
+        send_chunk(net, choices, begin, len);
+        hash_chunk(begin, len, emit);
+    }
+}
 
-    std::vector<block> t0(rows * cols);
-    std::vector<block> t1(rows * cols);
-    std::vector<block> send_matrix(rows * cols);
-    for (std::size_t i = 0; i < rows; i++) {
-        prng_[i][0]->generate(cols * sizeof(block), reinterpret_cast<solo::Byte*>(&(t0[i * cols])));
-        prng_[i][1]->generate(cols * sizeof(block), reinterpret_cast<solo::Byte*>(&(t1[i * cols])));
-
-        for (std::size_t j = 0; j < cols; j++) {
-            send_matrix[i * cols + j] = t0[i * cols + j] ^ t1[i * cols + j] ^ choices[j];
+void IknpOtExtReceiver::send_chunk(const std::shared_ptr<network::Network>& net, const std::vector<block>& choices,
+        std::size_t begin, std::size_t len) {
+    // The matrix is emitted tile by tile and sent before hashing, so the sender can start on it; the m0 streams are
+    // then expanded a second time, which costs far less than storing and re-reading them, and transposed and hashed
+    // while each tile is in cache.
+    std::size_t rows = base_ot_sizes_;
+    block* send_matrix = send_matrix_.data();
+    std::uint64_t counter = prg0_.counter();
+    std::size_t tiles = (len + kTileColumns - 1) / kTileColumns;
+    parallel_for_parts(pool_.get(), tiles, [&](std::size_t part, std::size_t first, std::size_t last) {
+        block* t0 = scratch_.data() + part * 2 * rows * kTileColumns;
+        block* t1 = t0 + rows * kTileColumns;
+        for (std::size_t t = first; t < last; t++) {
+            std::size_t column = t * kTileColumns;
+            std::size_t width = std::min(kTileColumns, len - column);
+            prg0_.generate_at(counter + column, width, t0, width);
+            prg1_.generate_at(counter + column, width, t1, width);
+            for (std::size_t i = 0; i < rows; i++) {
+                for (std::size_t j = 0; j < width; j++) {
+                    send_matrix[i * len + column + j] =
+                            t0[i * width + j] ^ t1[i * width + j] ^ choices[begin + column + j];
+                }
+            }
         }
-    }
+    });
 
-    send_block(net, send_matrix.data(), rows * cols);
+    send_block(net, send_matrix, rows * len);
+}
 
-    std::vector<block> input(rows);
-    std::vector<std::vector<block>> output(cols, std::vector<block>(rows));
-    for (std::size_t i = 0; i < cols; i++) {
+template <class Emit>
+void IknpOtExtReceiver::hash_chunk(std::size_t begin, std::size_t len, const Emit& emit) {
+    std::size_t rows = base_ot_sizes_;
+    std::uint64_t counter = prg0_.counter();
+    auto mix = [](block*, std::size_t, std::size_t) {};
+    fused_tiles(pool_.get(), prg0_, counter, rows, len, scratch_, mix,
+            [&](solo::Hash& hash, std::size_t column, block* t) { emit(hash, (begin + column) * rows, t); });
+    prg0_.set_counter(counter + len);
+    prg1_.set_counter(counter + len);
+}
+
+void IknpOtExtReceiver::receive_chunk(std::size_t begin, std::size_t len, std::vector<block>& messages) {
+    std::size_t rows = base_ot_sizes_;
+    hash_chunk(begin, len, [&](solo::Hash& hash, std::size_t first, block* t) {
         for (std::size_t j = 0; j < rows; j++) {
-            input[j] = t0[j * cols + i];
+            std::size_t idx = first + j;
+            t[j] ^= _mm_set_epi64x(0, idx);
+            hash.compute(reinterpret_cast<solo::Byte*>(&t[j]), sizeof(block),
+                    reinterpret_cast<solo::Byte*>(&messages[idx]), sizeof(block));
         }
-        matrix_transpose(input, rows, rows, output[i]);
-    }
+    });
+}
 
-    auto hash = solo::Hash::create(solo::HashScheme::SHA_256);
+void IknpOtExtReceiver::receive(
+        const std::shared_ptr<network::Network>& net, const std::vector<block>& choices, std::vector<block>& messages) {
+    std::size_t cols = ext_ot_sizes_ / (sizeof(block) * 8);
+    std::size_t chunk = prepare(chunk_size_);
     messages.resize(ext_ot_sizes_);
-    for (std::size_t i = 0; i < ext_ot_sizes_; i++) {
-        output[i / rows][i % rows] ^= _mm_set_epi64x(0, i);
-        hash->compute(reinterpret_cast<solo::Byte*>(&output[i / rows][i % rows]), sizeof(block),
-                reinterpret_cast<solo::Byte*>(&messages[i]), sizeof(block));
+    for (std::size_t begin = 0; begin < cols; begin += chunk) {
+        std::size_t len = std::min(chunk, cols - begin);
+        send_chunk(net, choices, begin, len);
+        receive_chunk(begin, len, messages);
     }
 
     return;
 }
 
+void IknpOtExtReceiver::receive_correlated(const std::shared_ptr<network::Network>& net,
+        const std::vector<block>& choices, std::vector<block>& correlations) {
+    std::size_t rows = base_ot_sizes_;
+    correlations.resize(ext_ot_sizes_);
+    extend(net, choices, [&](solo::Hash&, std::size_t first, block* t) {
+        std::copy(t, t + rows, correlations.begin() + static_cast<std::ptrdiff_t>(first));
+    });
+
+    return;
+}
+
 }  // namespace verse
 }  // namespace petace
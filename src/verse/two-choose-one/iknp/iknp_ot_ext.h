@@ -24,7 +24,11 @@
 
 #include "verse/two-choose-one/ot_ext_receiver.h"
 #include "verse/two-choose-one/ot_ext_sender.h"
+#include "verse/util/aes.h"
+#include "verse/util/buffer.h"
 #include "verse/util/defines.h"
+#include "verse/util/numa.h"
+#include "verse/util/thread_pool.h"
 
 namespace petace {
 namespace verse {
@@ -39,7 +43,31 @@ namespace verse {
  */
 class IknpOtExtSender : public OtExtSender {
 public:
-    IknpOtExtSender(std::size_t base_ot_sizes, std::size_t ext_ot_sizes) : OtExtSender(base_ot_sizes, ext_ot_sizes) {
+    /**
+     * @brief Create an iknp sender.
+     *
+     * @param[in] base_ot_sizes The number of base ots; must be 128.
+     * @param[in] ext_ot_sizes The number of ots per send; a multiple of 128.
+     * @param[in] num_threads The threads used to transpose and hash; 1 keeps the work on the calling thread.
+     * @param[in] chunk_size The ots per streamed chunk; 0 receives a batch as one chunk. Must match the receiver.
+     * @param[in] allocator The memory of the work buffers, which are kept across calls; null uses the default.
+     * @param[in] numa_node The NUMA node the worker threads are bound to; -1 leaves them unbound. The calling thread
+     * is never rebound.
+     * @param[in] pool Workers to run the parallel steps on instead of num_threads - 1 own ones; may be shared.
+     */
+    IknpOtExtSender(std::size_t base_ot_sizes, std::size_t ext_ot_sizes, std::size_t num_threads = 1,
+            std::size_t chunk_size = 0, const std::shared_ptr<BufferAllocator>& allocator = nullptr,
+            int numa_node = -1, const std::shared_ptr<ThreadPool>& pool = nullptr)
+            : OtExtSender(base_ot_sizes, ext_ot_sizes),
+              chunk_size_(chunk_size),
+              recv_matrix_(allocator),
+              scratch_(allocator),
+              pool_(pool) {
+        if (pool_ == nullptr && num_threads > 1 && numa_node >= 0) {
+            pool_.reset(new ThreadPool(num_threads - 1, [numa_node] { bind_thread_to_numa_node(numa_node); }));
+        } else if (pool_ == nullptr && num_threads > 1) {
+            pool_.reset(new ThreadPool(num_threads - 1));
+        }
     }
 
     ~IknpOtExtSender() {
@@ -61,10 +89,61 @@ class IknpOtExtSender : public OtExtSender {
      */
     void send(const std::shared_ptr<network::Network>& net, std::vector<std::array<block, 2>>& messages) override;
 
+    using OtExtSender::send;
+
+    /**
+     * @brief The sender gets the unhashed iknp correlation q_j = t_j ^ (c_j * delta) of every extended ot.
+     *
+     * The rows are correlated through delta and are not ots by themselves; callers must break the correlation, e.g.
+     * with a correlation robust hash of (j, q_j) and (j, q_j ^ delta), before using them as keys. The receiver calls
+     * receive_correlated.
+     *
+     * @param[in] net The network interface (e.g., PETAce-Network interface).
+     * @param[out] correlations The rows q_j.
+     * @throws std::invalid_argument.
+     */
+    void send_correlated(const std::shared_ptr<network::Network>& net, std::vector<block>& correlations);
+
+    /**
+     * @brief Return the global correlation delta; valid after set_base_ots.
+     */
+    block delta() const {
+        return base_choices_.front();
+    }
+
 private:
+    friend class IknpDuplexOtExt;
+
+    // Check the parameters and size the buffers for chunks of chunk_size ots; return the 128-ot columns per chunk.
+    std::size_t prepare(std::size_t chunk_size);
+
+    // Run the extension and hand every 128 transposed rows to emit(hash, j, q), q[0] being the row of ot j.
+    template <class Emit>
+    void extend(const std::shared_ptr<network::Network>& net, const Emit& emit);
+
+    // Receive the peer's matrix for the len columns from column begin and emit their rows as extend does.
+    template <class Emit>
+    void extend_chunk(
+            const std::shared_ptr<network::Network>& net, std::size_t begin, std::size_t len, const Emit& emit);
+
+    // The work of send for one chunk; messages must already hold ext_ot_sizes entries.
+    void send_chunk(const std::shared_ptr<network::Network>& net, std::size_t begin, std::size_t len,
+            std::vector<std::array<block, 2>>& messages);
+
     std::vector<block> base_choices_{};
 
-    std::vector<std::shared_ptr<solo::PRNG>> prng_{};
+    // One AES-CTR stream per base ot, keyed by the received base ot message.
+    MultiKeyPrg prg_{};
+
+    std::size_t chunk_size_ = 0;
+
+    // The matrix received from the peer, one chunk long.
+    Buffer<block> recv_matrix_;
+
+    // Per-range tiles and transpose buffers.
+    Buffer<block> scratch_;
+
+    std::shared_ptr<ThreadPool> pool_ = nullptr;
 };
 
 /**
@@ -77,8 +156,31 @@ class IknpOtExtSender : public OtExtSender {
  */
 class IknpOtExtReceiver : public OtExtReceiver {
 public:
-    IknpOtExtReceiver(std::size_t base_ot_sizes, std::size_t ext_ot_sizes)
-            : OtExtReceiver(base_ot_sizes, ext_ot_sizes) {
+    /**
+     * @brief Create an iknp receiver.
+     *
+     * @param[in] base_ot_sizes The number of base ots; must be 128.
+     * @param[in] ext_ot_sizes The number of ots per receive; a multiple of 128.
+     * @param[in] num_threads The threads used to transpose and hash; 1 keeps the work on the calling thread.
+     * @param[in] chunk_size The ots per streamed chunk; 0 sends a batch as one chunk. Must match the sender.
+     * @param[in] allocator The memory of the work buffers, which are kept across calls; null uses the default.
+     * @param[in] numa_node The NUMA node the worker threads are bound to; -1 leaves them unbound. The calling thread
+     * is never rebound.
+     * @param[in] pool Workers to run the parallel steps on instead of num_threads - 1 own ones; may be shared.
+     */
+    IknpOtExtReceiver(std::size_t base_ot_sizes, std::size_t ext_ot_sizes, std::size_t num_threads = 1,
+            std::size_t chunk_size = 0, const std::shared_ptr<BufferAllocator>& allocator = nullptr,
+            int numa_node = -1, const std::shared_ptr<ThreadPool>& pool = nullptr)
+            : OtExtReceiver(base_ot_sizes, ext_ot_sizes),
+              chunk_size_(chunk_size),
+              send_matrix_(allocator),
+              scratch_(allocator),
+              pool_(pool) {
+        if (pool_ == nullptr && num_threads > 1 && numa_node >= 0) {
+            pool_.reset(new ThreadPool(num_threads - 1, [numa_node] { bind_thread_to_numa_node(numa_node); }));
+        } else if (pool_ == nullptr && num_threads > 1) {
+            pool_.reset(new ThreadPool(num_threads - 1));
+        }
     }
 
     ~IknpOtExtReceiver() {
@@ -102,18 +204,66 @@ class IknpOtExtReceiver : public OtExtReceiver {
     void receive(const std::shared_ptr<network::Network>& net, const std::vector<block>& choices,
             std::vector<block>& messages) override;
 
+    using OtExtReceiver::receive;
+
+    /**
+     * @brief The receiver gets the unhashed iknp rows t_j, matching IknpOtExtSender::send_correlated.
+     *
+     * @param[in] net The network interface (e.g., PETAce-Network interface).
+     * @param[in] choices The chosen bits c of receiver.
+     * @param[out] correlations The rows t_j = q_j ^ (c_j * delta).
+     * @throws std::invalid_argument.
+     */
+    void receive_correlated(const std::shared_ptr<network::Network>& net, const std::vector<block>& choices,
+            std::vector<block>& correlations);
+
 private:
+    friend class IknpDuplexOtExt;
+
+    // Check the parameters and size the buffers for chunks of chunk_size ots; return the 128-ot columns per chunk.
+    std::size_t prepare(std::size_t chunk_size);
+
+    // Run the extension and hand every 128 transposed rows to emit(hash, j, t), t[0] being the row of ot j.
+    template <class Emit>
+    void extend(const std::shared_ptr<network::Network>& net, const std::vector<block>& choices, const Emit& emit);
+
+    // Expand the matrix of the len columns from column begin and send it to the peer.
+    void send_chunk(const std::shared_ptr<network::Network>& net, const std::vector<block>& choices, std::size_t begin,
+            std::size_t len);
+
+    // Emit the rows of the chunk last sent by send_chunk as extend does, then advance the streams past it.
+    template <class Emit>
+    void hash_chunk(std::size_t begin, std::size_t len, const Emit& emit);
+
+    // hash_chunk into the chosen messages; messages must already hold ext_ot_sizes entries.
+    void receive_chunk(std::size_t begin, std::size_t len, std::vector<block>& messages);
+
     std::vector<block> base_choices{};
 
-    std::vector<std::array<std::shared_ptr<solo::PRNG>, 2>> prng_{};
+    // Streams keyed by the m0 and by the m1 of the base ots.
+    MultiKeyPrg prg0_{};
+
+    MultiKeyPrg prg1_{};
+
+    std::size_t chunk_size_ = 0;
+
+    // The matrix sent to the peer, one chunk long.
+    Buffer<block> send_matrix_;
+
+    // Per-range tiles and transpose buffers.
+    Buffer<block> scratch_;
+
+    std::shared_ptr<ThreadPool> pool_ = nullptr;
 };
 
 inline std::unique_ptr<OtExtSender> create_iknp_ext_sender(const VerseParams& params) {
-    return std::make_unique<IknpOtExtSender>(params.base_ot_sizes, params.ext_ot_sizes);
+    return std::make_unique<IknpOtExtSender>(params.base_ot_sizes, params.ext_ot_sizes, params.num_threads,
+            params.chunk_size, buffer_allocator(params), params.numa_node, params.pool);
 }
 
 inline std::unique_ptr<OtExtReceiver> create_iknp_ext_receiver(const VerseParams& params) {
-    return std::make_unique<IknpOtExtReceiver>(params.base_ot_sizes, params.ext_ot_sizes);
+    return std::make_unique<IknpOtExtReceiver>(params.base_ot_sizes, params.ext_ot_sizes, params.num_threads,
+            params.chunk_size, buffer_allocator(params), params.numa_node, params.pool);
 }
 
 }  // namespace verse
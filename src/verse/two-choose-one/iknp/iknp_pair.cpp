@@ -0,0 +1,51 @@
+// Copyright 2023 TikTok Pte. Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "verse/two-choose-one/iknp/iknp_pair.h"
+
+#include <array>
+#include <vector>
+
+#include "verse/util/common.h"
+#include "verse/verse_factory.h"
+
+namespace petace {
+namespace verse {
+
+void setup_iknp_pair(const std::shared_ptr<network::Network>& net, const VerseParams& params, bool is_leader,
+        std::unique_ptr<IknpOtExtSender>& sender, std::unique_ptr<IknpOtExtReceiver>& receiver) {
+    auto base_sender = VerseFactory<BaseOtSender>::get_instance().build(OTScheme::NaorPinkasSender, params);
+    auto base_receiver = VerseFactory<BaseOtReceiver>::get_instance().build(OTScheme::NaorPinkasReceiver, params);
+    sender.reset(new IknpOtExtSender(params.base_ot_sizes, params.ext_ot_sizes, params.num_threads,
+            params.chunk_size, buffer_allocator(params), params.numa_node, params.pool));
+    receiver.reset(new IknpOtExtReceiver(params.base_ot_sizes, params.ext_ot_sizes, params.num_threads,
+            params.chunk_size, buffer_allocator(params), params.numa_node, params.pool));
+
+    std::vector<block> base_choices{read_block_from_dev_urandom()};
+    std::vector<block> base_recv_ots;
+    std::vector<std::array<block, 2>> base_send_ots;
+    if (is_leader) {
+        base_receiver->receive(net, base_choices, base_recv_ots);
+        base_sender->send(net, base_send_ots);
+    } else {
+        base_sender->send(net, base_send_ots);
+        base_receiver->receive(net, base_choices, base_recv_ots);
+    }
+    sender->set_base_ots(base_choices, base_recv_ots);
+    receiver->set_base_ots(base_send_ots);
+}
+
+}  // namespace verse
+}  // namespace petace
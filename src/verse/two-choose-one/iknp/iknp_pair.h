@@ -0,0 +1,44 @@
+// Copyright 2023 TikTok Pte. Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include <memory>
+
+#include "network/network.h"
+
+#include "verse/two-choose-one/iknp/iknp_ot_ext.h"
+#include "verse/util/defines.h"
+
+namespace petace {
+namespace verse {
+
+/**
+ * @brief Build an iknp sender and an iknp receiver on one connection and run the naor-pinkas base ots of both.
+ *
+ * The peer calls this with the opposite is_leader. The leader's extension sender is set up first, so both parties run
+ * the base ots in the same order.
+ *
+ * @param[in] net The network interface (e.g., PETAce-Network interface).
+ * @param[in] params Parameters of both extensions.
+ * @param[in] is_leader Whether the local party is the leader.
+ * @param[out] sender The iknp sender, paired with the peer's receiver.
+ * @param[out] receiver The iknp receiver, paired with the peer's sender.
+ */
+void setup_iknp_pair(const std::shared_ptr<network::Network>& net, const VerseParams& params, bool is_leader,
+        std::unique_ptr<IknpOtExtSender>& sender, std::unique_ptr<IknpOtExtReceiver>& receiver);
+
+}  // namespace verse
+}  // namespace petace
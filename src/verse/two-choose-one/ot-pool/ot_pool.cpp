@@ -0,0 +1,284 @@
+// Copyright 2023 TikTok Pte. Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "verse/two-choose-one/ot-pool/ot_pool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+
+#include "verse/util/common.h"
+#include "verse/verse_factory.h"
+
+namespace petace {
+namespace verse {
+
+namespace {
+
+const std::uint8_t kRefillCommand = 1;
+const std::uint8_t kStopCommand = 0;
+
+void check_pool_params(const VerseParams& params, const OtPoolParams& pool_params) {
+    if (params.net == nullptr) {
+        throw std::invalid_argument("refill network is not set.");
+    }
+    if (params.ext_ot_sizes == 0 || pool_params.low_watermark > pool_params.high_watermark) {
+        throw std::invalid_argument("ot pool watermarks are not supported.");
+    }
+    // Refills extend whole 128-ot columns; check here rather than fail later on the refill thread.
+    if (params.ext_ot_sizes % (sizeof(block) * 8) != 0) {
+        throw std::invalid_argument("OT extension size is not supported.");
+    }
+}
+
+// Drop the consumed prefix of a buffer. Callers only do so once it is more than half of the buffer.
+template <class T>
+void compact(std::vector<T>& buffer, std::size_t head) {
+    buffer.erase(buffer.begin(), buffer.begin() + static_cast<std::ptrdiff_t>(head));
+}
+
+double seconds_since(const std::chrono::steady_clock::time_point& begin) {
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+    return elapsed.count();
+}
+
+}  // namespace
+
+OtPoolSender::OtPoolSender(const VerseParams& params, const OtPoolParams& pool_params)
+        : params_(params), pool_params_(pool_params) {
+    check_pool_params(params, pool_params);
+    ext_ = VerseFactory<OtExtSender>::get_instance().build(OTScheme::IknpSender, params);
+}
+
+OtPoolSender::~OtPoolSender() {
+    if (refill_thread_.joinable()) {
+        refill_thread_.join();
+    }
+}
+
+void OtPoolSender::start() {
+    std::vector<block> base_choices((params_.base_ot_sizes + 127) / 128);
+    for (auto& choice : base_choices) {
+        choice = read_block_from_dev_urandom();
+    }
+    std::vector<block> base_recv_ots;
+    auto npot_receiver = VerseFactory<BaseOtReceiver>::get_instance().build(OTScheme::NaorPinkasReceiver, params_);
+    npot_receiver->receive(params_.net, base_choices, base_recv_ots);
+    ext_->set_base_ots(base_choices, base_recv_ots);
+    refill_thread_ = std::thread([this] { refill_loop(); });
+}
+
+void OtPoolSender::refill_loop() {
+    std::vector<std::array<block, 2>> batch;
+    try {
+        for (;;) {
+            std::uint8_t command = kStopCommand;
+            params_.net->recv_data(&command, sizeof(command));
+            if (command != kRefillCommand) {
+                break;
+            }
+            auto begin = std::chrono::steady_clock::now();
+            ext_->send(params_.net, batch);
+            double elapsed = seconds_since(begin);
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (head_ * 2 > buffer_.size()) {
+                    compact(buffer_, head_);
+                    head_ = 0;
+                }
+                buffer_.insert(buffer_.end(), batch.begin(), batch.end());
+                stats_.produced += batch.size();
+                stats_.refill_seconds += elapsed;
+            }
+            cv_.notify_all();
+        }
+    } catch (const std::exception&) {
+        // A broken refill connection ends the pool; pending draws fail below.
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        finished_ = true;
+    }
+    cv_.notify_all();
+}
+
+void OtPoolSender::draw(
+        const std::shared_ptr<network::Network>& net, std::size_t n, std::vector<std::array<block, 2>>& messages) {
+    std::vector<std::uint8_t> corrections((n + 7) / 8);
+    recv_frame(net, corrections.data(), corrections.size());
+
+    messages.resize(n);
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (buffer_.size() - head_ < n) {
+        auto begin = std::chrono::steady_clock::now();
+        cv_.wait(lock, [this, n] { return buffer_.size() - head_ >= n || finished_; });
+        stats_.waits++;
+        stats_.wait_seconds += seconds_since(begin);
+        if (buffer_.size() - head_ < n) {
+            throw std::runtime_error("ot pool is stopped.");
+        }
+    }
+    // Masked swap: with d = c ^ r the receiver holds x_r = y_c for (y0, y1) = (x_d, x_{1 - d}).
+    const std::array<block, 2>* pooled = buffer_.data() + head_;
+    for (std::size_t i = 0; i < n; i++) {
+        std::int64_t bit = (corrections[i / 8] >> (i % 8)) & 1;
+        block mask = _mm_set1_epi64x(-bit);
+        block diff = _mm_and_si128(_mm_xor_si128(pooled[i][0], pooled[i][1]), mask);
+        messages[i][0] = _mm_xor_si128(pooled[i][0], diff);
+        messages[i][1] = _mm_xor_si128(pooled[i][1], diff);
+    }
+    head_ += n;
+    stats_.consumed += n;
+}
+
+std::size_t OtPoolSender::available() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return buffer_.size() - head_;
+}
+
+OtPoolStats OtPoolSender::get_stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+OtPoolReceiver::OtPoolReceiver(const VerseParams& params, const OtPoolParams& pool_params)
+        : params_(params), pool_params_(pool_params) {
+    check_pool_params(params, pool_params);
+    ext_ = VerseFactory<OtExtReceiver>::get_instance().build(OTScheme::IknpReceiver, params);
+    solo::PRNGFactory prng_factory(solo::PRNGScheme::AES_ECB_CTR);
+    prng_ = prng_factory.create();
+}
+
+OtPoolReceiver::~OtPoolReceiver() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    cv_.notify_all();
+    if (refill_thread_.joinable()) {
+        refill_thread_.join();
+    }
+}
+
+void OtPoolReceiver::start() {
+    std::vector<std::array<block, 2>> base_send_ots;
+    auto npot_sender = VerseFactory<BaseOtSender>::get_instance().build(OTScheme::NaorPinkasSender, params_);
+    npot_sender->send(params_.net, base_send_ots);
+    ext_->set_base_ots(base_send_ots);
+    refill_thread_ = std::thread([this] { refill_loop(); });
+}
+
+void OtPoolReceiver::refill_loop() {
+    std::vector<block> choices(params_.ext_ot_sizes / (sizeof(block) * 8));
+    std::vector<block> batch;
+    try {
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                cv_.wait(lock, [this] {
+                    std::size_t level = buffer_.size() - head_;
+                    return stop_ || level < pool_params_.low_watermark || level < demand_;
+                });
+                if (stop_) {
+                    break;
+                }
+            }
+            for (;;) {
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    std::size_t level = buffer_.size() - head_;
+                    if (stop_ || (level >= pool_params_.high_watermark && level >= demand_)) {
+                        break;
+                    }
+                }
+                auto begin = std::chrono::steady_clock::now();
+                prng_->generate(choices.size() * sizeof(block), reinterpret_cast<solo::Byte*>(choices.data()));
+                params_.net->send_data(&kRefillCommand, sizeof(kRefillCommand));
+                ext_->receive(params_.net, choices, batch);
+                double elapsed = seconds_since(begin);
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    if (head_ * 2 > buffer_.size()) {
+                        compact(buffer_, head_);
+                        compact(buffer_choices_, head_);
+                        head_ = 0;
+                    }
+                    buffer_.insert(buffer_.end(), batch.begin(), batch.end());
+                    for (std::size_t i = 0; i < batch.size(); i++) {
+                        buffer_choices_.emplace_back(static_cast<std::uint8_t>(bit_from_blocks(choices, i)));
+                    }
+                    stats_.produced += batch.size();
+                    stats_.refill_seconds += elapsed;
+                }
+                cv_.notify_all();
+            }
+        }
+        params_.net->send_data(&kStopCommand, sizeof(kStopCommand));
+    } catch (const std::exception&) {
+        // A broken refill connection ends the pool; pending draws fail below.
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        finished_ = true;
+    }
+    cv_.notify_all();
+}
+
+void OtPoolReceiver::draw(const std::shared_ptr<network::Network>& net, const std::vector<block>& choices,
+        std::size_t n, std::vector<block>& messages) {
+    if (choices.size() * sizeof(block) * 8 < n) {
+        throw std::invalid_argument("choices are fewer than ots.");
+    }
+    std::vector<std::uint8_t> corrections((n + 7) / 8, 0);
+    messages.resize(n);
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (buffer_.size() - head_ < n) {
+            auto begin = std::chrono::steady_clock::now();
+            demand_ = n;
+            cv_.notify_all();
+            cv_.wait(lock, [this, n] { return buffer_.size() - head_ >= n || finished_; });
+            demand_ = 0;
+            stats_.waits++;
+            stats_.wait_seconds += seconds_since(begin);
+            if (buffer_.size() - head_ < n) {
+                throw std::runtime_error("ot pool is stopped.");
+            }
+        }
+        const std::uint8_t* pooled_choices = buffer_choices_.data() + head_;
+        for (std::size_t i = 0; i < n; i++) {
+            std::uint8_t bit = static_cast<std::uint8_t>(bit_from_blocks(choices, i) ^ pooled_choices[i]);
+            corrections[i / 8] = static_cast<std::uint8_t>(corrections[i / 8] | (bit << (i % 8)));
+        }
+        std::copy(buffer_.begin() + static_cast<std::ptrdiff_t>(head_),
+                buffer_.begin() + static_cast<std::ptrdiff_t>(head_ + n), messages.begin());
+        head_ += n;
+        stats_.consumed += n;
+    }
+    cv_.notify_all();
+    send_frame(net, corrections.data(), corrections.size());
+}
+
+std::size_t OtPoolReceiver::available() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return buffer_.size() - head_;
+}
+
+OtPoolStats OtPoolReceiver::get_stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+}  // namespace verse
+}  // namespace petace
@@ -0,0 +1,240 @@
+// Copyright 2023 TikTok Pte. Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <array>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "network/network.h"
+#include "solo/prng.h"
+
+#include "verse/two-choose-one/ot_ext_receiver.h"
+#include "verse/two-choose-one/ot_ext_sender.h"
+#include "verse/util/defines.h"
+
+namespace petace {
+namespace verse {
+
+/**
+ * @brief Buffer levels of an ot pool, counted in ots.
+ *
+ * The refill thread starts extending when the buffer drops below low_watermark (or below a pending request) and
+ * keeps extending batches of ext_ot_sizes until it reaches high_watermark.
+ */
+struct OtPoolParams {
+    std::size_t low_watermark = 1 << 14;
+    std::size_t high_watermark = 1 << 16;
+};
+
+/**
+ * @brief Accumulated statistics of an ot pool.
+ */
+struct OtPoolStats {
+    // Random ots produced by the refill thread.
+    std::size_t produced = 0;
+    // Ots handed out by draw.
+    std::size_t consumed = 0;
+    // Seconds the refill thread spent extending.
+    double refill_seconds = 0.0;
+    // Number of draw calls that had to wait for the refill thread.
+    std::size_t waits = 0;
+    // Seconds draw calls spent waiting for the refill thread.
+    double wait_seconds = 0.0;
+
+    /**
+     * @brief Return produced ots per refill second.
+     */
+    double fill_rate() const {
+        return refill_seconds > 0.0 ? static_cast<double>(produced) / refill_seconds : 0.0;
+    }
+};
+
+/**
+ * @brief Pool of precomputed random 1-out-of-2 ots [sender].
+ *
+ * A background thread runs iknp on its own connection and keeps a buffer of random ots (x0, x1) filled. The refill
+ * is driven by the receiver pool, so both buffers hold the same ots in the same order. An online draw consumes ots
+ * from the buffer and derandomizes them with one message of choice-bit corrections.
+ *
+ * @par Example.
+ * Refer to ot_pool_test.cpp.
+ */
+class OtPoolSender {
+public:
+    /**
+     * @brief Create a pool; params.net is the dedicated refill connection.
+     *
+     * @param[in] params Parameters of the iknp extension used for refilling.
+     * @param[in] pool_params Buffer levels of the pool.
+     * @throws std::invalid_argument if params.net is null, params.ext_ot_sizes is not a multiple of 128 or the
+     * watermarks are inconsistent.
+     */
+    OtPoolSender(const VerseParams& params, const OtPoolParams& pool_params);
+
+    /**
+     * @brief Stop the refill thread. Returns once the receiver pool has stopped as well.
+     */
+    ~OtPoolSender();
+
+    OtPoolSender(const OtPoolSender&) = delete;
+    OtPoolSender& operator=(const OtPoolSender&) = delete;
+
+    /**
+     * @brief Run base ots and start the refill thread.
+     */
+    void start();
+
+    /**
+     * @brief Draw n ots and derandomize them to the receiver's choices.
+     *
+     * The result has the same semantics as OtExtSender::send: the receiver holds messages[i][c_i].
+     *
+     * @param[in] net The online connection to the receiver (not the refill connection).
+     * @param[in] n The number of ots.
+     * @param[out] messages The random output messages of the sender.
+     */
+    void draw(const std::shared_ptr<network::Network>& net, std::size_t n,
+            std::vector<std::array<block, 2>>& messages);
+
+    /**
+     * @brief Return the number of buffered ots.
+     */
+    std::size_t available() const;
+
+    /**
+     * @brief Return a snapshot of the pool statistics.
+     */
+    OtPoolStats get_stats() const;
+
+private:
+    void refill_loop();
+
+    VerseParams params_{};
+
+    OtPoolParams pool_params_{};
+
+    std::unique_ptr<OtExtSender> ext_ = nullptr;
+
+    std::thread refill_thread_{};
+
+    mutable std::mutex mutex_{};
+
+    std::condition_variable cv_{};
+
+    std::vector<std::array<block, 2>> buffer_{};
+
+    std::size_t head_ = 0;
+
+    bool finished_ = false;
+
+    OtPoolStats stats_{};
+};
+
+/**
+ * @brief Pool of precomputed random 1-out-of-2 ots [receiver].
+ *
+ * A background thread runs iknp with random choices on its own connection and keeps a buffer of random ots
+ * (r, x_r) filled. It decides when to refill and tells the sender pool, so both buffers stay aligned.
+ *
+ * @par Example.
+ * Refer to ot_pool_test.cpp.
+ */
+class OtPoolReceiver {
+public:
+    /**
+     * @brief Create a pool; params.net is the dedicated refill connection.
+     *
+     * @param[in] params Parameters of the iknp extension used for refilling.
+     * @param[in] pool_params Buffer levels of the pool.
+     * @throws std::invalid_argument if params.net is null, params.ext_ot_sizes is not a multiple of 128 or the
+     * watermarks are inconsistent.
+     */
+    OtPoolReceiver(const VerseParams& params, const OtPoolParams& pool_params);
+
+    /**
+     * @brief Stop the refill thread and tell the sender pool to stop.
+     */
+    ~OtPoolReceiver();
+
+    OtPoolReceiver(const OtPoolReceiver&) = delete;
+    OtPoolReceiver& operator=(const OtPoolReceiver&) = delete;
+
+    /**
+     * @brief Run base ots and start the refill thread.
+     */
+    void start();
+
+    /**
+     * @brief Draw n ots, send the choice-bit corrections and output the chosen messages.
+     *
+     * @param[in] net The online connection to the sender (not the refill connection).
+     * @param[in] choices The chosen bits of receiver.
+     * @param[in] n The number of ots.
+     * @param[out] messages The chosen messages indexed by choices.
+     * @throws std::invalid_argument if choices hold fewer than n bits.
+     */
+    void draw(const std::shared_ptr<network::Network>& net, const std::vector<block>& choices, std::size_t n,
+            std::vector<block>& messages);
+
+    /**
+     * @brief Return the number of buffered ots.
+     */
+    std::size_t available() const;
+
+    /**
+     * @brief Return a snapshot of the pool statistics.
+     */
+    OtPoolStats get_stats() const;
+
+private:
+    void refill_loop();
+
+    VerseParams params_{};
+
+    OtPoolParams pool_params_{};
+
+    std::unique_ptr<OtExtReceiver> ext_ = nullptr;
+
+    std::shared_ptr<solo::PRNG> prng_ = nullptr;
+
+    std::thread refill_thread_{};
+
+    mutable std::mutex mutex_{};
+
+    std::condition_variable cv_{};
+
+    std::vector<block> buffer_{};
+
+    std::vector<std::uint8_t> buffer_choices_{};
+
+    std::size_t head_ = 0;
+
+    // Number of ots a waiting draw needs; the refill thread extends until it is covered.
+    std::size_t demand_ = 0;
+
+    bool stop_ = false;
+
+    bool finished_ = false;
+
+    OtPoolStats stats_{};
+};
+
+}  // namespace verse
+}  // namespace petace
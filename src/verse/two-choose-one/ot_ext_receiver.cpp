@@ -0,0 +1,59 @@
+// Copyright 2023 TikTok Pte. Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "verse/two-choose-one/ot_ext_receiver.h"
+
+#include "verse/two-choose-one/derandomize.h"
+#include "verse/util/aes.h"
+
+namespace petace {
+namespace verse {
+
+namespace {
+
+std::vector<block> random_choices(std::size_t n) {
+    solo::PRNGFactory prng_factory(solo::PRNGScheme::AES_ECB_CTR);
+    std::vector<block> choices((n + sizeof(block) * 8 - 1) / (sizeof(block) * 8));
+    prng_factory.create()->generate(choices.size() * sizeof(block), reinterpret_cast<solo::Byte*>(choices.data()));
+    return choices;
+}
+
+}  // namespace
+
+void OtExtReceiver::receive(const std::shared_ptr<network::Network>& net, const std::vector<block>& choices,
+        std::vector<solo::Byte>& messages, std::size_t msg_len) {
+    std::vector<block> seeds;
+    receive(net, choices, seeds);
+    messages.resize(seeds.size() * msg_len);
+    prg_stretch(seeds.data(), seeds.size(), msg_len, messages.data());
+}
+
+void OtExtReceiver::receive_chosen(const std::shared_ptr<network::Network>& net, const std::vector<block>& choices,
+        std::vector<block>& messages) {
+    auto random = random_choices(ext_ot_sizes_);
+    std::vector<block> random_messages;
+    receive(net, random, random_messages);
+    receive_chosen_messages(net, random, random_messages, choices, messages);
+}
+
+void OtExtReceiver::receive_chosen(const std::shared_ptr<network::Network>& net, const std::vector<block>& choices,
+        std::vector<solo::Byte>& messages, std::size_t msg_len) {
+    auto random = random_choices(ext_ot_sizes_);
+    std::vector<block> random_messages;
+    receive(net, random, random_messages);
+    receive_chosen_messages(net, random, random_messages, choices, messages, msg_len);
+}
+
+}  // namespace verse
+}  // namespace petace
@@ -19,6 +19,7 @@
 #include <vector>
 
 #include "network/network.h"
+#include "solo/prng.h"
 
 #include "verse/util/defines.h"
 
@@ -60,6 +61,42 @@ class OtExtReceiver {
     virtual void receive(const std::shared_ptr<network::Network>& net, const std::vector<block>& choices,
             std::vector<block>& messages) = 0;
 
+    /**
+     * @brief The receiver gets chosen messages of msg_len bytes; each block message is stretched by a PRG.
+     *
+     * @param[in] net The network interface (e.g., PETAce-Network interface).
+     * @param[in] choices The chosen bits of receiver.
+     * @param[out] messages The chosen messages; m_c of ot i starts at byte i * msg_len.
+     * @param[in] msg_len The byte length of each message.
+     */
+    virtual void receive(const std::shared_ptr<network::Network>& net, const std::vector<block>& choices,
+            std::vector<solo::Byte>& messages, std::size_t msg_len);
+
+    /**
+     * @brief The receiver gets chosen messages sent by OtExtSender::send_chosen.
+     *
+     * Runs receive with random choices and derandomizes them with one round of packed correction bits.
+     *
+     * @param[in] net The network interface (e.g., PETAce-Network interface).
+     * @param[in] choices The chosen bits of receiver.
+     * @param[out] messages The chosen messages indexed by choices.
+     * @throws std::invalid_argument if choices hold fewer bits than extended ots.
+     */
+    virtual void receive_chosen(const std::shared_ptr<network::Network>& net, const std::vector<block>& choices,
+            std::vector<block>& messages);
+
+    /**
+     * @brief The receiver gets chosen messages of arbitrary length sent by OtExtSender::send_chosen.
+     *
+     * @param[in] net The network interface (e.g., PETAce-Network interface).
+     * @param[in] choices The chosen bits of receiver.
+     * @param[out] messages The chosen messages; m_c of ot i starts at byte i * msg_len.
+     * @param[in] msg_len The byte length of each message.
+     * @throws std::invalid_argument if choices hold fewer bits than extended ots.
+     */
+    virtual void receive_chosen(const std::shared_ptr<network::Network>& net, const std::vector<block>& choices,
+            std::vector<solo::Byte>& messages, std::size_t msg_len);
+
     std::size_t base_ot_sizes_ = 0;
 
     std::size_t ext_ot_sizes_ = 0;
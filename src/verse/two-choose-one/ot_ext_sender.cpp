@@ -0,0 +1,46 @@
+// Copyright 2023 TikTok Pte. Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "verse/two-choose-one/ot_ext_sender.h"
+
+#include "verse/two-choose-one/derandomize.h"
+#include "verse/util/aes.h"
+
+namespace petace {
+namespace verse {
+
+void OtExtSender::send(
+        const std::shared_ptr<network::Network>& net, std::vector<solo::Byte>& messages, std::size_t msg_len) {
+    std::vector<std::array<block, 2>> seeds;
+    send(net, seeds);
+    messages.resize(2 * seeds.size() * msg_len);
+    prg_stretch(seeds.data()->data(), 2 * seeds.size(), msg_len, messages.data());
+}
+
+void OtExtSender::send_chosen(
+        const std::shared_ptr<network::Network>& net, const std::vector<std::array<block, 2>>& inputs) {
+    std::vector<std::array<block, 2>> random_ots;
+    send(net, random_ots);
+    send_chosen_messages(net, random_ots, inputs);
+}
+
+void OtExtSender::send_chosen(
+        const std::shared_ptr<network::Network>& net, const std::vector<solo::Byte>& inputs, std::size_t msg_len) {
+    std::vector<std::array<block, 2>> random_ots;
+    send(net, random_ots);
+    send_chosen_messages(net, random_ots, inputs, msg_len);
+}
+
+}  // namespace verse
+}  // namespace petace
@@ -19,6 +19,7 @@
 #include <vector>
 
 #include "network/network.h"
+#include "solo/prng.h"
 
 #include "verse/util/defines.h"
 
@@ -57,6 +58,39 @@ class OtExtSender {
      */
     virtual void send(const std::shared_ptr<network::Network>& net, std::vector<std::array<block, 2>>& messages) = 0;
 
+    /**
+     * @brief The sender gets random messages of msg_len bytes; each block message is stretched by a PRG.
+     *
+     * @param[in] net The network interface (e.g., PETAce-Network interface).
+     * @param[out] messages The random output messages; m_b of ot i starts at byte (2 * i + b) * msg_len.
+     * @param[in] msg_len The byte length of each message.
+     */
+    virtual void send(
+            const std::shared_ptr<network::Network>& net, std::vector<solo::Byte>& messages, std::size_t msg_len);
+
+    /**
+     * @brief The sender transfers chosen messages; the receiver gets inputs[i][c_i].
+     *
+     * Runs send for random ots and derandomizes them with one round of packed correction bits.
+     *
+     * @param[in] net The network interface (e.g., PETAce-Network interface).
+     * @param[in] inputs The chosen messages of the sender; one pair per extended ot.
+     * @throws std::invalid_argument if inputs do not hold one pair per extended ot.
+     */
+    virtual void send_chosen(
+            const std::shared_ptr<network::Network>& net, const std::vector<std::array<block, 2>>& inputs);
+
+    /**
+     * @brief The sender transfers chosen messages of arbitrary length; the random ots seed a PRG for the pads.
+     *
+     * @param[in] net The network interface (e.g., PETAce-Network interface).
+     * @param[in] inputs The chosen messages; m_b of ot i starts at byte (2 * i + b) * msg_len.
+     * @param[in] msg_len The byte length of each message.
+     * @throws std::invalid_argument if inputs do not hold one pair per extended ot.
+     */
+    virtual void send_chosen(
+            const std::shared_ptr<network::Network>& net, const std::vector<solo::Byte>& inputs, std::size_t msg_len);
+
 protected:
     std::size_t base_ot_sizes_ = 0;
 
@@ -0,0 +1,221 @@
+// Copyright 2023 TikTok Pte. Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "verse/util/aes.h"
+
+#include <wmmintrin.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+namespace petace {
+namespace verse {
+
+namespace {
+
+// Number of independent AES streams kept in flight to hide the aesenc latency.
+const std::size_t kAesBatch = 8;
+
+// Inputs of tccr_hash per pass; its two encryption rounds run over the whole batch.
+const std::size_t kTccrBatch = 64;
+
+template <int Rcon>
+inline block expand_round(block key) {
+    block assist = _mm_shuffle_epi32(_mm_aeskeygenassist_si128(key, Rcon), 0xff);
+    key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+    key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+    key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+    return _mm_xor_si128(key, assist);
+}
+
+template <int Rcon>
+inline void expand_batch(AesRoundKeys* keys, std::size_t width, std::size_t round) {
+    for (std::size_t k = 0; k < width; k++) {
+        keys[k].rk[round] = expand_round<Rcon>(keys[k].rk[round - 1]);
+    }
+}
+
+// Expand the keys of up to kAesBatch seeds round by round so the independent schedules overlap.
+void expand_keys(const block* seeds, std::size_t width, AesRoundKeys* keys) {
+    for (std::size_t k = 0; k < width; k++) {
+        keys[k].rk[0] = _mm_loadu_si128(seeds + k);
+    }
+    expand_batch<0x01>(keys, width, 1);
+    expand_batch<0x02>(keys, width, 2);
+    expand_batch<0x04>(keys, width, 3);
+    expand_batch<0x08>(keys, width, 4);
+    expand_batch<0x10>(keys, width, 5);
+    expand_batch<0x20>(keys, width, 6);
+    expand_batch<0x40>(keys, width, 7);
+    expand_batch<0x80>(keys, width, 8);
+    expand_batch<0x1b>(keys, width, 9);
+    expand_batch<0x36>(keys, width, 10);
+}
+
+// Encrypt data[k] under keys[k] for k < width.
+inline void encrypt_multi_key(const AesRoundKeys* keys, std::size_t width, block* data) {
+    for (std::size_t k = 0; k < width; k++) {
+        data[k] = _mm_xor_si128(data[k], keys[k].rk[0]);
+    }
+    for (std::size_t r = 1; r < 10; r++) {
+        for (std::size_t k = 0; k < width; k++) {
+            data[k] = _mm_aesenc_si128(data[k], keys[k].rk[r]);
+        }
+    }
+    for (std::size_t k = 0; k < width; k++) {
+        data[k] = _mm_aesenclast_si128(data[k], keys[k].rk[10]);
+    }
+}
+
+}  // namespace
+
+void aes_expand_key(const block& key, AesRoundKeys& keys) {
+    expand_keys(&key, 1, &keys);
+}
+
+void aes_ecb_encrypt(const AesRoundKeys& keys, block* data, std::size_t nblock) {
+    std::size_t i = 0;
+    for (; i + kAesBatch <= nblock; i += kAesBatch) {
+        block* batch = data + i;
+        for (std::size_t k = 0; k < kAesBatch; k++) {
+            batch[k] = _mm_xor_si128(batch[k], keys.rk[0]);
+        }
+        for (std::size_t r = 1; r < 10; r++) {
+            for (std::size_t k = 0; k < kAesBatch; k++) {
+                batch[k] = _mm_aesenc_si128(batch[k], keys.rk[r]);
+            }
+        }
+        for (std::size_t k = 0; k < kAesBatch; k++) {
+            batch[k] = _mm_aesenclast_si128(batch[k], keys.rk[10]);
+        }
+    }
+    for (; i < nblock; i++) {
+        block b = _mm_xor_si128(data[i], keys.rk[0]);
+        for (std::size_t r = 1; r < 10; r++) {
+            b = _mm_aesenc_si128(b, keys.rk[r]);
+        }
+        data[i] = _mm_aesenclast_si128(b, keys.rk[10]);
+    }
+}
+
+const AesRoundKeys& fixed_aes_keys() {
+    static const AesRoundKeys keys = [] {
+        AesRoundKeys expanded;
+        block key = _mm_set_epi64x(static_cast<long long>(kFixedAesKey[1]), static_cast<long long>(kFixedAesKey[0]));
+        aes_expand_key(key, expanded);
+        return expanded;
+    }();
+    return keys;
+}
+
+void tccr_hash(const block* in, const block& offset, std::uint64_t index, block* out, std::size_t n) {
+    const AesRoundKeys& keys = fixed_aes_keys();
+    block px[kTccrBatch];
+    for (std::size_t begin = 0; begin < n; begin += kTccrBatch) {
+        std::size_t len = std::min(kTccrBatch, n - begin);
+        for (std::size_t j = 0; j < len; j++) {
+            px[j] = _mm_xor_si128(in[begin + j], offset);
+        }
+        aes_ecb_encrypt(keys, px, len);
+        for (std::size_t j = 0; j < len; j++) {
+            out[begin + j] = _mm_xor_si128(px[j], _mm_set_epi64x(0, static_cast<long long>(index + begin + j)));
+        }
+        aes_ecb_encrypt(keys, out + begin, len);
+        for (std::size_t j = 0; j < len; j++) {
+            out[begin + j] = _mm_xor_si128(out[begin + j], px[j]);
+        }
+    }
+}
+
+void prg_stretch(const block* seeds, std::size_t n, std::size_t len, solo::Byte* out) {
+    std::size_t nblock = len / sizeof(block);
+    std::size_t tail = len % sizeof(block);
+    AesRoundKeys keys[kAesBatch];
+    block ctr[kAesBatch];
+    for (std::size_t begin = 0; begin < n; begin += kAesBatch) {
+        std::size_t width = std::min(kAesBatch, n - begin);
+        expand_keys(seeds + begin, width, keys);
+        solo::Byte* dst = out + begin * len;
+        for (std::size_t j = 0; j < nblock; j++) {
+            for (std::size_t k = 0; k < width; k++) {
+                ctr[k] = _mm_set_epi64x(0, static_cast<std::int64_t>(j));
+            }
+            encrypt_multi_key(keys, width, ctr);
+            for (std::size_t k = 0; k < width; k++) {
+                _mm_storeu_si128(reinterpret_cast<block*>(dst + k * len + j * sizeof(block)), ctr[k]);
+            }
+        }
+        if (tail != 0) {
+            for (std::size_t k = 0; k < width; k++) {
+                ctr[k] = _mm_set_epi64x(0, static_cast<std::int64_t>(nblock));
+            }
+            encrypt_multi_key(keys, width, ctr);
+            for (std::size_t k = 0; k < width; k++) {
+                memcpy(dst + k * len + nblock * sizeof(block), ctr + k, tail);
+            }
+        }
+    }
+}
+
+void MultiKeyPrg::reset(const block* keys, std::size_t n) {
+    keys_.resize(n);
+    for (std::size_t begin = 0; begin < n; begin += kAesBatch) {
+        expand_keys(keys + begin, std::min(kAesBatch, n - begin), keys_.data() + begin);
+    }
+    counter_ = 0;
+}
+
+void MultiKeyPrg::generate(std::size_t nblock, block* out, std::size_t stride) {
+    generate_at(counter_, nblock, out, stride);
+    counter_ += nblock;
+}
+
+void MultiKeyPrg::generate_at(std::uint64_t counter, std::size_t nblock, block* out, std::size_t stride) const {
+    std::size_t full = nblock - nblock % kAesBatch;
+    std::size_t n = keys_.size();
+    block ctr[kAesBatch];
+    for (std::size_t i = 0; i < n; i++) {
+        const AesRoundKeys& keys = keys_[i];
+        block* row = out + i * stride;
+        for (std::size_t j = 0; j < full; j += kAesBatch) {
+            for (std::size_t k = 0; k < kAesBatch; k++) {
+                ctr[k] = _mm_xor_si128(_mm_set_epi64x(0, static_cast<std::int64_t>(counter + j + k)), keys.rk[0]);
+            }
+            for (std::size_t r = 1; r < 10; r++) {
+                for (std::size_t k = 0; k < kAesBatch; k++) {
+                    ctr[k] = _mm_aesenc_si128(ctr[k], keys.rk[r]);
+                }
+            }
+            for (std::size_t k = 0; k < kAesBatch; k++) {
+                _mm_storeu_si128(row + j + k, _mm_aesenclast_si128(ctr[k], keys.rk[10]));
+            }
+        }
+    }
+    for (std::size_t j = full; j < nblock; j++) {
+        for (std::size_t begin = 0; begin < n; begin += kAesBatch) {
+            std::size_t width = std::min(kAesBatch, n - begin);
+            for (std::size_t k = 0; k < width; k++) {
+                ctr[k] = _mm_set_epi64x(0, static_cast<std::int64_t>(counter + j));
+            }
+            encrypt_multi_key(keys_.data() + begin, width, ctr);
+            for (std::size_t k = 0; k < width; k++) {
+                _mm_storeu_si128(out + (begin + k) * stride + j, ctr[k]);
+            }
+        }
+    }
+}
+
+}  // namespace verse
+}  // namespace petace
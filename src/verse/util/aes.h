@@ -0,0 +1,167 @@
+// Copyright 2023 TikTok Pte. Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "solo/prng.h"
+
+#include "verse/util/defines.h"
+
+namespace petace {
+namespace verse {
+
+/**
+ * @brief Expanded AES-128 encryption round keys.
+ */
+struct AesRoundKeys {
+    block rk[11];
+};
+
+// Key of the fixed-key permutation pi behind the correlation robust hashes, low word first: hex digits of pi.
+const std::uint64_t kFixedAesKey[2] = {0x13198a2e03707344ULL, 0x243f6a8885a308d3ULL};
+
+/**
+ * @brief Expand an AES-128 key with AES-NI.
+ *
+ * @param[in] key The 128-bit key.
+ * @param[out] keys The expanded round keys.
+ */
+void aes_expand_key(const block& key, AesRoundKeys& keys);
+
+/**
+ * @brief Encrypt blocks in place with AES-128 in ECB mode, eight blocks in flight.
+ *
+ * @param[in] keys The expanded round keys.
+ * @param[in,out] data The blocks to encrypt.
+ * @param[in] nblock The number of blocks.
+ */
+void aes_ecb_encrypt(const AesRoundKeys& keys, block* data, std::size_t nblock);
+
+/**
+ * @brief Return the round keys of the fixed-key permutation pi, AES-128 under kFixedAesKey.
+ */
+const AesRoundKeys& fixed_aes_keys();
+
+/**
+ * @brief Compute out[j] = H(index + j, in[j] ^ offset) with the tweakable correlation robust hash
+ * H(i, x) = pi(pi(x) ^ i) ^ pi(x) built from the fixed-key permutation pi.
+ *
+ * @param[in] in The inputs.
+ * @param[in] offset Xored into every input, e.g. the correlation of an ot extension sender.
+ * @param[in] index The tweak of the first input.
+ * @param[out] out The hashes; may be the same buffer as in.
+ * @param[in] n The number of inputs.
+ */
+void tccr_hash(const block* in, const block& offset, std::uint64_t index, block* out, std::size_t n);
+
+/**
+ * @brief Expand each 128-bit seed into len pseudorandom bytes with AES-128 in CTR mode keyed by the seed.
+ *
+ * Seeds are processed in batches whose key schedules and counter blocks are interleaved, and keystream is written
+ * straight into the output, so long outputs cost little more than memory bandwidth.
+ *
+ * @param[in] seeds The seeds.
+ * @param[in] n The number of seeds.
+ * @param[in] len The number of bytes generated per seed.
+ * @param[out] out The output buffer of n * len bytes; the bytes of seed i start at out + i * len.
+ */
+void prg_stretch(const block* seeds, std::size_t n, std::size_t len, solo::Byte* out);
+
+/**
+ * @brief Many AES-128 CTR streams, one per key, expanded together into a row-major matrix.
+ *
+ * Stream i produces AES_{k_i}(0), AES_{k_i}(1), ..., the same keystream as prg_stretch. All streams share one counter
+ * that every generate call advances, so repeated batches continue the streams without reseeding. Key schedules are
+ * expanded once when the keys are set. Full groups of eight counter blocks are encrypted per key with its round keys
+ * kept in registers, and the remaining blocks are interleaved across eight keys.
+ */
+class MultiKeyPrg {
+public:
+    MultiKeyPrg() {
+    }
+
+    /**
+     * @brief Create streams for the given keys, starting at counter zero.
+     *
+     * @param[in] keys The keys.
+     * @param[in] n The number of keys.
+     */
+    MultiKeyPrg(const block* keys, std::size_t n) {
+        reset(keys, n);
+    }
+
+    /**
+     * @brief Replace the keys and restart at counter zero.
+     *
+     * @param[in] keys The keys.
+     * @param[in] n The number of keys.
+     */
+    void reset(const block* keys, std::size_t n);
+
+    /**
+     * @brief Write the next nblock blocks of every stream; stream i goes to out + i * stride.
+     *
+     * @param[in] nblock The number of blocks per stream.
+     * @param[out] out The matrix.
+     * @param[in] stride The distance in blocks between the rows of two streams; at least nblock.
+     */
+    void generate(std::size_t nblock, block* out, std::size_t stride);
+
+    /**
+     * @brief Write nblock blocks of every stream starting at the given counter, without moving the shared counter.
+     *
+     * Safe to call from several threads at once, e.g. to expand disjoint column tiles in parallel.
+     *
+     * @param[in] counter The counter of the first block.
+     * @param[in] nblock The number of blocks per stream.
+     * @param[out] out The matrix.
+     * @param[in] stride The distance in blocks between the rows of two streams; at least nblock.
+     */
+    void generate_at(std::uint64_t counter, std::size_t nblock, block* out, std::size_t stride) const;
+
+    /**
+     * @brief Return the number of streams.
+     */
+    std::size_t size() const {
+        return keys_.size();
+    }
+
+    /**
+     * @brief Return the counter of the next block.
+     */
+    std::uint64_t counter() const {
+        return counter_;
+    }
+
+    /**
+     * @brief Resume the streams at a saved counter.
+     *
+     * @param[in] counter The counter of the next block.
+     */
+    void set_counter(std::uint64_t counter) {
+        counter_ = counter;
+    }
+
+private:
+    std::vector<AesRoundKeys> keys_{};
+
+    std::uint64_t counter_ = 0;
+};
+
+}  // namespace verse
+}  // namespace petace
@@ -0,0 +1,124 @@
+// Copyright 2023 TikTok Pte. Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "verse/util/buffer.h"
+
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <new>
+
+#include "verse/util/numa.h"
+
+namespace petace {
+namespace verse {
+
+namespace {
+
+const std::size_t kBufferAlignment = 64;
+
+std::size_t page_length(std::size_t nbyte) {
+    static const std::size_t page = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    return (nbyte + page - 1) / page * page;
+}
+
+}  // namespace
+
+void* AlignedAllocator::allocate(std::size_t nbyte) {
+    void* ptr = nullptr;
+    if (posix_memalign(&ptr, kBufferAlignment, nbyte) != 0) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void AlignedAllocator::deallocate(void* ptr, std::size_t nbyte) {
+    (void)nbyte;
+    free(ptr);
+}
+
+void* NumaAllocator::allocate(std::size_t nbyte) {
+    std::size_t length = page_length(nbyte);
+    void* ptr = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (ptr == MAP_FAILED) {
+        throw std::bad_alloc();
+    }
+    if (numa_node_ >= 0) {
+        bind_memory_to_numa_node(ptr, length, numa_node_);
+    }
+    return ptr;
+}
+
+void NumaAllocator::deallocate(void* ptr, std::size_t nbyte) {
+    munmap(ptr, page_length(nbyte));
+}
+
+void* HugePageAllocator::allocate(std::size_t nbyte) {
+    if (nbyte < kHugePageBytes) {
+        if (numa_node_ >= 0) {
+            return NumaAllocator(numa_node_).allocate(nbyte);
+        }
+        return AlignedAllocator().allocate(nbyte);
+    }
+    std::size_t length = (nbyte + kHugePageBytes - 1) / kHugePageBytes * kHugePageBytes;
+    void* ptr = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (ptr == MAP_FAILED) {
+        ptr = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (ptr == MAP_FAILED) {
+            throw std::bad_alloc();
+        }
+#ifdef MADV_HUGEPAGE
+        madvise(ptr, length, MADV_HUGEPAGE);
+#endif
+    }
+    // Pages are placed on first touch, so the policy set here decides where the matrix lives.
+    if (numa_node_ >= 0) {
+        bind_memory_to_numa_node(ptr, length, numa_node_);
+    }
+    return ptr;
+}
+
+void HugePageAllocator::deallocate(void* ptr, std::size_t nbyte) {
+    if (nbyte < kHugePageBytes) {
+        if (numa_node_ >= 0) {
+            NumaAllocator(numa_node_).deallocate(ptr, nbyte);
+            return;
+        }
+        AlignedAllocator().deallocate(ptr, nbyte);
+        return;
+    }
+    munmap(ptr, (nbyte + kHugePageBytes - 1) / kHugePageBytes * kHugePageBytes);
+}
+
+std::shared_ptr<BufferAllocator> default_buffer_allocator() {
+    static std::shared_ptr<BufferAllocator> allocator = std::make_shared<AlignedAllocator>();
+    return allocator;
+}
+
+std::shared_ptr<BufferAllocator> buffer_allocator(const VerseParams& params) {
+    if (params.allocator != nullptr) {
+        return params.allocator;
+    }
+    if (params.huge_pages) {
+        return std::make_shared<HugePageAllocator>(params.numa_node);
+    }
+    if (params.numa_node >= 0) {
+        return std::make_shared<NumaAllocator>(params.numa_node);
+    }
+    return nullptr;
+}
+
+}  // namespace verse
+}  // namespace petace
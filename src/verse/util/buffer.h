@@ -0,0 +1,244 @@
+// Copyright 2023 TikTok Pte. Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include "verse/util/defines.h"
+
+namespace petace {
+namespace verse {
+
+/**
+ * @brief Source of the memory behind the work buffers of the ot engines.
+ *
+ * Engines take an allocator through VerseParams, so callers can place their matrices in a custom arena.
+ */
+class BufferAllocator {
+public:
+    virtual ~BufferAllocator() {
+    }
+
+    /**
+     * @brief Return nbyte bytes aligned to at least 64 bytes.
+     *
+     * @param[in] nbyte The number of bytes; never zero.
+     * @throws std::bad_alloc if the memory cannot be allocated.
+     */
+    virtual void* allocate(std::size_t nbyte) = 0;
+
+    /**
+     * @brief Release memory returned by allocate.
+     *
+     * @param[in] ptr The memory.
+     * @param[in] nbyte The size passed to allocate.
+     */
+    virtual void deallocate(void* ptr, std::size_t nbyte) = 0;
+};
+
+/**
+ * @brief Cache-line aligned heap memory.
+ */
+class AlignedAllocator : public BufferAllocator {
+public:
+    void* allocate(std::size_t nbyte) override;
+
+    void deallocate(void* ptr, std::size_t nbyte) override;
+};
+
+/**
+ * @brief Memory on normal pages placed on one NUMA node.
+ *
+ * Every request is mapped separately and rounded up to whole pages, so the node policy never applies to memory shared
+ * with unrelated heap objects.
+ */
+class NumaAllocator : public BufferAllocator {
+public:
+    /**
+     * @brief Create an allocator.
+     *
+     * @param[in] numa_node The node the mapped pages should live on; -1 leaves placement to the kernel.
+     */
+    explicit NumaAllocator(int numa_node) : numa_node_(numa_node) {
+    }
+
+    void* allocate(std::size_t nbyte) override;
+
+    void deallocate(void* ptr, std::size_t nbyte) override;
+
+private:
+    int numa_node_ = -1;
+};
+
+// Size of a transparent or explicit huge page on x86-64.
+const std::size_t kHugePageBytes = std::size_t(2) << 20;
+
+/**
+ * @brief Memory for large matrices on 2 MB huge pages, optionally placed on one NUMA node.
+ *
+ * Requests of at least kHugePageBytes are mapped with MAP_HUGETLB. When no explicit huge pages are reserved, the
+ * mapping falls back to normal pages with a madvise(MADV_HUGEPAGE) hint for transparent huge pages. Smaller requests
+ * come from the heap, or from a NumaAllocator when a node is given.
+ */
+class HugePageAllocator : public BufferAllocator {
+public:
+    /**
+     * @brief Create an allocator.
+     *
+     * @param[in] numa_node The node the mapped pages should live on; -1 leaves placement to the kernel.
+     */
+    explicit HugePageAllocator(int numa_node = -1) : numa_node_(numa_node) {
+    }
+
+    void* allocate(std::size_t nbyte) override;
+
+    void deallocate(void* ptr, std::size_t nbyte) override;
+
+private:
+    int numa_node_ = -1;
+};
+
+/**
+ * @brief Return the process-wide allocator used when none is given.
+ */
+std::shared_ptr<BufferAllocator> default_buffer_allocator();
+
+/**
+ * @brief Return the allocator an engine should use for the given parameters.
+ *
+ * huge_pages selects a HugePageAllocator; numa_node alone selects a NumaAllocator.
+ *
+ * @param[in] params The parameters; an explicit allocator wins over huge_pages and numa_node.
+ * @return The allocator, or null for the default.
+ */
+std::shared_ptr<BufferAllocator> buffer_allocator(const VerseParams& params);
+
+/**
+ * @brief A growable array of trivially copyable elements that is never zero-filled.
+ *
+ * Resizing within the capacity is free, so an engine that keeps its buffers across calls allocates only while batches
+ * grow and performs no heap allocation in steady state.
+ */
+template <class T>
+class Buffer {
+    static_assert(std::is_trivially_copyable<T>::value, "Buffer only holds trivially copyable elements.");
+
+public:
+    /**
+     * @brief Create an empty buffer.
+     *
+     * @param[in] allocator The allocator; null uses default_buffer_allocator().
+     */
+    explicit Buffer(std::shared_ptr<BufferAllocator> allocator = nullptr)
+            : allocator_(allocator == nullptr ? default_buffer_allocator() : std::move(allocator)) {
+    }
+
+    ~Buffer() {
+        release();
+    }
+
+    Buffer(const Buffer&) = delete;
+    Buffer& operator=(const Buffer&) = delete;
+
+    Buffer(Buffer&& other) noexcept
+            : allocator_(std::move(other.allocator_)),
+              data_(other.data_),
+              size_(other.size_),
+              capacity_(other.capacity_) {
+        other.data_ = nullptr;
+        other.size_ = 0;
+        other.capacity_ = 0;
+    }
+
+    Buffer& operator=(Buffer&& other) noexcept {
+        if (this != &other) {
+            release();
+            allocator_ = std::move(other.allocator_);
+            data_ = other.data_;
+            size_ = other.size_;
+            capacity_ = other.capacity_;
+            other.data_ = nullptr;
+            other.size_ = 0;
+            other.capacity_ = 0;
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Make the buffer hold n elements without initializing them.
+     *
+     * The contents are kept when n fits the capacity and are unspecified after the buffer grows.
+     *
+     * @param[in] n The number of elements.
+     * @return The data.
+     */
+    T* resize(std::size_t n) {
+        if (n > capacity_) {
+            release();
+            data_ = static_cast<T*>(allocator_->allocate(n * sizeof(T)));
+            capacity_ = n;
+        }
+        size_ = n;
+        return data_;
+    }
+
+    T* data() {
+        return data_;
+    }
+
+    const T* data() const {
+        return data_;
+    }
+
+    std::size_t size() const {
+        return size_;
+    }
+
+    std::size_t capacity() const {
+        return capacity_;
+    }
+
+    T& operator[](std::size_t i) {
+        return data_[i];
+    }
+
+    const T& operator[](std::size_t i) const {
+        return data_[i];
+    }
+
+private:
+    void release() {
+        if (data_ != nullptr) {
+            allocator_->deallocate(data_, capacity_ * sizeof(T));
+            data_ = nullptr;
+        }
+        size_ = 0;
+        capacity_ = 0;
+    }
+
+    std::shared_ptr<BufferAllocator> allocator_ = nullptr;
+
+    T* data_ = nullptr;
+
+    std::size_t size_ = 0;
+
+    std::size_t capacity_ = 0;
+};
+
+}  // namespace verse
+}  // namespace petace
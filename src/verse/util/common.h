@@ -16,10 +16,14 @@
 
 #include <emmintrin.h>
 
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
 #include <memory>
 #include <stdexcept>
 #include <vector>
 
+#include "solo/hash.h"
 #include "solo/prng.h"
 
 #include "verse/util/defines.h"
@@ -33,20 +37,36 @@ inline block read_block_from_dev_urandom() {
     return ret;
 }
 
+/**
+ * @brief Return a SHA-256 instance owned by the calling thread, so hot loops do not create one per call.
+ */
+inline solo::Hash& thread_sha256() {
+    thread_local std::unique_ptr<solo::Hash> hash = solo::Hash::create(solo::HashScheme::SHA_256);
+    return *hash;
+}
+
 inline std::size_t bit_from_blocks(const std::vector<block>& input, std::size_t ids_of_bits) {
     const std::uint8_t* bits = reinterpret_cast<const std::uint8_t*>(input.data());
     std::size_t ret = static_cast<std::size_t>(bits[ids_of_bits / 8]) >> (ids_of_bits % 8);
     return ret & 1;
 }
 
-inline void matrix_transpose(
-        const std::vector<block>& in, std::size_t rows, std::size_t cols, std::vector<block>& out) {
+/**
+ * @brief Transpose a rows x cols bit matrix stored row by row into a cols x rows bit matrix.
+ *
+ * @param[in] in The input matrix, rows * cols / 128 blocks.
+ * @param[in] rows The number of rows; a multiple of 128.
+ * @param[in] cols The number of columns; a multiple of 128.
+ * @param[out] out The output matrix, rows * cols / 128 blocks.
+ * @throws std::invalid_argument if a dimension is not a multiple of 128.
+ */
+inline void matrix_transpose(const block* in, std::size_t rows, std::size_t cols, block* out) {
     if ((rows % 128 != 0) || (cols % 128 != 0)) {
         throw std::invalid_argument("Transpose size is not supported.");
     }
 
-    char* ptr_in = reinterpret_cast<char*>(const_cast<block*>(in.data()));
-    char* ptr_out = reinterpret_cast<char*>(const_cast<block*>(out.data()));
+    const char* ptr_in = reinterpret_cast<const char*>(in);
+    char* ptr_out = reinterpret_cast<char*>(out);
 
     auto f = [&](std::size_t x, std::size_t y) { return ptr_in[x * cols / 8 + y / 8]; };
     auto g = [&](std::size_t x, std::size_t y) { return &ptr_out[y * rows / 8 + x / 8]; };
@@ -67,12 +87,73 @@ inline void matrix_transpose(
     return;
 }
 
+inline void matrix_transpose(
+        const std::vector<block>& in, std::size_t rows, std::size_t cols, std::vector<block>& out) {
+    matrix_transpose(in.data(), rows, cols, out.data());
+}
+
+// Wire format version carried by every frame; bump it when a protocol message layout changes.
+const std::uint32_t kFrameVersion = 1;
+
+// Payload bytes handed to the network per call, kept below common default socket buffer sizes.
+const std::size_t kFrameChunkBytes = std::size_t(1) << 17;
+
+/**
+ * @brief Header that precedes the payload of every frame.
+ */
+struct FrameHeader {
+    std::uint32_t version;
+    std::uint32_t reserved;
+    std::uint64_t length;
+};
+
+/**
+ * @brief Send nbyte bytes as one frame: a header followed by the payload in chunks of kFrameChunkBytes.
+ *
+ * The header is sent on its own, so the payload goes out straight from data without being copied.
+ *
+ * @param[in] net The network interface (e.g., PETAce-Network interface).
+ * @param[in] data The payload.
+ * @param[in] nbyte The payload length in bytes.
+ */
+inline void send_frame(const std::shared_ptr<network::Network>& net, const void* data, std::size_t nbyte) {
+    const char* payload = static_cast<const char*>(data);
+    FrameHeader header{kFrameVersion, 0, static_cast<std::uint64_t>(nbyte)};
+    net->send_data(&header, sizeof(header));
+    for (std::size_t offset = 0; offset < nbyte; offset += kFrameChunkBytes) {
+        net->send_data(payload + offset, std::min(kFrameChunkBytes, nbyte - offset));
+    }
+}
+
+/**
+ * @brief Receive a frame sent by send_frame whose payload is expected to be nbyte bytes.
+ *
+ * The header is checked before any payload is read, so a frame of another length fails at once instead of waiting
+ * for bytes that never come.
+ *
+ * @param[in] net The network interface (e.g., PETAce-Network interface).
+ * @param[out] data The payload.
+ * @param[in] nbyte The expected payload length in bytes.
+ * @throws std::runtime_error if the frame version or length does not match.
+ */
+inline void recv_frame(const std::shared_ptr<network::Network>& net, void* data, std::size_t nbyte) {
+    char* payload = static_cast<char*>(data);
+    FrameHeader header;
+    net->recv_data(&header, sizeof(header));
+    if (header.version != kFrameVersion || header.length != static_cast<std::uint64_t>(nbyte)) {
+        throw std::runtime_error("Frame does not match the expected message.");
+    }
+    for (std::size_t offset = 0; offset < nbyte; offset += kFrameChunkBytes) {
+        net->recv_data(payload + offset, std::min(kFrameChunkBytes, nbyte - offset));
+    }
+}
+
 inline void send_block(const std::shared_ptr<network::Network>& net, const block* data, std::size_t nblock) {
-    net->send_data(data, nblock * sizeof(block));
+    send_frame(net, data, nblock * sizeof(block));
 }
 
 inline void recv_block(const std::shared_ptr<network::Network>& net, block* data, std::size_t nblock) {
-    net->recv_data(data, nblock * sizeof(block));
+    recv_frame(net, data, nblock * sizeof(block));
 }
 
 }  // namespace verse
@@ -31,11 +31,31 @@ using EC = solo::ECOpenSSL;
 const std::size_t kEccPointLen = 33;
 const std::size_t kCurveID = 415;
 const std::size_t kHashDigestLen = 32;
+// The masked messages of 1-out-of-n chosen ots are streamed in frames of about this many blocks.
+const std::size_t kNcoChosenChunkBlocks = std::size_t(1) << 16;
+
+class BufferAllocator;
+class ThreadPool;
 
 struct VerseParams {
-    std::size_t base_ot_sizes;
-    std::size_t ext_ot_sizes;
+    std::size_t base_ot_sizes = 0;
+    std::size_t ext_ot_sizes = 0;
     std::shared_ptr<network::Network> net;
+    // Worker threads an extension may use locally; 1 keeps all work on the calling thread.
+    std::size_t num_threads = 1;
+    // Ots per streamed chunk of an extension; both parties must agree. 0 sends a batch as one chunk.
+    std::size_t chunk_size = 0;
+    // Memory for the work buffers of an extension; null uses default_buffer_allocator() unless one of the two
+    // placement options below asks for a HugePageAllocator or NumaAllocator.
+    std::shared_ptr<BufferAllocator> allocator = nullptr;
+    // Back large work buffers with 2 MB huge pages.
+    bool huge_pages = false;
+    // NUMA node for the work buffers and worker threads of an extension; -1 leaves placement to the kernel. The calling
+    // thread, which runs the first range of every parallel step, is not rebound; bind it with bind_thread_to_numa_node.
+    int numa_node = -1;
+    // Workers an extension runs its parallel steps on instead of starting num_threads - 1 of its own; one pool may be
+    // shared by many extensions. Only compute runs on it, never network calls.
+    std::shared_ptr<ThreadPool> pool = nullptr;
 };
 
 }  // namespace verse
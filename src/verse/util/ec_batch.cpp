@@ -0,0 +1,87 @@
+// Copyright 2023 TikTok Pte. Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "verse/util/ec_batch.h"
+
+#include <algorithm>
+#include <memory>
+#include <thread>
+
+namespace petace {
+namespace verse {
+
+namespace {
+
+// Below this many points per range, handing a range to a worker costs more than it saves.
+const std::size_t kMinPointsPerThread = 64;
+
+// Run job(ec, begin, end) over [0, n) split by parallel_for_parts: the calling thread takes range 0 with ec and each
+// pool worker uses a context of its own, created on first use, since OpenSSL contexts are not shared across threads.
+// An exception thrown by any range is rethrown on the calling thread once all ranges have finished.
+template <class Job>
+void parallel_over_points(const EC& ec, std::size_t n, ThreadPool* pool, const Job& job) {
+    if (n < 2 * kMinPointsPerThread) {
+        pool = nullptr;
+    }
+    parallel_for_parts(pool, n, [&ec, &job](std::size_t part, std::size_t begin, std::size_t end) {
+        if (part == 0) {
+            job(ec, begin, end);
+            return;
+        }
+        thread_local std::unique_ptr<EC> worker_ec = nullptr;
+        if (worker_ec == nullptr) {
+            worker_ec.reset(new EC(kCurveID, solo::HashScheme::SHA_256));
+        }
+        job(*worker_ec, begin, end);
+    });
+}
+
+}  // namespace
+
+ThreadPool* ec_thread_pool() {
+    static std::unique_ptr<ThreadPool> pool = [] {
+        std::size_t hardware = std::max<std::size_t>(1, std::thread::hardware_concurrency());
+        return hardware > 1 ? std::unique_ptr<ThreadPool>(new ThreadPool(hardware - 1)) : nullptr;
+    }();
+    return pool.get();
+}
+
+void points_to_bytes(const EC& ec, const std::shared_ptr<EC::Point>* points, std::size_t n, solo::Byte* out) {
+    points_to_bytes(ec, points, n, out, ec_thread_pool());
+}
+
+void points_from_bytes(const EC& ec, const solo::Byte* in, std::size_t n, const std::shared_ptr<EC::Point>* points) {
+    points_from_bytes(ec, in, n, points, ec_thread_pool());
+}
+
+void points_to_bytes(const EC& ec, const std::shared_ptr<EC::Point>* points, std::size_t n, solo::Byte* out,
+        ThreadPool* pool) {
+    parallel_over_points(ec, n, pool, [points, out](const EC& local_ec, std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; i++) {
+            local_ec.point_to_bytes(*points[i], kEccPointLen, out + i * kEccPointLen);
+        }
+    });
+}
+
+void points_from_bytes(const EC& ec, const solo::Byte* in, std::size_t n, const std::shared_ptr<EC::Point>* points,
+        ThreadPool* pool) {
+    parallel_over_points(ec, n, pool, [in, points](const EC& local_ec, std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; i++) {
+            local_ec.point_from_bytes(in + i * kEccPointLen, kEccPointLen, *points[i]);
+        }
+    });
+}
+
+}  // namespace verse
+}  // namespace petace
@@ -0,0 +1,76 @@
+// Copyright 2023 TikTok Pte. Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+
+#include "solo/ec_openssl.h"
+
+#include "verse/util/defines.h"
+#include "verse/util/thread_pool.h"
+
+namespace petace {
+namespace verse {
+
+/**
+ * @brief Return the pool shared by the batch point conversions: one worker per hardware thread besides the caller.
+ *
+ * @return The pool; null on a single hardware thread, where conversions stay on the calling thread.
+ */
+ThreadPool* ec_thread_pool();
+
+/**
+ * @brief Serialize points into consecutive kEccPointLen-byte slots, splitting the batch over a pool.
+ *
+ * Each worker converts a contiguous range with its own EC context, so the layout of out is the same as calling
+ * ec.point_to_bytes point by point.
+ *
+ * @param[in] ec The EC context used by the calling thread.
+ * @param[in] points The points.
+ * @param[in] n The number of points.
+ * @param[out] out The n * kEccPointLen bytes of the encodings.
+ * @param[in] pool The pool; null runs on the calling thread.
+ */
+void points_to_bytes(
+        const EC& ec, const std::shared_ptr<EC::Point>* points, std::size_t n, solo::Byte* out, ThreadPool* pool);
+
+/**
+ * @brief Serialize points on the pool returned by ec_thread_pool.
+ */
+void points_to_bytes(const EC& ec, const std::shared_ptr<EC::Point>* points, std::size_t n, solo::Byte* out);
+
+/**
+ * @brief Deserialize points from consecutive kEccPointLen-byte slots, splitting the batch over a pool.
+ *
+ * Decompression takes a square root per point, which makes this the expensive direction. Invalid encodings from a
+ * peer make the conversion throw; the exception reaches the caller after all ranges have finished.
+ *
+ * @param[in] ec The EC context used by the calling thread.
+ * @param[in] in The n * kEccPointLen bytes of the encodings.
+ * @param[in] n The number of points.
+ * @param[out] points The points; they must be allocated.
+ * @param[in] pool The pool; null runs on the calling thread.
+ */
+void points_from_bytes(const EC& ec, const solo::Byte* in, std::size_t n, const std::shared_ptr<EC::Point>* points,
+        ThreadPool* pool);
+
+/**
+ * @brief Deserialize points on the pool returned by ec_thread_pool.
+ */
+void points_from_bytes(const EC& ec, const solo::Byte* in, std::size_t n, const std::shared_ptr<EC::Point>* points);
+
+}  // namespace verse
+}  // namespace petace
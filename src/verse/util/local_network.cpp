@@ -0,0 +1,66 @@
+// Copyright 2023 TikTok Pte. Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "verse/util/local_network.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace petace {
+namespace verse {
+
+std::pair<std::shared_ptr<network::Network>, std::shared_ptr<network::Network>> LocalNetwork::create_pair() {
+    auto a_to_b = std::make_shared<Channel>();
+    auto b_to_a = std::make_shared<Channel>();
+    std::shared_ptr<network::Network> a(new LocalNetwork(a_to_b, b_to_a));
+    std::shared_ptr<network::Network> b(new LocalNetwork(b_to_a, a_to_b));
+    return std::make_pair(a, b);
+}
+
+int LocalNetwork::send_data(const void* data, std::size_t nbyte) {
+    if (nbyte == 0) {
+        return 0;
+    }
+    const char* ptr = reinterpret_cast<const char*>(data);
+    {
+        std::lock_guard<std::mutex> lock(out_->mutex);
+        out_->chunks.emplace_back(ptr, ptr + nbyte);
+    }
+    out_->cv.notify_one();
+    bytes_sent_ += nbyte;
+    return static_cast<int>(nbyte);
+}
+
+int LocalNetwork::recv_data(void* data, std::size_t nbyte) {
+    char* ptr = reinterpret_cast<char*>(data);
+    std::size_t done = 0;
+    std::unique_lock<std::mutex> lock(in_->mutex);
+    while (done < nbyte) {
+        in_->cv.wait(lock, [this] { return !in_->chunks.empty(); });
+        auto& front = in_->chunks.front();
+        std::size_t len = std::min(nbyte - done, front.size() - in_->offset);
+        memcpy(ptr + done, front.data() + in_->offset, len);
+        done += len;
+        in_->offset += len;
+        if (in_->offset == front.size()) {
+            in_->chunks.pop_front();
+            in_->offset = 0;
+        }
+    }
+    bytes_received_ += nbyte;
+    return static_cast<int>(nbyte);
+}
+
+}  // namespace verse
+}  // namespace petace
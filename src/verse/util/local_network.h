@@ -0,0 +1,84 @@
+// Copyright 2023 TikTok Pte. Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "network/network.h"
+
+namespace petace {
+namespace verse {
+
+/**
+ * @brief In-process network endpoint connected to a peer endpoint in the same process.
+ *
+ * Each direction is an unbounded byte queue, so send_data never blocks and recv_data blocks until enough bytes
+ * arrive. It is meant for running both parties of a protocol in one process, e.g., in tests or session servers.
+ */
+class LocalNetwork : public network::Network {
+public:
+    /**
+     * @brief Create two endpoints connected to each other.
+     *
+     * @return The two endpoints. Data sent on one is received on the other.
+     */
+    static std::pair<std::shared_ptr<network::Network>, std::shared_ptr<network::Network>> create_pair();
+
+    ~LocalNetwork() override {
+    }
+
+    int send_data(const void* data, std::size_t nbyte) override;
+
+    int recv_data(void* data, std::size_t nbyte) override;
+
+    void warmup() override {
+    }
+
+    std::size_t get_bytes_sent() const override {
+        return bytes_sent_;
+    }
+
+    std::size_t get_bytes_received() const override {
+        return bytes_received_;
+    }
+
+private:
+    struct Channel {
+        std::mutex mutex;
+        std::condition_variable cv;
+        std::deque<std::vector<char>> chunks;
+        std::size_t offset = 0;
+    };
+
+    LocalNetwork(std::shared_ptr<Channel> out, std::shared_ptr<Channel> in) : out_(out), in_(in) {
+    }
+
+    std::shared_ptr<Channel> out_ = nullptr;
+
+    std::shared_ptr<Channel> in_ = nullptr;
+
+    std::size_t bytes_sent_ = 0;
+
+    std::size_t bytes_received_ = 0;
+};
+
+}  // namespace verse
+}  // namespace petace
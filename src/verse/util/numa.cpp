@@ -0,0 +1,92 @@
+// Copyright 2023 TikTok Pte. Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "verse/util/numa.h"
+
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <fstream>
+#include <sstream>
+#include <string>
+
+namespace petace {
+namespace verse {
+
+namespace {
+
+// Memory policy of set_mempolicy(2) and mbind(2), defined here to avoid depending on libnuma.
+const int kMpolPreferred = 1;
+
+std::string node_path(int node) {
+    return "/sys/devices/system/node/node" + std::to_string(node);
+}
+
+}  // namespace
+
+std::size_t numa_node_count() {
+    std::size_t count = 0;
+    while (std::ifstream(node_path(static_cast<int>(count)) + "/cpulist").good()) {
+        count++;
+    }
+    return count == 0 ? 1 : count;
+}
+
+bool bind_thread_to_numa_node(int node) {
+    if (node < 0) {
+        return false;
+    }
+    std::ifstream file(node_path(node) + "/cpulist");
+    std::string list;
+    if (!std::getline(file, list)) {
+        return false;
+    }
+    // The list looks like "0-15,32-47".
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    std::stringstream ranges(list);
+    std::string range;
+    bool any = false;
+    while (std::getline(ranges, range, ',')) {
+        if (range.empty()) {
+            continue;
+        }
+        std::size_t dash = range.find('-');
+        int first = std::stoi(range.substr(0, dash));
+        int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+        for (int cpu = first; cpu <= last && cpu < CPU_SETSIZE; cpu++) {
+            CPU_SET(cpu, &set);
+            any = true;
+        }
+    }
+    return any && sched_setaffinity(0, sizeof(set), &set) == 0;
+}
+
+bool bind_memory_to_numa_node(void* ptr, std::size_t nbyte, int node) {
+    if (node < 0 || node >= static_cast<int>(sizeof(unsigned long) * 8)) {
+        return false;
+    }
+#ifdef SYS_mbind
+    unsigned long mask = 1UL << node;
+    return syscall(SYS_mbind, ptr, nbyte, kMpolPreferred, &mask, sizeof(mask) * 8, 0) == 0;
+#else
+    (void)ptr;
+    (void)nbyte;
+    return false;
+#endif
+}
+
+}  // namespace verse
+}  // namespace petace
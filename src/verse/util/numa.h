@@ -0,0 +1,49 @@
+// Copyright 2023 TikTok Pte. Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstddef>
+
+namespace petace {
+namespace verse {
+
+/**
+ * @brief Return the number of NUMA nodes of the host, or 1 if the topology is unknown.
+ */
+std::size_t numa_node_count();
+
+/**
+ * @brief Restrict the calling thread to the CPUs of a NUMA node.
+ *
+ * @param[in] node The node.
+ * @return false if the node does not exist or the affinity cannot be set; the thread is then left unchanged.
+ */
+bool bind_thread_to_numa_node(int node);
+
+/**
+ * @brief Ask the kernel to place the pages of a memory range on a NUMA node.
+ *
+ * The policy is preferred rather than strict, so allocation falls back to other nodes when the node is full. It only
+ * affects pages that are not yet touched.
+ *
+ * @param[in] ptr The page-aligned start of the range.
+ * @param[in] nbyte The length of the range.
+ * @param[in] node The node.
+ * @return false if the policy cannot be set.
+ */
+bool bind_memory_to_numa_node(void* ptr, std::size_t nbyte, int node);
+
+}  // namespace verse
+}  // namespace petace
@@ -0,0 +1,159 @@
+// Copyright 2023 TikTok Pte. Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "verse/util/striped_network.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace petace {
+namespace verse {
+
+namespace {
+
+// Call fn(stripe, begin, end) for every stripe of a call of nbyte bytes, starting at stripe first, that travels over
+// connection c of k.
+template <class Fn>
+void for_each_stripe(std::size_t c, std::size_t k, std::uint64_t first, std::size_t nbyte, std::size_t stripe_bytes,
+        const Fn& fn) {
+    std::size_t stripes = (nbyte + stripe_bytes - 1) / stripe_bytes;
+    std::size_t s = (c + k - static_cast<std::size_t>(first % k)) % k;
+    for (; s < stripes; s += k) {
+        std::size_t begin = s * stripe_bytes;
+        fn(begin, std::min(nbyte, begin + stripe_bytes));
+    }
+}
+
+}  // namespace
+
+StripedNetwork::StripedNetwork(
+        const std::vector<std::shared_ptr<network::Network>>& connections, std::size_t stripe_bytes)
+        : connections_(connections), stripe_bytes_(stripe_bytes) {
+    if (connections_.empty()) {
+        throw std::invalid_argument("striped network needs at least one connection.");
+    }
+    for (auto& connection : connections_) {
+        if (connection == nullptr) {
+            throw std::invalid_argument("connection is null.");
+        }
+    }
+    if (stripe_bytes_ == 0) {
+        throw std::invalid_argument("stripe size is zero.");
+    }
+    if (connections_.size() > 1) {
+        pool_.reset(new ThreadPool(connections_.size() - 1));
+    }
+}
+
+int StripedNetwork::send_data(const void* data, std::size_t nbyte) {
+    if (nbyte == 0) {
+        return 0;
+    }
+    const char* ptr = static_cast<const char*>(data);
+    std::size_t k = connections_.size();
+    std::uint64_t first = send_stripe_;
+    std::uint64_t length = static_cast<std::uint64_t>(nbyte);
+    std::size_t stripes = (nbyte + stripe_bytes_ - 1) / stripe_bytes_;
+    // The announcement leads the first stripe on its connection.
+    connections_[first % k]->send_data(&length, sizeof(length));
+    auto send_connection = [&](std::size_t c) {
+        for_each_stripe(c, k, first, nbyte, stripe_bytes_,
+                [&](std::size_t begin, std::size_t end) { connections_[c]->send_data(ptr + begin, end - begin); });
+    };
+    if (stripes == 1) {
+        send_connection(first % k);
+    } else {
+        parallel_for(pool_.get(), std::min(stripes, k), [&](std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; i++) {
+                send_connection((first + i) % k);
+            }
+        });
+    }
+    send_stripe_ += stripes;
+    return static_cast<int>(nbyte);
+}
+
+void StripedNetwork::recv_stripes(char* data, std::size_t nbyte, std::uint64_t first) {
+    std::size_t k = connections_.size();
+    std::size_t stripes = (nbyte + stripe_bytes_ - 1) / stripe_bytes_;
+    auto recv_connection = [&](std::size_t c) {
+        for_each_stripe(c, k, first, nbyte, stripe_bytes_,
+                [&](std::size_t begin, std::size_t end) { connections_[c]->recv_data(data + begin, end - begin); });
+    };
+    if (stripes == 1) {
+        recv_connection(first % k);
+        return;
+    }
+    parallel_for(pool_.get(), std::min(stripes, k), [&](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; i++) {
+            recv_connection((first + i) % k);
+        }
+    });
+}
+
+int StripedNetwork::recv_data(void* data, std::size_t nbyte) {
+    char* ptr = static_cast<char*>(data);
+    std::size_t k = connections_.size();
+    std::size_t done = 0;
+    while (done < nbyte) {
+        if (pending_offset_ < pending_.size()) {
+            std::size_t len = std::min(nbyte - done, pending_.size() - pending_offset_);
+            memcpy(ptr + done, pending_.data() + pending_offset_, len);
+            pending_offset_ += len;
+            done += len;
+            continue;
+        }
+        std::uint64_t length = 0;
+        connections_[recv_stripe_ % k]->recv_data(&length, sizeof(length));
+        std::size_t call = static_cast<std::size_t>(length);
+        std::uint64_t first = recv_stripe_;
+        recv_stripe_ += (call + stripe_bytes_ - 1) / stripe_bytes_;
+        // A call that fits is received in place; otherwise its tail is kept for the next recv_data.
+        if (call <= nbyte - done) {
+            recv_stripes(ptr + done, call, first);
+            done += call;
+        } else {
+            pending_.resize(call);
+            pending_offset_ = 0;
+            recv_stripes(pending_.data(), call, first);
+        }
+    }
+    return static_cast<int>(nbyte);
+}
+
+void StripedNetwork::warmup() {
+    for (auto& connection : connections_) {
+        connection->warmup();
+    }
+}
+
+std::size_t StripedNetwork::get_bytes_sent() const {
+    std::size_t bytes = 0;
+    for (auto& connection : connections_) {
+        bytes += connection->get_bytes_sent();
+    }
+    return bytes;
+}
+
+std::size_t StripedNetwork::get_bytes_received() const {
+    std::size_t bytes = 0;
+    for (auto& connection : connections_) {
+        bytes += connection->get_bytes_received();
+    }
+    return bytes;
+}
+
+}  // namespace verse
+}  // namespace petace
@@ -0,0 +1,109 @@
+// Copyright 2023 TikTok Pte. Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "network/network.h"
+
+#include "verse/util/thread_pool.h"
+
+namespace petace {
+namespace verse {
+
+// Default bytes per stripe; a kFrameChunkBytes chunk of a frame is spread over four connections.
+const std::size_t kDefaultStripeBytes = std::size_t(1) << 15;
+
+/**
+ * @brief Network that stripes every send over several parallel connections to the same peer.
+ *
+ * A single TCP flow is limited by its congestion window on long, fast links; K flows carry up to K times as much. Each
+ * send_data call is announced by an 8-byte length on the connection of its first stripe and cut into stripes of
+ * stripe_bytes. The stripes are numbered across calls, and stripe i travels over connection i % K, so the receiver
+ * knows where every stripe goes without further headers. During a call each connection is served by its own worker,
+ * and the calling thread serves one of them.
+ *
+ * Both ends must use the same number of connections, in the same order, and the same stripe size. Like the
+ * connections below it, a striped network must not be used by two threads at once, so no connection ever sends and
+ * receives concurrently.
+ *
+ * @par Example.
+ * Refer to striped_network_test.cpp.
+ */
+class StripedNetwork : public network::Network {
+public:
+    /**
+     * @brief Create a striped network over connected networks.
+     *
+     * @param[in] connections The connections to the peer, in the order the peer uses.
+     * @param[in] stripe_bytes The bytes per stripe.
+     * @throws std::invalid_argument if connections is empty or holds null, or stripe_bytes is zero.
+     */
+    explicit StripedNetwork(const std::vector<std::shared_ptr<network::Network>>& connections,
+            std::size_t stripe_bytes = kDefaultStripeBytes);
+
+    ~StripedNetwork() override {
+    }
+
+    int send_data(const void* data, std::size_t nbyte) override;
+
+    int recv_data(void* data, std::size_t nbyte) override;
+
+    void warmup() override;
+
+    /**
+     * @brief Return the bytes sent over all connections, including the length announcements.
+     */
+    std::size_t get_bytes_sent() const override;
+
+    /**
+     * @brief Return the bytes received over all connections, including the length announcements.
+     */
+    std::size_t get_bytes_received() const override;
+
+    /**
+     * @brief Return the number of connections.
+     */
+    std::size_t size() const {
+        return connections_.size();
+    }
+
+private:
+    // Receive the stripes of one announced call of nbyte bytes, starting at stripe first, into data.
+    void recv_stripes(char* data, std::size_t nbyte, std::uint64_t first);
+
+    std::vector<std::shared_ptr<network::Network>> connections_{};
+
+    std::size_t stripe_bytes_ = 0;
+
+    // Index of the next stripe in each direction.
+    std::uint64_t send_stripe_ = 0;
+
+    std::uint64_t recv_stripe_ = 0;
+
+    // Bytes of an announced call that did not fit into the recv_data call that received it.
+    std::vector<char> pending_{};
+
+    std::size_t pending_offset_ = 0;
+
+    // Serves all connections but one during a call.
+    std::unique_ptr<ThreadPool> pool_ = nullptr;
+};
+
+}  // namespace verse
+}  // namespace petace
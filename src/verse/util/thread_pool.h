@@ -0,0 +1,317 @@
+// Copyright 2023 TikTok Pte. Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace petace {
+namespace verse {
+
+/**
+ * @brief A fixed-size pool of worker threads executing tasks in FIFO order.
+ *
+ * Tasks are picked up in the order they are submitted, so a task that re-submits itself when it finishes goes to the
+ * back of the queue. Schedulers built on top of the pool rely on this to interleave work fairly.
+ *
+ * PETAce-Network sockets are blocking, so a task that runs a protocol step holds its worker while it waits for the
+ * peer. Size a pool that runs such tasks to the number of them that should progress at the same time.
+ */
+class ThreadPool {
+public:
+    /**
+     * @brief Start a pool with the given number of workers.
+     *
+     * @param[in] num_threads The number of worker threads.
+     * @param[in] on_start Run by every worker before it picks up tasks, e.g. to set its CPU affinity; may be null.
+     * @throws std::invalid_argument if num_threads is zero.
+     */
+    explicit ThreadPool(std::size_t num_threads, std::function<void()> on_start = nullptr) {
+        if (num_threads == 0) {
+            throw std::invalid_argument("thread pool needs at least one thread.");
+        }
+        for (std::size_t i = 0; i < num_threads; i++) {
+            workers_.emplace_back([this, on_start] {
+                if (on_start) {
+                    on_start();
+                }
+                worker_loop();
+            });
+        }
+    }
+
+    /**
+     * @brief Finish all queued tasks and join the workers.
+     */
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        cv_.notify_all();
+        for (auto& worker : workers_) {
+            worker.join();
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * @brief Queue a task for execution.
+     *
+     * @param[in] f The callable to execute on a worker thread.
+     * @return A future holding the result (or exception) of f.
+     */
+    template <class F>
+    std::future<typename std::result_of<F()>::type> submit(F&& f) {
+        using R = typename std::result_of<F()>::type;
+        auto task = std::make_shared<std::packaged_task<R()>>(std::forward<F>(f));
+        std::future<R> ret = task->get_future();
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (stop_) {
+                throw std::runtime_error("thread pool is stopped.");
+            }
+            tasks_.emplace([task] { (*task)(); });
+        }
+        cv_.notify_one();
+        return ret;
+    }
+
+    /**
+     * @brief Return the number of worker threads.
+     */
+    std::size_t size() const {
+        return workers_.size();
+    }
+
+    /**
+     * @brief Run fn(context, part, begin, end) for the ranges [part * step, min((part + 1) * step, n)) of [0, n).
+     *
+     * The call describes its ranges in one job on the caller's stack, so nothing is allocated. Part 0 runs on the
+     * calling thread, which then also runs the parts no worker has picked up yet. Idle workers serve such jobs before
+     * queued tasks. The first exception, preferring the one from part 0, is rethrown after every part has finished.
+     *
+     * @param[in] n The size of the range.
+     * @param[in] step The length of every range but the last; at least one.
+     * @param[in] fn The function run on every range; it must be safe to call concurrently on disjoint ranges.
+     * @param[in] context Passed to fn unchanged.
+     */
+    void run_parts(std::size_t n, std::size_t step,
+            void (*fn)(const void* context, std::size_t part, std::size_t begin, std::size_t end),
+            const void* context) {
+        PartsJob job;
+        job.n = n;
+        job.step = step;
+        job.fn = fn;
+        job.context = context;
+        job.parts = (n + step - 1) / step;
+        job.next_part = 1;
+        job.pending = job.parts - 1;
+        if (job.pending != 0) {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                job.next = jobs_;
+                jobs_ = &job;
+            }
+            cv_.notify_all();
+        }
+
+        std::exception_ptr error = nullptr;
+        try {
+            fn(context, 0, 0, std::min(step, n));
+        } catch (...) {
+            error = std::current_exception();
+        }
+        // Help with the remaining parts, then wait for those taken by workers, since they reference the job.
+        std::size_t part = 0;
+        while ((part = claim_part(job)) != 0) {
+            run_part(job, part);
+        }
+        {
+            std::unique_lock<std::mutex> lock(job.mutex);
+            job.done.wait(lock, [&job] { return job.pending == 0; });
+        }
+        if (error == nullptr) {
+            error = job.error;
+        }
+        if (error != nullptr) {
+            std::rethrow_exception(error);
+        }
+    }
+
+private:
+    // The ranges of one run_parts call; lives on the stack of the caller and is linked into jobs_ while it has
+    // unclaimed parts.
+    struct PartsJob {
+        std::size_t n = 0;
+        std::size_t step = 0;
+        void (*fn)(const void*, std::size_t, std::size_t, std::size_t) = nullptr;
+        const void* context = nullptr;
+        std::size_t parts = 0;
+        // Guarded by the pool mutex.
+        std::size_t next_part = 0;
+        PartsJob* next = nullptr;
+        // Guarded by the job mutex.
+        std::size_t pending = 0;
+        std::exception_ptr error = nullptr;
+        std::mutex mutex{};
+        std::condition_variable done{};
+    };
+
+    // Claim the next part of a job and unlink the job once its last part is claimed; 0 means none is left.
+    std::size_t claim_part(PartsJob& job) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (job.next_part == job.parts) {
+            return 0;
+        }
+        std::size_t part = job.next_part++;
+        if (job.next_part == job.parts) {
+            unlink(job);
+        }
+        return part;
+    }
+
+    void unlink(PartsJob& job) {
+        PartsJob** link = &jobs_;
+        while (*link != &job) {
+            link = &(*link)->next;
+        }
+        *link = job.next;
+    }
+
+    static void run_part(PartsJob& job, std::size_t part) {
+        std::size_t begin = part * job.step;
+        std::size_t end = begin + job.step < job.n ? begin + job.step : job.n;
+        std::exception_ptr error = nullptr;
+        try {
+            job.fn(job.context, part, begin, end);
+        } catch (...) {
+            error = std::current_exception();
+        }
+        // The caller may destroy the job as soon as pending drops to zero, so it is not touched after the lock.
+        std::lock_guard<std::mutex> lock(job.mutex);
+        if (error != nullptr && job.error == nullptr) {
+            job.error = error;
+        }
+        if (--job.pending == 0) {
+            job.done.notify_all();
+        }
+    }
+
+    void worker_loop() {
+        for (;;) {
+            std::function<void()> task;
+            PartsJob* job = nullptr;
+            std::size_t part = 0;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                cv_.wait(lock, [this] { return stop_ || jobs_ != nullptr || !tasks_.empty(); });
+                if (jobs_ != nullptr) {
+                    job = jobs_;
+                    part = job->next_part++;
+                    if (job->next_part == job->parts) {
+                        unlink(*job);
+                    }
+                } else if (tasks_.empty()) {
+                    return;
+                } else {
+                    task = std::move(tasks_.front());
+                    tasks_.pop();
+                }
+            }
+            if (job != nullptr) {
+                run_part(*job, part);
+            } else {
+                task();
+            }
+        }
+    }
+
+    std::vector<std::thread> workers_{};
+
+    // Jobs of run_parts calls with unclaimed parts, newest first.
+    PartsJob* jobs_ = nullptr;
+
+    std::queue<std::function<void()>> tasks_{};
+
+    std::mutex mutex_{};
+
+    std::condition_variable cv_{};
+
+    bool stop_ = false;
+};
+
+/**
+ * @brief Return the number of ranges parallel_for splits work into: one per pool worker plus the calling thread.
+ *
+ * @param[in] pool The pool; null means the calling thread only.
+ */
+inline std::size_t parallel_parts(const ThreadPool* pool) {
+    return pool == nullptr ? 1 : pool->size() + 1;
+}
+
+/**
+ * @brief Run fn(part, begin, end) over [0, n) split into at most parallel_parts(pool) contiguous ranges.
+ *
+ * Range part is the part-th range, so callers can keep per-range scratch buffers indexed by it. The ranges are handed
+ * to the pool through ThreadPool::run_parts, so the call allocates nothing with or without a pool.
+ *
+ * @param[in] pool The pool; null runs fn(0, 0, n) on the calling thread.
+ * @param[in] n The size of the range.
+ * @param[in] fn The callable; it must be safe to call concurrently on disjoint ranges.
+ */
+template <class Fn>
+void parallel_for_parts(ThreadPool* pool, std::size_t n, const Fn& fn) {
+    std::size_t parts = parallel_parts(pool);
+    std::size_t step = (n + parts - 1) / parts;
+    if (parts == 1 || step == n) {
+        fn(std::size_t(0), std::size_t(0), n);
+        return;
+    }
+    pool->run_parts(n, step,
+            [](const void* context, std::size_t part, std::size_t begin, std::size_t end) {
+                (*static_cast<const Fn*>(context))(part, begin, end);
+            },
+            &fn);
+}
+
+/**
+ * @brief Run fn(begin, end) over [0, n) split into contiguous ranges, one per pool worker plus the calling thread.
+ *
+ * @param[in] pool The pool; null runs fn(0, n) on the calling thread.
+ * @param[in] n The size of the range.
+ * @param[in] fn The callable; it must be safe to call concurrently on disjoint ranges.
+ */
+template <class Fn>
+void parallel_for(ThreadPool* pool, std::size_t n, const Fn& fn) {
+    parallel_for_parts(pool, n, [&fn](std::size_t, std::size_t begin, std::size_t end) { fn(begin, end); });
+}
+
+}  // namespace verse
+}  // namespace petace
@@ -14,15 +14,23 @@
 
 #pragma once
 
+#include <cstdint>
 #include <functional>
+#include <limits>
 #include <map>
 #include <memory>
+#include <stdexcept>
 #include <string>
+#include <type_traits>
 #include <utility>
+#include <vector>
 
 #include "verse/base-ot/base_ot_receiver.h"
 #include "verse/base-ot/base_ot_sender.h"
+#include "verse/base-ot/iknp-base-ot/iknp_base_ot.h"
 #include "verse/base-ot/naor-pinkas-ot/naor_pinkas_ot.h"
+#include "verse/base-ot/simplest-ot/simplest_ot.h"
+#include "verse/n-choose-one/kk13/kk13_nco_ot_ext.h"
 #include "verse/n-choose-one/kkrt/kkrt_nco_ot_ext.h"
 #include "verse/n-choose-one/nco_ot_ext_receiver.h"
 #include "verse/n-choose-one/nco_ot_ext_sender.h"
@@ -39,7 +47,58 @@ enum class OTScheme : std::uint32_t {
     IknpSender = 2,
     IknpReceiver = 3,
     KkrtSender = 4,
-    KkrtReceiver = 5
+    KkrtReceiver = 5,
+    SimplestOtSender = 6,
+    SimplestOtReceiver = 7,
+    IknpBaseOtSender = 8,
+    IknpBaseOtReceiver = 9,
+    Kk13Sender = 10,
+    Kk13Receiver = 11
+};
+
+enum class SecurityModel : std::uint32_t { SemiHonest = 0, Malicious = 1 };
+
+/**
+ * @brief Message modes of a scheme, combined as a bit mask.
+ */
+const std::uint32_t kRandomMessages = 1;
+const std::uint32_t kChosenMessages = 2;
+const std::uint32_t kLongMessages = 4;
+
+/**
+ * @brief Capabilities and cost estimates of a registered scheme.
+ *
+ * Costs are rough single-core estimates used to rank schemes against each other, not guarantees. The ot count of a
+ * base ot is params.base_ot_sizes, that of an extension is params.ext_ot_sizes.
+ */
+struct SchemeDescriptor {
+    std::string name{};
+    SecurityModel security = SecurityModel::SemiHonest;
+    // Supported params.base_ot_sizes; empty means any positive multiple of base_ot_multiple.
+    std::vector<std::size_t> base_ot_widths{};
+    std::size_t base_ot_multiple = 1;
+    std::size_t ext_ot_multiple = 1;
+    std::uint32_t message_modes = kRandomMessages;
+    // Whether the scheme spreads its own work across threads.
+    bool multi_threaded = false;
+    double bytes_per_ot = 0.0;
+    double setup_micros = 0.0;
+    double micros_per_ot = 0.0;
+
+    /**
+     * @brief Return the estimated microseconds to produce n ots.
+     */
+    double estimate_micros(std::size_t n) const {
+        return setup_micros + micros_per_ot * static_cast<double>(n);
+    }
+};
+
+/**
+ * @brief A requested security and output profile.
+ */
+struct SchemeProfile {
+    SecurityModel security = SecurityModel::SemiHonest;
+    std::uint32_t message_modes = kRandomMessages;
 };
 
 template <class T>
@@ -80,6 +139,66 @@ class VerseFactory {
         return where->second(params);
     }
 
+    /**
+     * @brief Get the fastest ot protocol object that meets a profile for the sizes in params.
+     *
+     * @param profile: Requested security and message modes
+     * @param params: Parameters of the ot protocol
+     * @throws std::invalid_argument if no described scheme meets the profile.
+     */
+    std::unique_ptr<T> build(const SchemeProfile& profile, const VerseParams& params) {
+        return build(select(profile, params), params);
+    }
+
+    /**
+     * @brief Return the fastest described scheme that meets a profile for the sizes in params.
+     *
+     * @param profile: Requested security and message modes
+     * @param params: Parameters of the ot protocol
+     * @throws std::invalid_argument if no described scheme meets the profile.
+     */
+    OTScheme select(const SchemeProfile& profile, const VerseParams& params) const {
+        std::size_t n = produced_ots(params);
+        double best_micros = std::numeric_limits<double>::infinity();
+        auto best = descriptor_map_.end();
+        for (auto it = descriptor_map_.begin(); it != descriptor_map_.end(); ++it) {
+            double micros = it->second.estimate_micros(n);
+            if (meets(it->second, profile, params) && micros < best_micros) {
+                best_micros = micros;
+                best = it;
+            }
+        }
+        if (best == descriptor_map_.end()) {
+            throw std::invalid_argument("no verse scheme meets the profile.");
+        }
+        return best->first;
+    }
+
+    /**
+     * @brief Return the descriptor of a scheme.
+     *
+     * @param scheme: Name of the ot protocol
+     * @throws std::invalid_argument if the scheme is not registered with a descriptor.
+     */
+    const SchemeDescriptor& describe(const OTScheme& scheme) const {
+        auto where = descriptor_map_.find(scheme);
+        if (where == descriptor_map_.end()) {
+            throw std::invalid_argument("verse scheme is not described.");
+        }
+        return where->second;
+    }
+
+    /**
+     * @brief Return the registered schemes.
+     */
+    std::vector<OTScheme> schemes() const {
+        std::vector<OTScheme> result;
+        for (auto& creator : creator_map_) {
+            result.emplace_back(creator.first);
+        }
+        return result;
+    }
+
     /**
      * @brief Register new ot protocol
      *
@@ -90,6 +209,18 @@ class VerseFactory {
         creator_map_.insert(std::make_pair(scheme, creator));
     }
 
+    /**
+     * @brief Register new ot protocol with its capabilities
+     *
+     * @param scheme: Name of the ot protocol
+     * @param creator: Object of the ot protocol
+     * @param descriptor: Capabilities of the ot protocol
+     */
+    void register_verse(const OTScheme& scheme, VerseCreator<T> creator, const SchemeDescriptor& descriptor) {
+        creator_map_.insert(std::make_pair(scheme, creator));
+        descriptor_map_.insert(std::make_pair(scheme, descriptor));
+    }
+
 protected:
     VerseFactory() {
     }
@@ -101,7 +232,36 @@ class VerseFactory {
     VerseFactory& operator=(VerseFactory&&) = delete;
 
 private:
+    static std::size_t produced_ots(const VerseParams& params) {
+        bool is_base_ot = std::is_same<T, BaseOtSender>::value || std::is_same<T, BaseOtReceiver>::value;
+        return is_base_ot ? params.base_ot_sizes : params.ext_ot_sizes;
+    }
+
+    static bool meets(const SchemeDescriptor& descriptor, const SchemeProfile& profile, const VerseParams& params) {
+        if (static_cast<std::uint32_t>(descriptor.security) < static_cast<std::uint32_t>(profile.security)) {
+            return false;
+        }
+        if ((descriptor.message_modes & profile.message_modes) != profile.message_modes) {
+            return false;
+        }
+        if (params.base_ot_sizes == 0 || params.base_ot_sizes % descriptor.base_ot_multiple != 0) {
+            return false;
+        }
+        if (!descriptor.base_ot_widths.empty()) {
+            bool found = false;
+            for (auto width : descriptor.base_ot_widths) {
+                found = found || width == params.base_ot_sizes;
+            }
+            if (!found) {
+                return false;
+            }
+        }
+        return params.ext_ot_sizes % descriptor.ext_ot_multiple == 0;
+    }
+
     std::map<OTScheme, VerseCreator<T>> creator_map_;
+
+    std::map<OTScheme, SchemeDescriptor> descriptor_map_;
 };
 
 /**
@@ -118,27 +278,91 @@ class VerseRegistrar {
     explicit VerseRegistrar(const OTScheme& scheme, VerseCreator<T> creator) {
         VerseFactory<T>::get_instance().register_verse(scheme, creator);
     }
+
+    VerseRegistrar(const OTScheme& scheme, VerseCreator<T> creator, const SchemeDescriptor& descriptor) {
+        VerseFactory<T>::get_instance().register_verse(scheme, creator, descriptor);
+    }
 };
 
-#define REGISTER_VERSE_BASE_OT_SENDER(scheme, creator) \
-    static VerseRegistrar<BaseOtSender> registrar__naorpinkas_sender__object(scheme, creator);
-#define REGISTER_VERSE_BASE_OT_RECEIVER(scheme, creator) \
-    static VerseRegistrar<BaseOtReceiver> registrar__naorpinkas_receiver__object(scheme, creator);
-#define REGISTER_VERSE_EXTOT_SENDER(scheme, creator) \
-    static VerseRegistrar<OtExtSender> registrar__iknp_sender__object(scheme, creator);
-#define REGISTER_VERSE_EXTOT_RECEIVER(scheme, creator) \
-    static VerseRegistrar<OtExtReceiver> registrar__iknp_receiver__object(scheme, creator);
-#define REGISTER_VERSE_NEXTOT_SENDER(scheme, creator) \
-    static VerseRegistrar<NcoOtExtSender> registrar__kkrt_sender__object(scheme, creator);
-#define REGISTER_VERSE_NEXTOT_RECEIVER(scheme, creator) \
-    static VerseRegistrar<NcoOtExtReceiver> registrar__kkrt_receiver__object(scheme, creator);
-
-REGISTER_VERSE_BASE_OT_SENDER(OTScheme::NaorPinkasSender, create_naor_pinkas_sender)
-REGISTER_VERSE_BASE_OT_RECEIVER(OTScheme::NaorPinkasReceiver, create_naor_pinkas_receiver)
-REGISTER_VERSE_EXTOT_SENDER(OTScheme::IknpSender, create_iknp_ext_sender)
-REGISTER_VERSE_EXTOT_RECEIVER(OTScheme::IknpReceiver, create_iknp_ext_receiver)
-REGISTER_VERSE_NEXTOT_SENDER(OTScheme::KkrtSender, create_kkrt_ext_sender)
-REGISTER_VERSE_NEXTOT_RECEIVER(OTScheme::KkrtReceiver, create_kkrt_ext_receiver)
+// Every registration defines its own static object, so an interface can register any number of schemes.
+#define VERSE_REGISTRAR_CONCAT_(a, b) a##b
+#define VERSE_REGISTRAR_NAME_(counter) VERSE_REGISTRAR_CONCAT_(registrar__verse__object_, counter)
+#define VERSE_REGISTRAR_(type, ...) static VerseRegistrar<type> VERSE_REGISTRAR_NAME_(__COUNTER__)(__VA_ARGS__);
+
+// Usage: REGISTER_VERSE_*(scheme, creator) or REGISTER_VERSE_*(scheme, creator, descriptor).
+#define REGISTER_VERSE_BASE_OT_SENDER(...) VERSE_REGISTRAR_(BaseOtSender, __VA_ARGS__)
+#define REGISTER_VERSE_BASE_OT_RECEIVER(...) VERSE_REGISTRAR_(BaseOtReceiver, __VA_ARGS__)
+#define REGISTER_VERSE_EXTOT_SENDER(...) VERSE_REGISTRAR_(OtExtSender, __VA_ARGS__)
+#define REGISTER_VERSE_EXTOT_RECEIVER(...) VERSE_REGISTRAR_(OtExtReceiver, __VA_ARGS__)
+#define REGISTER_VERSE_NEXTOT_SENDER(...) VERSE_REGISTRAR_(NcoOtExtSender, __VA_ARGS__)
+#define REGISTER_VERSE_NEXTOT_RECEIVER(...) VERSE_REGISTRAR_(NcoOtExtReceiver, __VA_ARGS__)
+
+inline SchemeDescriptor describe_naor_pinkas() {
+    SchemeDescriptor descriptor;
+    descriptor.name = "naor-pinkas";
+    // Point conversions run on a thread per core; bytes are three compressed P-256 points per ot.
+    descriptor.multi_threaded = true;
+    descriptor.bytes_per_ot = 3.0 * kEccPointLen;
+    descriptor.micros_per_ot = 490.0;
+    return descriptor;
+}
+
+inline SchemeDescriptor describe_simplest_ot() {
+    SchemeDescriptor descriptor;
+    descriptor.name = "simplest";
+    // Point conversions run on a thread per core like naor-pinkas; bytes are one compressed P-256 point per ot.
+    descriptor.multi_threaded = true;
+    descriptor.bytes_per_ot = 1.0 * kEccPointLen;
+    descriptor.setup_micros = 100.0;
+    descriptor.micros_per_ot = 280.0;
+    return descriptor;
+}
+
+inline SchemeDescriptor describe_iknp_base_ot() {
+    SchemeDescriptor descriptor;
+    descriptor.name = "iknp-bootstrap";
+    descriptor.base_ot_multiple = sizeof(block) * 8;
+    // The setup is 128 naor-pinkas ots; every further ot costs one extended row.
+    descriptor.bytes_per_ot = sizeof(block);
+    descriptor.setup_micros = 490.0 * kIknpBootstrapBaseOts;
+    descriptor.micros_per_ot = 0.1;
+    return descriptor;
+}
+
+inline SchemeDescriptor describe_iknp() {
+    SchemeDescriptor descriptor;
+    descriptor.name = "iknp";
+    descriptor.base_ot_widths = {sizeof(block) * 8};
+    descriptor.ext_ot_multiple = sizeof(block) * 8;
+    descriptor.message_modes = kRandomMessages | kChosenMessages | kLongMessages;
+    descriptor.bytes_per_ot = sizeof(block);
+    descriptor.micros_per_ot = 0.05;
+    return descriptor;
+}
+
+inline SchemeDescriptor describe_kkrt() {
+    SchemeDescriptor descriptor;
+    descriptor.name = "kkrt";
+    descriptor.base_ot_multiple = sizeof(block) * 8;
+    descriptor.message_modes = kRandomMessages | kChosenMessages | kLongMessages;
+    descriptor.bytes_per_ot = 4.0 * sizeof(block);
+    descriptor.micros_per_ot = 0.3;
+    return descriptor;
+}
+
+REGISTER_VERSE_BASE_OT_SENDER(OTScheme::NaorPinkasSender, create_naor_pinkas_sender, describe_naor_pinkas())
+REGISTER_VERSE_BASE_OT_RECEIVER(OTScheme::NaorPinkasReceiver, create_naor_pinkas_receiver, describe_naor_pinkas())
+REGISTER_VERSE_BASE_OT_SENDER(OTScheme::SimplestOtSender, create_simplest_ot_sender, describe_simplest_ot())
+REGISTER_VERSE_BASE_OT_RECEIVER(OTScheme::SimplestOtReceiver, create_simplest_ot_receiver, describe_simplest_ot())
+REGISTER_VERSE_BASE_OT_SENDER(OTScheme::IknpBaseOtSender, create_iknp_base_ot_sender, describe_iknp_base_ot())
+REGISTER_VERSE_BASE_OT_RECEIVER(OTScheme::IknpBaseOtReceiver, create_iknp_base_ot_receiver, describe_iknp_base_ot())
+REGISTER_VERSE_EXTOT_SENDER(OTScheme::IknpSender, create_iknp_ext_sender, describe_iknp())
+REGISTER_VERSE_EXTOT_RECEIVER(OTScheme::IknpReceiver, create_iknp_ext_receiver, describe_iknp())
+REGISTER_VERSE_NEXTOT_SENDER(OTScheme::KkrtSender, create_kkrt_ext_sender, describe_kkrt())
+REGISTER_VERSE_NEXTOT_RECEIVER(OTScheme::KkrtReceiver, create_kkrt_ext_receiver, describe_kkrt())
+// Kk13 only takes choices below 256, which a profile cannot express, so it is not described and select never picks it.
+REGISTER_VERSE_NEXTOT_SENDER(OTScheme::Kk13Sender, create_kk13_ext_sender)
+REGISTER_VERSE_NEXTOT_RECEIVER(OTScheme::Kk13Receiver, create_kk13_ext_receiver)
 
 }  // namespace verse
 }  // namespace petace
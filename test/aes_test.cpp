@@ -0,0 +1,142 @@
+// Copyright 2023 TikTok Pte. Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "verse/util/aes.h"
+#include "verse/util/common.h"
+#include "verse/util/defines.h"
+
+TEST(AesTest, known_answer) {
+    // FIPS-197 Appendix C.1.
+    std::uint8_t key[16];
+    std::uint8_t plain[16];
+    for (std::uint8_t i = 0; i < 16; i++) {
+        key[i] = i;
+        plain[i] = static_cast<std::uint8_t>(i * 0x11);
+    }
+    const std::uint8_t expected[16] = {0x69, 0xc4, 0xe0, 0xd8, 0x6a, 0x7b, 0x04, 0x30, 0xd8, 0xcd, 0xb7, 0x80, 0x70,
+            0xb4, 0xc5, 0x5a};
+
+    petace::verse::block key_block;
+    memcpy(&key_block, key, sizeof(key));
+    petace::verse::AesRoundKeys keys;
+    petace::verse::aes_expand_key(key_block, keys);
+
+    // Enough blocks to cover both the interleaved and the single-block path.
+    std::vector<petace::verse::block> data(11);
+    for (auto& b : data) {
+        memcpy(&b, plain, sizeof(plain));
+    }
+    petace::verse::aes_ecb_encrypt(keys, data.data(), data.size());
+    for (auto& b : data) {
+        ASSERT_EQ(memcmp(&b, expected, sizeof(expected)), 0);
+    }
+}
+
+TEST(AesTest, prg_stretch) {
+    // Batches of eight seeds plus a partial batch.
+    std::size_t n = 13;
+    std::vector<petace::verse::block> seeds(n);
+    for (auto& seed : seeds) {
+        seed = petace::verse::read_block_from_dev_urandom();
+    }
+    std::vector<petace::solo::Byte> long_out(n * 100);
+    std::vector<petace::solo::Byte> short_out(n * 37);
+    petace::verse::prg_stretch(seeds.data(), n, 100, long_out.data());
+    petace::verse::prg_stretch(seeds.data(), n, 37, short_out.data());
+
+    for (std::size_t i = 0; i < n; i++) {
+        // A shorter output is a prefix of a longer one, and each output is AES_seed(0), AES_seed(1), ...
+        ASSERT_EQ(memcmp(long_out.data() + i * 100, short_out.data() + i * 37, 37), 0);
+        petace::verse::AesRoundKeys keys;
+        petace::verse::aes_expand_key(seeds[i], keys);
+        petace::verse::block ctr = _mm_set_epi64x(0, 1);
+        petace::verse::aes_ecb_encrypt(keys, &ctr, 1);
+        ASSERT_EQ(memcmp(long_out.data() + i * 100 + 16, &ctr, sizeof(ctr)), 0);
+    }
+    ASSERT_NE(memcmp(long_out.data(), long_out.data() + 100, 100), 0);
+}
+
+TEST(AesTest, multi_key_prg) {
+    std::size_t n = 13;
+    std::size_t nblock = 21;
+    std::vector<petace::verse::block> seeds(n);
+    for (auto& seed : seeds) {
+        seed = petace::verse::read_block_from_dev_urandom();
+    }
+    std::vector<petace::solo::Byte> expected(n * nblock * sizeof(petace::verse::block));
+    petace::verse::prg_stretch(seeds.data(), n, nblock * sizeof(petace::verse::block), expected.data());
+
+    // Generate the same streams in two resumed batches, 5 and 16 blocks, into rows of a wider matrix.
+    std::size_t stride = nblock + 3;
+    std::vector<petace::verse::block> matrix(n * stride);
+    petace::verse::MultiKeyPrg prg(seeds.data(), n);
+    prg.generate(5, matrix.data(), stride);
+    ASSERT_EQ(prg.counter(), 5u);
+    prg.generate(nblock - 5, matrix.data() + 5, stride);
+    for (std::size_t i = 0; i < n; i++) {
+        ASSERT_EQ(memcmp(matrix.data() + i * stride, expected.data() + i * nblock * sizeof(petace::verse::block),
+                          nblock * sizeof(petace::verse::block)),
+                0);
+    }
+
+    // A new engine resumed at a saved counter continues the streams.
+    petace::verse::MultiKeyPrg resumed(seeds.data(), n);
+    resumed.set_counter(8);
+    std::vector<petace::verse::block> tail(n * 8);
+    resumed.generate(8, tail.data(), 8);
+    for (std::size_t i = 0; i < n; i++) {
+        ASSERT_EQ(memcmp(tail.data() + i * 8, matrix.data() + i * stride + 8, 8 * sizeof(petace::verse::block)), 0);
+    }
+
+    // Expanding a tile at an explicit counter matches the shared stream and leaves the counter alone.
+    std::vector<petace::verse::block> tile(n * 3);
+    resumed.generate_at(10, 3, tile.data(), 3);
+    ASSERT_EQ(resumed.counter(), 16u);
+    for (std::size_t i = 0; i < n; i++) {
+        ASSERT_EQ(memcmp(tile.data() + i * 3, matrix.data() + i * stride + 10, 3 * sizeof(petace::verse::block)), 0);
+    }
+}
+
+TEST(AesTest, tccr_hash) {
+    // More inputs than one pass, hashed into a separate buffer and in place.
+    std::size_t n = 70;
+    std::uint64_t index = 1000;
+    petace::verse::block offset = petace::verse::read_block_from_dev_urandom();
+    std::vector<petace::verse::block> in(n);
+    for (auto& b : in) {
+        b = petace::verse::read_block_from_dev_urandom();
+    }
+    std::vector<petace::verse::block> out(n);
+    petace::verse::tccr_hash(in.data(), offset, index, out.data(), n);
+    std::vector<petace::verse::block> in_place = in;
+    petace::verse::tccr_hash(in_place.data(), offset, index, in_place.data(), n);
+    ASSERT_EQ(memcmp(out.data(), in_place.data(), n * sizeof(petace::verse::block)), 0);
+
+    // H(i, x) = pi(pi(x) ^ i) ^ pi(x).
+    const petace::verse::AesRoundKeys& pi = petace::verse::fixed_aes_keys();
+    for (std::size_t j = 0; j < n; j++) {
+        petace::verse::block px = _mm_xor_si128(in[j], offset);
+        petace::verse::aes_ecb_encrypt(pi, &px, 1);
+        petace::verse::block tweaked = _mm_xor_si128(px, _mm_set_epi64x(0, static_cast<long long>(index + j)));
+        petace::verse::aes_ecb_encrypt(pi, &tweaked, 1);
+        petace::verse::block expected = _mm_xor_si128(tweaked, px);
+        ASSERT_EQ(memcmp(&out[j], &expected, sizeof(expected)), 0);
+    }
+}
@@ -0,0 +1,139 @@
+// Copyright 2023 TikTok Pte. Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <stdio.h>
+#include <unistd.h>
+
+#include <array>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "verse/tuning/auto_tuner.h"
+#include "verse/util/common.h"
+#include "verse/util/defines.h"
+#include "verse/util/local_network.h"
+#include "verse/verse_factory.h"
+
+class AutoTunerTest : public ::testing::Test {
+public:
+    void SetUp() override {
+        std::string prefix = "/tmp/verse_tuned_" + std::to_string(getpid());
+        leader_path_ = prefix + "_leader";
+        follower_path_ = prefix + "_follower";
+    }
+
+    void TearDown() override {
+        remove(leader_path_.c_str());
+        remove(follower_path_.c_str());
+    }
+
+    // Run auto_tune on both ends and return the bytes the leader sent.
+    std::size_t run(petace::verse::TunedConfig& leader, petace::verse::TunedConfig& follower) {
+        auto nets = petace::verse::LocalNetwork::create_pair();
+        petace::verse::VerseParams params;
+        params.base_ot_sizes = 512;
+        params.ext_ot_sizes = 1024;
+        params.net = nets.first;
+        std::thread leader_thread([&] { leader = petace::verse::auto_tune(params, true, leader_path_); });
+        petace::verse::VerseParams follower_params = params;
+        follower_params.net = nets.second;
+        follower = petace::verse::auto_tune(follower_params, false, follower_path_);
+        leader_thread.join();
+        return nets.first->get_bytes_sent();
+    }
+
+public:
+    std::string leader_path_;
+    std::string follower_path_;
+};
+
+TEST_F(AutoTunerTest, calibrate_and_cache) {
+    petace::verse::TunedConfig leader;
+    petace::verse::TunedConfig follower;
+    std::size_t calibration_bytes = run(leader, follower);
+    ASSERT_GT(leader.calibration.link_bytes_per_second, 0.0);
+    ASSERT_EQ(leader.calibration.link_bytes_per_second, follower.calibration.link_bytes_per_second);
+    ASSERT_GT(leader.calibration.hash_micros, 0.0);
+    ASSERT_GE(leader.num_threads, 1u);
+    ASSERT_EQ(leader.chunk_size % 128, 0u);
+    ASSERT_EQ(leader.chunk_size, follower.chunk_size);
+    ASSERT_EQ(leader.base_ot_sender, follower.base_ot_sender);
+    ASSERT_EQ(leader.base_ot_receiver, follower.base_ot_receiver);
+
+    // Both caches are valid now, so the second run only exchanges the flag and the shared settings.
+    petace::verse::TunedConfig cached_leader;
+    petace::verse::TunedConfig cached_follower;
+    ASSERT_EQ(run(cached_leader, cached_follower), sizeof(std::uint8_t) + 3 * sizeof(std::uint64_t));
+    ASSERT_LT(sizeof(std::uint8_t) + 3 * sizeof(std::uint64_t), calibration_bytes);
+    ASSERT_EQ(cached_leader.chunk_size, leader.chunk_size);
+    ASSERT_EQ(cached_leader.calibration.hash_micros, leader.calibration.hash_micros);
+
+    // One missing cache makes both parties calibrate again.
+    remove(follower_path_.c_str());
+    ASSERT_GT(run(cached_leader, cached_follower), calibration_bytes / 2);
+}
+
+TEST_F(AutoTunerTest, tuned_iknp) {
+    petace::verse::TunedConfig config;
+    config.num_threads = 3;
+    config.chunk_size = 256;
+    auto nets = petace::verse::LocalNetwork::create_pair();
+    petace::verse::VerseParams params;
+    params.base_ot_sizes = 128;
+    params.ext_ot_sizes = 1024;
+    config.apply(params);
+
+    std::vector<petace::verse::block> base_choices = {petace::verse::read_block_from_dev_urandom()};
+    std::vector<petace::verse::block> choices(params.ext_ot_sizes / 128);
+    for (auto& choice : choices) {
+        choice = petace::verse::read_block_from_dev_urandom();
+    }
+    std::vector<std::array<petace::verse::block, 2>> send_msgs;
+    std::thread sender([&] {
+        std::vector<petace::verse::block> base_recv_ots;
+        auto np_receiver = petace::verse::VerseFactory<petace::verse::BaseOtReceiver>::get_instance().build(
+                petace::verse::OTScheme::NaorPinkasReceiver, params);
+        np_receiver->receive(nets.first, base_choices, base_recv_ots);
+        auto iknp_sender = petace::verse::VerseFactory<petace::verse::OtExtSender>::get_instance().build(
+                petace::verse::OTScheme::IknpSender, params);
+        iknp_sender->set_base_ots(base_choices, base_recv_ots);
+        iknp_sender->send(nets.first, send_msgs);
+    });
+    std::vector<std::array<petace::verse::block, 2>> base_send_ots;
+    auto np_sender = petace::verse::VerseFactory<petace::verse::BaseOtSender>::get_instance().build(
+            petace::verse::OTScheme::NaorPinkasSender, params);
+    np_sender->send(nets.second, base_send_ots);
+    auto iknp_receiver = petace::verse::VerseFactory<petace::verse::OtExtReceiver>::get_instance().build(
+            petace::verse::OTScheme::IknpReceiver, params);
+    iknp_receiver->set_base_ots(base_send_ots);
+    std::size_t bytes_before = nets.second->get_bytes_sent();
+    std::vector<petace::verse::block> recv_msgs;
+    iknp_receiver->receive(nets.second, choices, recv_msgs);
+    sender.join();
+
+    // Four chunks of 256 ots, each in its own frame.
+    ASSERT_EQ(nets.second->get_bytes_sent() - bytes_before,
+            4 * sizeof(petace::verse::FrameHeader) + params.ext_ot_sizes * sizeof(petace::verse::block));
+    ASSERT_EQ(recv_msgs.size(), params.ext_ot_sizes);
+    for (std::size_t i = 0; i < params.ext_ot_sizes; i++) {
+        std::size_t bit = petace::verse::bit_from_blocks(choices, i);
+        ASSERT_EQ(recv_msgs[i][0], send_msgs[i][bit][0]);
+        ASSERT_EQ(recv_msgs[i][1], send_msgs[i][bit][1]);
+        ASSERT_NE(recv_msgs[i][0], send_msgs[i][1 - bit][0]);
+    }
+}
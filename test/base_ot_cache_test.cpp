@@ -0,0 +1,171 @@
+// Copyright 2023 TikTok Pte. Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <dirent.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <array>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "verse/base-ot/base-ot-cache/base_ot_cache.h"
+#include "verse/util/common.h"
+#include "verse/util/defines.h"
+#include "verse/util/local_network.h"
+
+class BaseOtCacheTest : public ::testing::Test {
+public:
+    void SetUp() override {
+        char pattern[] = "/tmp/verse_base_ot_cache_XXXXXX";
+        ASSERT_NE(mkdtemp(pattern), nullptr);
+        directory_ = pattern;
+        key_.assign(32, petace::solo::Byte(7));
+    }
+
+    void TearDown() override {
+        std::string command = "rm -rf " + directory_;
+        ASSERT_EQ(system(command.c_str()), 0);
+    }
+
+    // Run both parties once and return the bytes the sender side sent.
+    std::size_t run(const petace::verse::BaseOtCache& cache) {
+        auto nets = petace::verse::LocalNetwork::create_pair();
+        petace::verse::VerseParams params;
+        params.base_ot_sizes = 128;
+        params.net = nets.first;
+        std::thread sender([&] {
+            petace::verse::cached_base_ot_send(params, cache, "receiver", 42, send_msgs_);
+        });
+        petace::verse::VerseParams receiver_params = params;
+        receiver_params.net = nets.second;
+        petace::verse::cached_base_ot_receive(receiver_params, cache, "sender", 42, choices_, recv_msgs_);
+        sender.join();
+
+        EXPECT_EQ(send_msgs_.size(), 128u);
+        EXPECT_EQ(recv_msgs_.size(), 128u);
+        for (std::size_t i = 0; i < recv_msgs_.size(); i++) {
+            std::size_t bit = petace::verse::bit_from_blocks(choices_, i);
+            EXPECT_EQ(recv_msgs_[i][0], send_msgs_[i][bit][0]);
+            EXPECT_EQ(recv_msgs_[i][1], send_msgs_[i][bit][1]);
+            EXPECT_NE(recv_msgs_[i][0], send_msgs_[i][1 - bit][0]);
+        }
+        return nets.first->get_bytes_sent();
+    }
+
+public:
+    std::string directory_;
+    std::vector<petace::solo::Byte> key_;
+    std::vector<petace::verse::block> choices_;
+    std::vector<std::array<petace::verse::block, 2>> send_msgs_;
+    std::vector<petace::verse::block> recv_msgs_;
+};
+
+TEST_F(BaseOtCacheTest, reuse_and_rekey) {
+    petace::verse::BaseOtCache cache(directory_, key_);
+    std::size_t first_bytes = run(cache);
+    auto first_choices = choices_;
+    auto first_msgs = send_msgs_;
+
+    // The second run only exchanges the committed cache id and nonce share, each as a commitment and an opening.
+    std::size_t second_bytes = run(cache);
+    ASSERT_LT(second_bytes, first_bytes);
+    ASSERT_EQ(second_bytes, 4 * (sizeof(petace::verse::FrameHeader) + 2 * sizeof(petace::verse::block)));
+    for (std::size_t i = 0; i < choices_.size(); i++) {
+        ASSERT_EQ(choices_[i][0], first_choices[i][0]);
+        ASSERT_EQ(choices_[i][1], first_choices[i][1]);
+    }
+    for (std::size_t i = 0; i < send_msgs_.size(); i++) {
+        ASSERT_NE(send_msgs_[i][0][0], first_msgs[i][0][0]);
+    }
+}
+
+TEST_F(BaseOtCacheTest, miss) {
+    petace::verse::BaseOtCache cache(directory_, key_);
+    std::size_t first_bytes = run(cache);
+
+    // Losing one side's entry makes both sides run the base ots again.
+    cache.erase("receiver", 42, true);
+    ASSERT_EQ(run(cache), first_bytes);
+
+    // A cache with another key cannot read the entries and runs the base ots again.
+    std::vector<petace::solo::Byte> other_key(32, petace::solo::Byte(8));
+    petace::verse::BaseOtCache other_cache(directory_, other_key);
+    ASSERT_EQ(run(other_cache), first_bytes);
+}
+
+TEST_F(BaseOtCacheTest, tampered_entry) {
+    petace::verse::BaseOtCache cache(directory_, key_);
+    std::vector<std::array<petace::verse::block, 2>> messages(4);
+    petace::verse::block cache_id = petace::verse::read_block_from_dev_urandom();
+    ASSERT_TRUE(cache.store_sender("peer", 1, cache_id, messages));
+    petace::verse::block loaded_id;
+    ASSERT_TRUE(cache.load_sender("peer", 1, loaded_id, messages));
+    ASSERT_FALSE(cache.load_sender("peer", 2, loaded_id, messages));
+    ASSERT_FALSE(cache.load_sender("other peer", 1, loaded_id, messages));
+
+    // Flip one ciphertext byte of the only entry.
+    DIR* dir = opendir(directory_.c_str());
+    ASSERT_NE(dir, nullptr);
+    std::string path;
+    while (struct dirent* file = readdir(dir)) {
+        if (file->d_name[0] != '.') {
+            path = directory_ + "/" + file->d_name;
+        }
+    }
+    closedir(dir);
+    std::fstream entry(path, std::ios::in | std::ios::out | std::ios::binary);
+    entry.seekg(40);
+    char byte = 0;
+    entry.read(&byte, 1);
+    byte = static_cast<char>(byte ^ 1);
+    entry.seekp(40);
+    entry.write(&byte, 1);
+    entry.close();
+    ASSERT_FALSE(cache.load_sender("peer", 1, loaded_id, messages));
+}
+
+TEST_F(BaseOtCacheTest, invalid_params) {
+    EXPECT_THROW(petace::verse::BaseOtCache("", key_), std::invalid_argument);
+    EXPECT_THROW(petace::verse::BaseOtCache(directory_, std::vector<petace::solo::Byte>(8)), std::invalid_argument);
+}
+
+TEST_F(BaseOtCacheTest, equivocating_peer) {
+    petace::verse::BaseOtCache cache(directory_, key_);
+    auto nets = petace::verse::LocalNetwork::create_pair();
+    petace::verse::VerseParams params;
+    params.base_ot_sizes = 128;
+    params.net = nets.second;
+    // The peer commits to one cache id and then opens another one.
+    std::thread peer([&] {
+        std::array<petace::verse::block, 2> commitment = {petace::verse::read_block_from_dev_urandom(),
+                petace::verse::read_block_from_dev_urandom()};
+        std::array<petace::verse::block, 2> opening = {petace::verse::read_block_from_dev_urandom(),
+                petace::verse::read_block_from_dev_urandom()};
+        std::array<petace::verse::block, 2> ignored;
+        petace::verse::send_block(nets.first, commitment.data(), 2);
+        petace::verse::recv_block(nets.first, ignored.data(), 2);
+        petace::verse::send_block(nets.first, opening.data(), 2);
+        petace::verse::recv_block(nets.first, ignored.data(), 2);
+    });
+    EXPECT_THROW(petace::verse::cached_base_ot_receive(params, cache, "sender", 42, choices_, recv_msgs_),
+            std::runtime_error);
+    peer.join();
+}
@@ -0,0 +1,158 @@
+// Copyright 2023 TikTok Pte. Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <array>
+#include <cstring>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "solo/prng.h"
+
+#include "verse/two-choose-one/derandomize.h"
+#include "verse/util/common.h"
+#include "verse/util/defines.h"
+#include "verse/util/local_network.h"
+#include "verse/verse_factory.h"
+
+class ChosenOtTest : public ::testing::Test {
+public:
+    void SetUp() override {
+        auto nets = petace::verse::LocalNetwork::create_pair();
+        sender_net_ = nets.first;
+        receiver_net_ = nets.second;
+
+        petace::verse::VerseParams params;
+        params.base_ot_sizes = 128;
+        params.ext_ot_sizes = 1024;
+        iknp_sender_ = petace::verse::VerseFactory<petace::verse::OtExtSender>::get_instance().build(
+                petace::verse::OTScheme::IknpSender, params);
+        iknp_receiver_ = petace::verse::VerseFactory<petace::verse::OtExtReceiver>::get_instance().build(
+                petace::verse::OTScheme::IknpReceiver, params);
+        auto npot_receiver = petace::verse::VerseFactory<petace::verse::BaseOtReceiver>::get_instance().build(
+                petace::verse::OTScheme::NaorPinkasReceiver, params);
+        auto npot_sender = petace::verse::VerseFactory<petace::verse::BaseOtSender>::get_instance().build(
+                petace::verse::OTScheme::NaorPinkasSender, params);
+
+        std::vector<petace::verse::block> base_choices = {petace::verse::read_block_from_dev_urandom()};
+        std::thread sender([&] {
+            std::vector<petace::verse::block> base_recv_ots;
+            npot_receiver->receive(sender_net_, base_choices, base_recv_ots);
+            iknp_sender_->set_base_ots(base_choices, base_recv_ots);
+        });
+        std::vector<std::array<petace::verse::block, 2>> base_send_ots;
+        npot_sender->send(receiver_net_, base_send_ots);
+        iknp_receiver_->set_base_ots(base_send_ots);
+        sender.join();
+
+        for (std::size_t i = 0; i < 8; i++) {
+            choices_.emplace_back(petace::verse::read_block_from_dev_urandom());
+        }
+    }
+
+public:
+    std::shared_ptr<petace::network::Network> sender_net_ = nullptr;
+    std::shared_ptr<petace::network::Network> receiver_net_ = nullptr;
+    std::unique_ptr<petace::verse::OtExtSender> iknp_sender_ = nullptr;
+    std::unique_ptr<petace::verse::OtExtReceiver> iknp_receiver_ = nullptr;
+    std::vector<petace::verse::block> choices_{};
+};
+
+TEST_F(ChosenOtTest, block_messages) {
+    std::vector<std::array<petace::verse::block, 2>> inputs(1024);
+    for (auto& input : inputs) {
+        input[0] = petace::verse::read_block_from_dev_urandom();
+        input[1] = petace::verse::read_block_from_dev_urandom();
+    }
+    std::vector<petace::verse::block> outputs;
+    std::thread sender([&] { iknp_sender_->send_chosen(sender_net_, inputs); });
+    iknp_receiver_->receive_chosen(receiver_net_, choices_, outputs);
+    sender.join();
+
+    ASSERT_EQ(outputs.size(), inputs.size());
+    for (std::size_t i = 0; i < inputs.size(); i++) {
+        std::size_t bit = petace::verse::bit_from_blocks(choices_, i);
+        ASSERT_EQ(outputs[i][0], inputs[i][bit][0]);
+        ASSERT_EQ(outputs[i][1], inputs[i][bit][1]);
+    }
+}
+
+TEST_F(ChosenOtTest, long_messages) {
+    // Lengths below, at and above one block, one of them not a multiple of the block size.
+    std::vector<std::size_t> lengths = {1, 16, 33, 100};
+    petace::solo::PRNGFactory prng_factory(petace::solo::PRNGScheme::AES_ECB_CTR);
+    auto prng = prng_factory.create();
+    for (auto msg_len : lengths) {
+        std::vector<petace::solo::Byte> inputs(2 * 1024 * msg_len);
+        prng->generate(inputs.size(), inputs.data());
+        std::vector<petace::solo::Byte> outputs;
+        std::thread sender([&] { iknp_sender_->send_chosen(sender_net_, inputs, msg_len); });
+        iknp_receiver_->receive_chosen(receiver_net_, choices_, outputs, msg_len);
+        sender.join();
+
+        ASSERT_EQ(outputs.size(), 1024 * msg_len);
+        for (std::size_t i = 0; i < 1024; i++) {
+            std::size_t bit = petace::verse::bit_from_blocks(choices_, i);
+            ASSERT_EQ(memcmp(outputs.data() + i * msg_len, inputs.data() + (2 * i + bit) * msg_len, msg_len), 0);
+        }
+    }
+}
+
+TEST_F(ChosenOtTest, random_long_messages) {
+    std::size_t msg_len = 40;
+    std::vector<petace::solo::Byte> send_msgs;
+    std::vector<petace::solo::Byte> recv_msgs;
+    std::thread sender([&] { iknp_sender_->send(sender_net_, send_msgs, msg_len); });
+    iknp_receiver_->receive(receiver_net_, choices_, recv_msgs, msg_len);
+    sender.join();
+
+    ASSERT_EQ(send_msgs.size(), 2 * 1024 * msg_len);
+    ASSERT_EQ(recv_msgs.size(), 1024 * msg_len);
+    for (std::size_t i = 0; i < 1024; i++) {
+        std::size_t bit = petace::verse::bit_from_blocks(choices_, i);
+        ASSERT_EQ(memcmp(recv_msgs.data() + i * msg_len, send_msgs.data() + (2 * i + bit) * msg_len, msg_len), 0);
+        ASSERT_NE(memcmp(recv_msgs.data() + i * msg_len, send_msgs.data() + (2 * i + 1 - bit) * msg_len, msg_len), 0);
+    }
+}
+
+TEST_F(ChosenOtTest, invalid_inputs) {
+    std::vector<std::array<petace::verse::block, 2>> random_ots(16);
+    std::vector<std::array<petace::verse::block, 2>> inputs(15);
+    EXPECT_THROW(petace::verse::send_chosen_messages(sender_net_, random_ots, inputs), std::invalid_argument);
+    std::vector<petace::solo::Byte> bytes(2 * 16 * 8);
+    EXPECT_THROW(petace::verse::send_chosen_messages(sender_net_, random_ots, bytes, 0), std::invalid_argument);
+}
+
+TEST_F(ChosenOtTest, no_messages) {
+    // Without random ots both sides return at once, so neither waits for the other.
+    std::vector<std::array<petace::verse::block, 2>> random_ots;
+    std::vector<std::array<petace::verse::block, 2>> inputs;
+    std::vector<petace::solo::Byte> bytes;
+    std::size_t sender_bytes = sender_net_->get_bytes_sent();
+    std::size_t receiver_bytes = receiver_net_->get_bytes_sent();
+    petace::verse::send_chosen_messages(sender_net_, random_ots, inputs);
+    petace::verse::send_chosen_messages(sender_net_, random_ots, bytes, 8);
+
+    std::vector<petace::verse::block> none;
+    std::vector<petace::verse::block> messages(3);
+    std::vector<petace::solo::Byte> byte_messages(3);
+    petace::verse::receive_chosen_messages(receiver_net_, none, none, none, messages);
+    petace::verse::receive_chosen_messages(receiver_net_, none, none, none, byte_messages, 8);
+    ASSERT_TRUE(messages.empty());
+    ASSERT_TRUE(byte_messages.empty());
+    ASSERT_EQ(sender_net_->get_bytes_sent(), sender_bytes);
+    ASSERT_EQ(receiver_net_->get_bytes_sent(), receiver_bytes);
+}
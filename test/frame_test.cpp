@@ -0,0 +1,55 @@
+// Copyright 2023 TikTok Pte. Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "verse/util/common.h"
+#include "verse/util/local_network.h"
+
+TEST(FrameTest, round_trip) {
+    auto nets = petace::verse::LocalNetwork::create_pair();
+    // Empty, single-chunk and multi-chunk payloads.
+    std::vector<std::size_t> sizes = {0, 1, petace::verse::kFrameChunkBytes, 3 * petace::verse::kFrameChunkBytes + 5};
+    for (auto nbyte : sizes) {
+        std::vector<std::uint8_t> data(nbyte);
+        for (std::size_t i = 0; i < nbyte; i++) {
+            data[i] = static_cast<std::uint8_t>(i * 7);
+        }
+        std::size_t bytes_before = nets.first->get_bytes_sent();
+        petace::verse::send_frame(nets.first, data.data(), data.size());
+        ASSERT_EQ(nets.first->get_bytes_sent() - bytes_before, nbyte + sizeof(petace::verse::FrameHeader));
+
+        std::vector<std::uint8_t> received(nbyte);
+        petace::verse::recv_frame(nets.second, received.data(), received.size());
+        ASSERT_EQ(received, data);
+    }
+}
+
+TEST(FrameTest, length_mismatch) {
+    auto nets = petace::verse::LocalNetwork::create_pair();
+    std::vector<std::uint8_t> data(64);
+    petace::verse::send_frame(nets.first, data.data(), data.size());
+    std::vector<std::uint8_t> received(32);
+    EXPECT_THROW(petace::verse::recv_frame(nets.second, received.data(), received.size()), std::runtime_error);
+
+    // A frame shorter than expected is rejected from its header alone, without waiting for the missing bytes.
+    auto short_nets = petace::verse::LocalNetwork::create_pair();
+    petace::verse::send_frame(short_nets.first, received.data(), received.size());
+    std::vector<std::uint8_t> expected(64);
+    EXPECT_THROW(petace::verse::recv_frame(short_nets.second, expected.data(), expected.size()), std::runtime_error);
+}
@@ -15,9 +15,13 @@
 #include <stdlib.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <array>
+#include <cstdint>
 #include <memory>
 #include <string>
+#include <thread>
+#include <vector>
 
 #include "gtest/gtest.h"
 
@@ -25,9 +29,12 @@
 #include "solo/prng.h"
 
 #include "verse/base-ot/naor-pinkas-ot/naor_pinkas_ot.h"
+#include "verse/two-choose-one/iknp/iknp_duplex_ot_ext.h"
 #include "verse/two-choose-one/iknp/iknp_ot_ext.h"
+#include "verse/util/buffer.h"
 #include "verse/util/common.h"
 #include "verse/util/defines.h"
+#include "verse/util/local_network.h"
 #include "verse/verse_factory.h"
 
 class IKNPOtTest : public ::testing::Test {
@@ -118,3 +125,203 @@ TEST_F(IKNPOtTest, iknp_ot) {
         return;
     }
 }
+
+namespace {
+
+class CountingAllocator : public petace::verse::AlignedAllocator {
+public:
+    void* allocate(std::size_t nbyte) override {
+        count++;
+        return AlignedAllocator::allocate(nbyte);
+    }
+
+    std::size_t count = 0;
+};
+
+}  // namespace
+
+TEST(IKNPOtBufferTest, reuses_buffers) {
+    auto allocator = std::make_shared<CountingAllocator>();
+    petace::verse::VerseParams params;
+    params.base_ot_sizes = 128;
+    params.ext_ot_sizes = 1024;
+    params.num_threads = 2;
+    params.chunk_size = 512;
+    params.allocator = allocator;
+    auto nets = petace::verse::LocalNetwork::create_pair();
+
+    // Base ots are dealt locally; only the extension is under test.
+    std::vector<petace::verse::block> base_choices = {petace::verse::read_block_from_dev_urandom()};
+    std::vector<std::array<petace::verse::block, 2>> base_send_ots(params.base_ot_sizes);
+    std::vector<petace::verse::block> base_recv_ots(params.base_ot_sizes);
+    for (std::size_t i = 0; i < params.base_ot_sizes; i++) {
+        base_send_ots[i] = {petace::verse::read_block_from_dev_urandom(), petace::verse::read_block_from_dev_urandom()};
+        base_recv_ots[i] = base_send_ots[i][petace::verse::bit_from_blocks(base_choices, i)];
+    }
+    auto sender = petace::verse::create_iknp_ext_sender(params);
+    auto receiver = petace::verse::create_iknp_ext_receiver(params);
+    sender->set_base_ots(base_choices, base_recv_ots);
+    receiver->set_base_ots(base_send_ots);
+
+    std::vector<petace::verse::block> choices(params.ext_ot_sizes / 128);
+    std::vector<std::array<petace::verse::block, 2>> send_msgs;
+    std::vector<petace::verse::block> recv_msgs;
+    std::size_t first_batch = 0;
+    for (std::size_t batch = 0; batch < 3; batch++) {
+        for (auto& choice : choices) {
+            choice = petace::verse::read_block_from_dev_urandom();
+        }
+        std::thread thread([&] { sender->send(nets.first, send_msgs); });
+        receiver->receive(nets.second, choices, recv_msgs);
+        thread.join();
+        if (batch == 0) {
+            first_batch = allocator->count;
+        }
+        for (std::size_t i = 0; i < params.ext_ot_sizes; i++) {
+            std::size_t bit = petace::verse::bit_from_blocks(choices, i);
+            ASSERT_EQ(recv_msgs[i][0], send_msgs[i][bit][0]);
+            ASSERT_EQ(recv_msgs[i][1], send_msgs[i][bit][1]);
+        }
+    }
+    // Only the first batch sizes the buffers.
+    ASSERT_GT(first_batch, 0u);
+    ASSERT_EQ(allocator->count, first_batch);
+}
+
+TEST(IKNPOtBufferTest, huge_pages) {
+    petace::verse::VerseParams params;
+    params.base_ot_sizes = 128;
+    // A chunk of 2^17 ots is a 2 MB matrix, the smallest that is mapped on huge pages.
+    params.ext_ot_sizes = std::size_t(1) << 17;
+    params.num_threads = 2;
+    params.huge_pages = true;
+    params.numa_node = 0;
+    ASSERT_NE(petace::verse::buffer_allocator(params), nullptr);
+    auto nets = petace::verse::LocalNetwork::create_pair();
+
+    std::vector<petace::verse::block> base_choices = {petace::verse::read_block_from_dev_urandom()};
+    std::vector<std::array<petace::verse::block, 2>> base_send_ots(params.base_ot_sizes);
+    std::vector<petace::verse::block> base_recv_ots(params.base_ot_sizes);
+    for (std::size_t i = 0; i < params.base_ot_sizes; i++) {
+        base_send_ots[i] = {petace::verse::read_block_from_dev_urandom(), petace::verse::read_block_from_dev_urandom()};
+        base_recv_ots[i] = base_send_ots[i][petace::verse::bit_from_blocks(base_choices, i)];
+    }
+    auto sender = petace::verse::create_iknp_ext_sender(params);
+    auto receiver = petace::verse::create_iknp_ext_receiver(params);
+    sender->set_base_ots(base_choices, base_recv_ots);
+    receiver->set_base_ots(base_send_ots);
+
+    std::vector<petace::verse::block> choices(params.ext_ot_sizes / 128);
+    for (auto& choice : choices) {
+        choice = petace::verse::read_block_from_dev_urandom();
+    }
+    std::vector<std::array<petace::verse::block, 2>> send_msgs;
+    std::vector<petace::verse::block> recv_msgs;
+    std::thread thread([&] { sender->send(nets.first, send_msgs); });
+    receiver->receive(nets.second, choices, recv_msgs);
+    thread.join();
+    for (std::size_t i = 0; i < params.ext_ot_sizes; i++) {
+        std::size_t bit = petace::verse::bit_from_blocks(choices, i);
+        ASSERT_EQ(recv_msgs[i][0], send_msgs[i][bit][0]);
+        ASSERT_EQ(recv_msgs[i][1], send_msgs[i][bit][1]);
+    }
+}
+
+TEST(IKNPOtBufferTest, numa_node) {
+    petace::verse::VerseParams params;
+    params.numa_node = 0;
+    // A node alone places buffers on normal pages; only huge_pages asks for MAP_HUGETLB.
+    auto allocator = petace::verse::buffer_allocator(params);
+    ASSERT_NE(std::dynamic_pointer_cast<petace::verse::NumaAllocator>(allocator), nullptr);
+    params.huge_pages = true;
+    ASSERT_NE(std::dynamic_pointer_cast<petace::verse::HugePageAllocator>(petace::verse::buffer_allocator(params)),
+            nullptr);
+
+    // Small and large requests are both mapped and usable.
+    for (std::size_t nbyte : {std::size_t(100), petace::verse::kHugePageBytes + 1}) {
+        auto data = static_cast<petace::solo::Byte*>(allocator->allocate(nbyte));
+        ASSERT_EQ(reinterpret_cast<std::uintptr_t>(data) % 64, 0u);
+        std::fill(data, data + nbyte, petace::solo::Byte(1));
+        ASSERT_EQ(data[nbyte - 1], petace::solo::Byte(1));
+        allocator->deallocate(data, nbyte);
+    }
+}
+
+namespace {
+
+// Run a duplex extension between the two ends of a connection and check the ots of both directions.
+void check_duplex(const std::shared_ptr<petace::network::Network>& net0,
+        const std::shared_ptr<petace::network::Network>& net1, std::size_t ext_ot_size, std::size_t chunk_size) {
+    petace::verse::VerseParams params;
+    params.base_ot_sizes = 128;
+    std::vector<std::unique_ptr<petace::verse::IknpDuplexOtExt>> parties;
+    std::vector<std::vector<petace::verse::block>> choices(2);
+    std::vector<std::vector<std::array<petace::verse::block, 2>>> send_msgs(2);
+    std::vector<std::vector<petace::verse::block>> recv_msgs(2);
+    for (std::size_t party = 0; party < 2; party++) {
+        parties.emplace_back(new petace::verse::IknpDuplexOtExt(params.base_ot_sizes, ext_ot_size, 2, chunk_size));
+    }
+
+    auto run = [&](std::size_t party, const std::shared_ptr<petace::network::Network>& net) {
+        auto npot_sender = petace::verse::VerseFactory<petace::verse::BaseOtSender>::get_instance().build(
+                petace::verse::OTScheme::NaorPinkasSender, params);
+        auto npot_receiver = petace::verse::VerseFactory<petace::verse::BaseOtReceiver>::get_instance().build(
+                petace::verse::OTScheme::NaorPinkasReceiver, params);
+        std::vector<petace::verse::block> base_choices{petace::verse::read_block_from_dev_urandom()};
+        std::vector<petace::verse::block> base_recv_ots;
+        std::vector<std::array<petace::verse::block, 2>> base_send_ots;
+        // Party 0 first receives the base ots of its sender role, party 1 first sends them.
+        if (party == 0) {
+            npot_receiver->receive(net, base_choices, base_recv_ots);
+            npot_sender->send(net, base_send_ots);
+        } else {
+            npot_sender->send(net, base_send_ots);
+            npot_receiver->receive(net, base_choices, base_recv_ots);
+        }
+        parties[party]->set_base_ots(base_choices, base_recv_ots, base_send_ots);
+        for (std::size_t i = 0; i < ext_ot_size / 128; i++) {
+            choices[party].emplace_back(petace::verse::read_block_from_dev_urandom());
+        }
+        parties[party]->extend(net, send_msgs[party], choices[party], recv_msgs[party]);
+    };
+    std::thread peer([&] { run(1, net1); });
+    run(0, net0);
+    peer.join();
+
+    for (std::size_t party = 0; party < 2; party++) {
+        const auto& sender = send_msgs[1 - party];
+        ASSERT_EQ(recv_msgs[party].size(), ext_ot_size);
+        for (std::size_t i = 0; i < ext_ot_size; i++) {
+            const auto& expected = sender[i][petace::verse::bit_from_blocks(choices[party], i)];
+            ASSERT_EQ(recv_msgs[party][i][0], expected[0]);
+            ASSERT_EQ(recv_msgs[party][i][1], expected[1]);
+        }
+    }
+
+    std::vector<petace::verse::block> short_choices(ext_ot_size / 128 - 1);
+    EXPECT_THROW(parties[0]->extend(net0, send_msgs[0], short_choices, recv_msgs[0]), std::invalid_argument);
+}
+
+}  // namespace
+
+TEST(IKNPDuplexOtTest, duplex_ot) {
+    auto nets = petace::verse::LocalNetwork::create_pair();
+    check_duplex(nets.first, nets.second, 1024, 256);
+}
+
+TEST(IKNPDuplexOtTest, duplex_ot_socket) {
+    // Both parties send a full chunk before reading, over one socket connection per party.
+    std::shared_ptr<petace::network::Network> nets[2];
+    auto connect = [&](std::size_t party) {
+        petace::network::NetParams net_params;
+        net_params.remote_addr = "127.0.0.1";
+        net_params.remote_port = static_cast<std::uint16_t>(8893 - party);
+        net_params.local_addr = "127.0.0.1";
+        net_params.local_port = static_cast<std::uint16_t>(8892 + party);
+        nets[party] = petace::network::NetFactory::get_instance().build(petace::network::NetScheme::SOCKET, net_params);
+    };
+    std::thread peer(connect, 1);
+    connect(0);
+    peer.join();
+    check_duplex(nets[0], nets[1], std::size_t(1) << 15, 0);
+}
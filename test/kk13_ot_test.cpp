@@ -0,0 +1,160 @@
+// Copyright 2023 TikTok Pte. Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <array>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "verse/n-choose-one/kk13/kk13_nco_ot_ext.h"
+#include "verse/util/common.h"
+#include "verse/util/defines.h"
+#include "verse/util/local_network.h"
+#include "verse/util/thread_pool.h"
+#include "verse/verse_factory.h"
+
+namespace {
+
+struct Kk13Pair {
+    std::unique_ptr<petace::verse::NcoOtExtSender> sender;
+    std::unique_ptr<petace::verse::NcoOtExtReceiver> receiver;
+};
+
+Kk13Pair set_up_kk13(const petace::verse::VerseParams& params,
+        const std::pair<std::shared_ptr<petace::network::Network>, std::shared_ptr<petace::network::Network>>& nets) {
+    Kk13Pair pair;
+    pair.sender = petace::verse::VerseFactory<petace::verse::NcoOtExtSender>::get_instance().build(
+            petace::verse::OTScheme::Kk13Sender, params);
+    pair.receiver = petace::verse::VerseFactory<petace::verse::NcoOtExtReceiver>::get_instance().build(
+            petace::verse::OTScheme::Kk13Receiver, params);
+    auto base_receiver = petace::verse::VerseFactory<petace::verse::BaseOtReceiver>::get_instance().build(
+            petace::verse::OTScheme::NaorPinkasReceiver, params);
+    auto base_sender = petace::verse::VerseFactory<petace::verse::BaseOtSender>::get_instance().build(
+            petace::verse::OTScheme::NaorPinkasSender, params);
+
+    std::vector<petace::verse::block> base_choices{
+            petace::verse::read_block_from_dev_urandom(), petace::verse::read_block_from_dev_urandom()};
+    std::thread thread([&] {
+        std::vector<petace::verse::block> base_recv_ots;
+        base_receiver->receive(nets.first, base_choices, base_recv_ots);
+        pair.sender->set_base_ots(base_choices, base_recv_ots);
+    });
+    std::vector<std::array<petace::verse::block, 2>> base_send_ots;
+    base_sender->send(nets.second, base_send_ots);
+    pair.receiver->set_base_ots(base_send_ots);
+    thread.join();
+    return pair;
+}
+
+}  // namespace
+
+TEST(Kk13OtTest, kk13_ot) {
+    // 300 ots end in a partial column of 128.
+    std::size_t ext_ot_size = 300;
+    petace::verse::VerseParams params;
+    params.base_ot_sizes = petace::verse::kKk13BaseOts;
+    auto nets = petace::verse::LocalNetwork::create_pair();
+    auto pair = set_up_kk13(params, nets);
+
+    std::vector<petace::verse::block> choices;
+    for (std::size_t i = 0; i < ext_ot_size; i++) {
+        choices.emplace_back(_mm_set_epi64x(0, (i * 37) % petace::verse::kKk13MaxChoices));
+    }
+    std::thread thread([&] { pair.sender->send(nets.first, ext_ot_size); });
+    std::vector<petace::verse::block> messages;
+    std::size_t bytes_before = nets.second->get_bytes_sent();
+    pair.receiver->receive(nets.second, choices, messages);
+    thread.join();
+
+    // Only the two rows of each real ot are sent.
+    ASSERT_EQ(nets.second->get_bytes_sent() - bytes_before,
+            sizeof(petace::verse::FrameHeader) + ext_ot_size * 2 * sizeof(petace::verse::block));
+    ASSERT_EQ(messages.size(), ext_ot_size);
+    for (std::size_t i = 0; i < ext_ot_size; i++) {
+        for (std::size_t input = 0; input < petace::verse::kKk13MaxChoices; input += 51) {
+            petace::verse::block encoded;
+            pair.sender->encode(i, _mm_set_epi64x(0, input), encoded);
+            bool same = _mm_movemask_epi8(_mm_cmpeq_epi8(encoded, messages[i])) == 0xFFFF;
+            ASSERT_EQ(same, input == (i * 37) % petace::verse::kKk13MaxChoices);
+        }
+        petace::verse::block encoded;
+        pair.sender->encode(i, choices[i], encoded);
+        ASSERT_EQ(encoded[0], messages[i][0]);
+        ASSERT_EQ(encoded[1], messages[i][1]);
+    }
+}
+
+TEST(Kk13OtTest, kk13_ot_chosen_messages) {
+    // 256 messages per ot stream in chunks of 256 ots, so 300 ots take two frames.
+    std::size_t ext_ot_size = 300;
+    std::size_t n = petace::verse::kKk13MaxChoices;
+    petace::verse::VerseParams params;
+    params.base_ot_sizes = petace::verse::kKk13BaseOts;
+    auto nets = petace::verse::LocalNetwork::create_pair();
+    auto pair = set_up_kk13(params, nets);
+
+    std::vector<petace::verse::block> choices;
+    for (std::size_t i = 0; i < ext_ot_size; i++) {
+        choices.emplace_back(_mm_set_epi64x(0, (i * 37) % n));
+    }
+    std::vector<petace::verse::block> inputs(ext_ot_size * n);
+    for (std::size_t i = 0; i < inputs.size(); i++) {
+        inputs[i] = _mm_set_epi64x(~i, i);
+    }
+    std::thread thread([&] { pair.sender->send_chosen(nets.first, inputs, n); });
+    std::vector<petace::verse::block> messages;
+    pair.receiver->receive_chosen(nets.second, choices, n, messages);
+    thread.join();
+
+    ASSERT_EQ(messages.size(), ext_ot_size);
+    for (std::size_t i = 0; i < ext_ot_size; i++) {
+        petace::verse::block expected = inputs[i * n + (i * 37) % n];
+        ASSERT_EQ(messages[i][0], expected[0]);
+        ASSERT_EQ(messages[i][1], expected[1]);
+    }
+}
+
+TEST(Kk13OtTest, kk13_ot_except) {
+    petace::verse::VerseParams params;
+    params.base_ot_sizes = 512;
+    petace::verse::Kk13NcoOtExtSender wide_sender(params.base_ot_sizes);
+    EXPECT_THROW(wide_sender.send(nullptr, 128), std::invalid_argument);
+
+    params.base_ot_sizes = petace::verse::kKk13BaseOts;
+    auto nets = petace::verse::LocalNetwork::create_pair();
+    auto pair = set_up_kk13(params, nets);
+    std::vector<petace::verse::block> choices{_mm_set_epi64x(0, petace::verse::kKk13MaxChoices)};
+    std::vector<petace::verse::block> messages;
+    EXPECT_THROW(pair.receiver->receive(nets.second, choices, messages), std::invalid_argument);
+    petace::verse::block encoded;
+    EXPECT_THROW(pair.sender->encode(0, _mm_set_epi64x(1, 0), encoded), std::invalid_argument);
+
+    // Too many inputs per ot are rejected before either side sends anything, so neither blocks on its peer.
+    std::size_t n = petace::verse::kKk13MaxChoices + 1;
+    std::size_t sender_bytes = nets.first->get_bytes_sent();
+    std::size_t receiver_bytes = nets.second->get_bytes_sent();
+    std::vector<petace::verse::block> inputs(n);
+    EXPECT_THROW(pair.sender->send_chosen(nets.first, inputs, n), std::invalid_argument);
+    choices[0] = _mm_setzero_si128();
+    EXPECT_THROW(pair.receiver->receive_chosen(nets.second, choices, n, messages), std::invalid_argument);
+    ASSERT_EQ(nets.first->get_bytes_sent(), sender_bytes);
+    ASSERT_EQ(nets.second->get_bytes_sent(), receiver_bytes);
+
+    // Errors of an asynchronous encoding surface through its future.
+    petace::verse::ThreadPool pool(2);
+    EXPECT_THROW(pair.sender->encode_batch_async(pool, 0, 1, n, inputs.data()).get(), std::invalid_argument);
+}
@@ -16,8 +16,13 @@
 #include <unistd.h>
 
 #include <array>
+#include <cstring>
+#include <future>
 #include <memory>
 #include <string>
+#include <thread>
+#include <utility>
+#include <vector>
 
 #include "gtest/gtest.h"
 
@@ -28,6 +33,8 @@
 #include "verse/n-choose-one/kkrt/kkrt_nco_ot_ext.h"
 #include "verse/util/common.h"
 #include "verse/util/defines.h"
+#include "verse/util/local_network.h"
+#include "verse/util/thread_pool.h"
 #include "verse/verse_factory.h"
 
 class KkrtOtTest : public ::testing::Test {
@@ -152,3 +159,267 @@ TEST_F(KkrtOtTest, kkrt_ot_except) {
         return;
     }
 }
+
+TEST_F(KkrtOtTest, kkrt_ot_long_messages) {
+    std::size_t ext_ot_size = 300;
+    std::size_t msg_len = 64;
+    petace::verse::VerseParams params;
+    params.base_ot_sizes = 512;
+    auto nets = petace::verse::LocalNetwork::create_pair();
+    auto npot_receiver = petace::verse::VerseFactory<petace::verse::BaseOtReceiver>::get_instance().build(
+            petace::verse::OTScheme::NaorPinkasReceiver, params);
+    auto kkrt_sender = petace::verse::VerseFactory<petace::verse::NcoOtExtSender>::get_instance().build(
+            petace::verse::OTScheme::KkrtSender, params);
+    auto npot_sender = petace::verse::VerseFactory<petace::verse::BaseOtSender>::get_instance().build(
+            petace::verse::OTScheme::NaorPinkasSender, params);
+    auto kkrt_receiver = petace::verse::VerseFactory<petace::verse::NcoOtExtReceiver>::get_instance().build(
+            petace::verse::OTScheme::KkrtReceiver, params);
+
+    for (std::size_t i = 0; i < 4; i++) {
+        base_choices_.emplace_back(petace::verse::read_block_from_dev_urandom());
+    }
+    for (std::size_t i = 0; i < ext_ot_size; i++) {
+        ext_choices_.emplace_back(_mm_set_epi64x(i, ext_ot_size - i));
+    }
+
+    std::vector<petace::solo::Byte> send_msgs(ext_ot_size * msg_len);
+    std::vector<petace::solo::Byte> other_msgs(msg_len);
+    std::thread sender([&] {
+        std::vector<petace::verse::block> base_recv_ots;
+        npot_receiver->receive(nets.first, base_choices_, base_recv_ots);
+        kkrt_sender->set_base_ots(base_choices_, base_recv_ots);
+        kkrt_sender->send(nets.first, ext_ot_size);
+        for (std::size_t i = 0; i < ext_ot_size; i++) {
+            kkrt_sender->encode(i, ext_choices_[i], send_msgs.data() + i * msg_len, msg_len);
+        }
+        kkrt_sender->encode(0, ext_choices_[1], other_msgs.data(), msg_len);
+    });
+    std::vector<std::array<petace::verse::block, 2>> base_send_ots;
+    std::vector<petace::solo::Byte> recv_msgs;
+    npot_sender->send(nets.second, base_send_ots);
+    kkrt_receiver->set_base_ots(base_send_ots);
+    std::size_t bytes_before = nets.second->get_bytes_sent();
+    kkrt_receiver->receive(nets.second, ext_choices_, recv_msgs, msg_len);
+    sender.join();
+
+    // Only the rows of real ots are sent, not the padding to a multiple of 128.
+    ASSERT_EQ(nets.second->get_bytes_sent() - bytes_before,
+            sizeof(petace::verse::FrameHeader) + ext_ot_size * 4 * sizeof(petace::verse::block));
+
+    ASSERT_EQ(recv_msgs.size(), ext_ot_size * msg_len);
+    ASSERT_EQ(memcmp(recv_msgs.data(), send_msgs.data(), recv_msgs.size()), 0);
+    ASSERT_NE(memcmp(recv_msgs.data(), other_msgs.data(), msg_len), 0);
+}
+
+TEST_F(KkrtOtTest, kkrt_ot_iknp_bootstrap) {
+    std::size_t ext_ot_size = 256;
+    petace::verse::VerseParams params;
+    params.base_ot_sizes = 512;
+    params.ext_ot_sizes = ext_ot_size;
+    auto nets = petace::verse::LocalNetwork::create_pair();
+    auto base_receiver = petace::verse::VerseFactory<petace::verse::BaseOtReceiver>::get_instance().build(
+            petace::verse::OTScheme::IknpBaseOtReceiver, params);
+    auto kkrt_sender = petace::verse::VerseFactory<petace::verse::NcoOtExtSender>::get_instance().build(
+            petace::verse::OTScheme::KkrtSender, params);
+    auto base_sender = petace::verse::VerseFactory<petace::verse::BaseOtSender>::get_instance().build(
+            petace::verse::OTScheme::IknpBaseOtSender, params);
+    auto kkrt_receiver = petace::verse::VerseFactory<petace::verse::NcoOtExtReceiver>::get_instance().build(
+            petace::verse::OTScheme::KkrtReceiver, params);
+
+    for (std::size_t i = 0; i < 4; i++) {
+        base_choices_.emplace_back(petace::verse::read_block_from_dev_urandom());
+    }
+    for (std::size_t i = 0; i < ext_ot_size; i++) {
+        ext_choices_.emplace_back(_mm_set_epi64x(ext_ot_size - i, i));
+    }
+
+    std::vector<petace::verse::block> base_recv_ots;
+    std::thread sender([&] {
+        base_receiver->receive(nets.first, base_choices_, base_recv_ots);
+        kkrt_sender->set_base_ots(base_choices_, base_recv_ots);
+        kkrt_sender->send(nets.first, ext_ot_size);
+    });
+    std::vector<std::array<petace::verse::block, 2>> base_send_ots;
+    std::vector<petace::verse::block> recv_msgs;
+    base_sender->send(nets.second, base_send_ots);
+    kkrt_receiver->set_base_ots(base_send_ots);
+    kkrt_receiver->receive(nets.second, ext_choices_, recv_msgs);
+    sender.join();
+
+    ASSERT_EQ(base_send_ots.size(), params.base_ot_sizes);
+    ASSERT_EQ(base_recv_ots.size(), params.base_ot_sizes);
+    for (std::size_t i = 0; i < params.base_ot_sizes; i++) {
+        std::size_t bit = petace::verse::bit_from_blocks(base_choices_, i);
+        ASSERT_EQ(base_recv_ots[i][0], base_send_ots[i][bit][0]);
+        ASSERT_EQ(base_recv_ots[i][1], base_send_ots[i][bit][1]);
+    }
+    for (std::size_t i = 0; i < ext_ot_size; i++) {
+        petace::verse::block encoded;
+        kkrt_sender->encode(i, ext_choices_[i], encoded);
+        ASSERT_EQ(recv_msgs[i][0], encoded[0]);
+        ASSERT_EQ(recv_msgs[i][1], encoded[1]);
+    }
+}
+
+TEST_F(KkrtOtTest, kkrt_ot_chosen_messages) {
+    // 1000 messages per ot stream in chunks of 65 ots, so 150 ots take three frames.
+    std::size_t ext_ot_size = 150;
+    std::size_t n = 1000;
+    petace::verse::VerseParams params;
+    params.base_ot_sizes = 512;
+    auto nets = petace::verse::LocalNetwork::create_pair();
+    auto npot_receiver = petace::verse::VerseFactory<petace::verse::BaseOtReceiver>::get_instance().build(
+            petace::verse::OTScheme::NaorPinkasReceiver, params);
+    auto kkrt_sender = petace::verse::VerseFactory<petace::verse::NcoOtExtSender>::get_instance().build(
+            petace::verse::OTScheme::KkrtSender, params);
+    auto npot_sender = petace::verse::VerseFactory<petace::verse::BaseOtSender>::get_instance().build(
+            petace::verse::OTScheme::NaorPinkasSender, params);
+    auto kkrt_receiver = petace::verse::VerseFactory<petace::verse::NcoOtExtReceiver>::get_instance().build(
+            petace::verse::OTScheme::KkrtReceiver, params);
+
+    for (std::size_t i = 0; i < 4; i++) {
+        base_choices_.emplace_back(petace::verse::read_block_from_dev_urandom());
+    }
+    for (std::size_t i = 0; i < ext_ot_size; i++) {
+        ext_choices_.emplace_back(_mm_set_epi64x(0, (i * 7) % n));
+    }
+    std::vector<petace::verse::block> inputs(ext_ot_size * n);
+    for (std::size_t i = 0; i < inputs.size(); i++) {
+        inputs[i] = _mm_set_epi64x(i, ~i);
+    }
+
+    std::thread sender([&] {
+        std::vector<petace::verse::block> base_recv_ots;
+        npot_receiver->receive(nets.first, base_choices_, base_recv_ots);
+        kkrt_sender->set_base_ots(base_choices_, base_recv_ots);
+        kkrt_sender->send_chosen(nets.first, inputs, n);
+    });
+    std::vector<std::array<petace::verse::block, 2>> base_send_ots;
+    npot_sender->send(nets.second, base_send_ots);
+    kkrt_receiver->set_base_ots(base_send_ots);
+    kkrt_receiver->receive_chosen(nets.second, ext_choices_, n, msg1_);
+    sender.join();
+
+    ASSERT_EQ(msg1_.size(), ext_ot_size);
+    for (std::size_t i = 0; i < ext_ot_size; i++) {
+        petace::verse::block expected = inputs[i * n + (i * 7) % n];
+        ASSERT_EQ(msg1_[i][0], expected[0]);
+        ASSERT_EQ(msg1_[i][1], expected[1]);
+    }
+
+    // Invalid calls are rejected before either side sends anything.
+    std::size_t sender_bytes = nets.first->get_bytes_sent();
+    std::size_t receiver_bytes = nets.second->get_bytes_sent();
+    std::vector<petace::verse::block> out_of_range{_mm_set_epi64x(0, n)};
+    EXPECT_THROW(kkrt_receiver->receive_chosen(nets.second, out_of_range, n, msg1_), std::invalid_argument);
+    EXPECT_THROW(kkrt_receiver->receive_chosen(nets.second, {}, n, msg1_), std::invalid_argument);
+    EXPECT_THROW(kkrt_sender->send_chosen(nets.first, inputs, n + 1), std::invalid_argument);
+    ASSERT_EQ(nets.first->get_bytes_sent(), sender_bytes);
+    ASSERT_EQ(nets.second->get_bytes_sent(), receiver_bytes);
+}
+
+TEST_F(KkrtOtTest, kkrt_ot_async) {
+    // Two overlapping encode_batch_async calls with different n share one sender and a pool of two workers.
+    std::size_t ext_ot_size = 300;
+    std::size_t small_n = 16;
+    std::size_t large_n = 40;
+    petace::verse::VerseParams params;
+    params.base_ot_sizes = 512;
+    auto nets = petace::verse::LocalNetwork::create_pair();
+    auto sender = petace::verse::VerseFactory<petace::verse::NcoOtExtSender>::get_instance().build(
+            petace::verse::OTScheme::KkrtSender, params);
+    auto receiver = petace::verse::VerseFactory<petace::verse::NcoOtExtReceiver>::get_instance().build(
+            petace::verse::OTScheme::KkrtReceiver, params);
+    std::vector<petace::verse::block> ext_choices;
+    for (std::size_t i = 0; i < ext_ot_size; i++) {
+        ext_choices.emplace_back(_mm_set_epi64x(0, (i * 5) % small_n));
+    }
+    std::vector<petace::verse::block> messages;
+    std::thread thread([&] {
+        auto npot_receiver = petace::verse::VerseFactory<petace::verse::BaseOtReceiver>::get_instance().build(
+                petace::verse::OTScheme::NaorPinkasReceiver, params);
+        std::vector<petace::verse::block> choices;
+        for (std::size_t i = 0; i < 4; i++) {
+            choices.emplace_back(petace::verse::read_block_from_dev_urandom());
+        }
+        std::vector<petace::verse::block> base_recv_ots;
+        npot_receiver->receive(nets.first, choices, base_recv_ots);
+        sender->set_base_ots(choices, base_recv_ots);
+        sender->send(nets.first, ext_ot_size);
+    });
+    auto npot_sender = petace::verse::VerseFactory<petace::verse::BaseOtSender>::get_instance().build(
+            petace::verse::OTScheme::NaorPinkasSender, params);
+    std::vector<std::array<petace::verse::block, 2>> base_send_ots;
+    npot_sender->send(nets.second, base_send_ots);
+    receiver->set_base_ots(base_send_ots);
+    receiver->receive(nets.second, ext_choices, messages);
+    thread.join();
+
+    std::vector<petace::verse::block> small(ext_ot_size * small_n);
+    std::vector<petace::verse::block> large(ext_ot_size * large_n);
+    petace::verse::ThreadPool pool(2);
+    auto small_job = sender->encode_batch_async(pool, 0, ext_ot_size, small_n, small.data());
+    auto large_job = sender->encode_batch_async(pool, 0, ext_ot_size, large_n, large.data());
+    small_job.get();
+    large_job.get();
+
+    ASSERT_EQ(messages.size(), ext_ot_size);
+    for (std::size_t i = 0; i < ext_ot_size; i++) {
+        std::size_t choice = (i * 5) % small_n;
+        ASSERT_EQ(messages[i][0], small[i * small_n + choice][0]);
+        ASSERT_EQ(messages[i][1], small[i * small_n + choice][1]);
+        ASSERT_EQ(messages[i][0], large[i * large_n + choice][0]);
+        ASSERT_EQ(messages[i][1], large[i * large_n + choice][1]);
+    }
+}
+
+TEST_F(KkrtOtTest, kkrt_ot_codeword) {
+    std::size_t ext_ot_size = 256;
+    auto nets = petace::verse::LocalNetwork::create_pair();
+    petace::verse::KkrtNcoOtExtSender kkrt_sender(512);
+    petace::verse::KkrtNcoOtExtReceiver kkrt_receiver(512);
+    petace::verse::VerseParams params;
+    params.base_ot_sizes = 512;
+    EXPECT_THROW(kkrt_sender.precompute(_mm_set_epi64x(0, 1)), std::logic_error);
+
+    for (std::size_t i = 0; i < 4; i++) {
+        base_choices_.emplace_back(petace::verse::read_block_from_dev_urandom());
+    }
+    // Every ot chooses the same input, as a cuckoo bucket would for an item mapped to many indices.
+    petace::verse::block input = petace::verse::read_block_from_dev_urandom();
+    ext_choices_.assign(ext_ot_size, input);
+    std::thread sender([&] {
+        auto npot_receiver = petace::verse::VerseFactory<petace::verse::BaseOtReceiver>::get_instance().build(
+                petace::verse::OTScheme::NaorPinkasReceiver, params);
+        std::vector<petace::verse::block> base_recv_ots;
+        npot_receiver->receive(nets.first, base_choices_, base_recv_ots);
+        kkrt_sender.set_base_ots(base_choices_, base_recv_ots);
+        kkrt_sender.send(nets.first, ext_ot_size);
+    });
+    auto npot_sender = petace::verse::VerseFactory<petace::verse::BaseOtSender>::get_instance().build(
+            petace::verse::OTScheme::NaorPinkasSender, params);
+    std::vector<std::array<petace::verse::block, 2>> base_send_ots;
+    npot_sender->send(nets.second, base_send_ots);
+    kkrt_receiver.set_base_ots(base_send_ots);
+    kkrt_receiver.receive(nets.second, ext_choices_, msg1_);
+    sender.join();
+
+    petace::verse::KkrtCodeword codeword = kkrt_sender.precompute(input);
+    ASSERT_EQ(codeword.code.size(), std::size_t(4));
+    for (std::size_t i = 0; i < ext_ot_size; i++) {
+        petace::verse::block expected;
+        petace::verse::block output;
+        kkrt_sender.encode(i, input, expected);
+        kkrt_sender.encode(i, codeword, output);
+        ASSERT_EQ(output[0], expected[0]);
+        ASSERT_EQ(output[1], expected[1]);
+        ASSERT_EQ(output[0], msg1_[i][0]);
+        ASSERT_EQ(output[1], msg1_[i][1]);
+    }
+
+    // Code words are bound to the base ots they were made under.
+    std::vector<petace::verse::block> base_recv_ots(512, _mm_set_epi64x(0, 0));
+    kkrt_sender.set_base_ots(base_choices_, base_recv_ots);
+    petace::verse::block output;
+    EXPECT_THROW(kkrt_sender.encode(0, codeword, output), std::invalid_argument);
+}
@@ -0,0 +1,89 @@
+// Copyright 2023 TikTok Pte. Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "verse/oprf/mp_oprf.h"
+#include "verse/util/defines.h"
+#include "verse/util/local_network.h"
+
+namespace {
+
+void check_mp_oprf(std::size_t num_threads) {
+    // 1000 receiver items; the sender evaluates 500 of them and 700 others, neither a multiple of 128.
+    std::size_t receiver_size = 1000;
+    petace::verse::VerseParams params;
+    params.base_ot_sizes = petace::verse::kMpOprfWidth;
+    params.num_threads = num_threads;
+    auto nets = petace::verse::LocalNetwork::create_pair();
+    petace::verse::MpOprfSender sender(params);
+    petace::verse::MpOprfReceiver receiver(params);
+
+    std::vector<petace::verse::block> receiver_items;
+    for (std::size_t i = 0; i < receiver_size; i++) {
+        receiver_items.emplace_back(_mm_set_epi64x(7, i));
+    }
+    std::vector<petace::verse::block> sender_items;
+    for (std::size_t i = 0; i < 1200; i++) {
+        sender_items.emplace_back(_mm_set_epi64x(7, 2 * i));
+    }
+
+    std::thread thread([&] { sender.setup(nets.first, receiver_size); });
+    std::vector<petace::verse::block> receiver_outputs;
+    receiver.receive(nets.second, receiver_items, receiver_outputs);
+    thread.join();
+    std::vector<petace::verse::block> sender_outputs;
+    sender.evaluate(sender_items, sender_outputs);
+
+    ASSERT_EQ(receiver_outputs.size(), receiver_size);
+    ASSERT_EQ(sender_outputs.size(), sender_items.size());
+    for (std::size_t i = 0; i < sender_items.size(); i++) {
+        bool shared = 2 * i < receiver_size;
+        std::size_t match = 0;
+        for (std::size_t k = 0; k < receiver_size; k++) {
+            match += _mm_movemask_epi8(_mm_cmpeq_epi8(sender_outputs[i], receiver_outputs[k])) == 0xFFFF;
+        }
+        ASSERT_EQ(match, shared ? 1u : 0u);
+        if (shared) {
+            ASSERT_EQ(sender_outputs[i][0], receiver_outputs[2 * i][0]);
+            ASSERT_EQ(sender_outputs[i][1], receiver_outputs[2 * i][1]);
+        }
+    }
+}
+
+}  // namespace
+
+TEST(MpOprfTest, mp_oprf) {
+    check_mp_oprf(1);
+}
+
+TEST(MpOprfTest, mp_oprf_threads) {
+    check_mp_oprf(3);
+}
+
+TEST(MpOprfTest, mp_oprf_except) {
+    petace::verse::VerseParams params;
+    params.base_ot_sizes = 600;
+    EXPECT_THROW(petace::verse::MpOprfSender sender(params), std::invalid_argument);
+    EXPECT_THROW(petace::verse::MpOprfReceiver receiver(params), std::invalid_argument);
+    params.base_ot_sizes = petace::verse::kMpOprfWidth;
+    petace::verse::MpOprfSender sender(params);
+    std::vector<petace::verse::block> outputs;
+    EXPECT_THROW(sender.evaluate({_mm_set_epi64x(0, 1)}, outputs), std::logic_error);
+}
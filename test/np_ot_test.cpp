@@ -18,6 +18,7 @@
 #include <array>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "gtest/gtest.h"
 
@@ -28,6 +29,7 @@
 #include "verse/two-choose-one/iknp/iknp_ot_ext.h"
 #include "verse/util/common.h"
 #include "verse/util/defines.h"
+#include "verse/util/ec_batch.h"
 #include "verse/verse_factory.h"
 
 class NPOtTest : public ::testing::Test {
@@ -106,3 +108,59 @@ TEST_F(NPOtTest, np_ot) {
         return;
     }
 }
+
+TEST(EcBatchTest, round_trip) {
+    // Enough points to be split across several threads on multi-core hosts.
+    std::size_t n = 1000;
+    petace::verse::EC ec(petace::verse::kCurveID, petace::solo::HashScheme::SHA_256);
+    petace::solo::PRNGFactory prng_factory(petace::solo::PRNGScheme::AES_ECB_CTR);
+    std::shared_ptr<petace::solo::PRNG> prng = prng_factory.create();
+
+    std::vector<std::shared_ptr<petace::verse::EC::Point>> points(n);
+    std::vector<std::shared_ptr<petace::verse::EC::Point>> decoded(n);
+    std::vector<petace::solo::Byte> expected(n * petace::verse::kEccPointLen);
+    for (std::size_t i = 0; i < n; i++) {
+        petace::verse::EC::SecretKey sk;
+        points[i] = std::make_shared<petace::verse::EC::Point>(ec);
+        decoded[i] = std::make_shared<petace::verse::EC::Point>(ec);
+        ec.create_secret_key(prng, sk);
+        ec.create_public_key(sk, *points[i]);
+        ec.point_to_bytes(*points[i], petace::verse::kEccPointLen, expected.data() + i * petace::verse::kEccPointLen);
+    }
+
+    std::vector<petace::solo::Byte> encoded(n * petace::verse::kEccPointLen);
+    petace::verse::points_to_bytes(ec, points.data(), n, encoded.data());
+    ASSERT_EQ(encoded, expected);
+
+    petace::verse::points_from_bytes(ec, encoded.data(), n, decoded.data());
+    std::vector<petace::solo::Byte> reencoded(n * petace::verse::kEccPointLen);
+    petace::verse::points_to_bytes(ec, decoded.data(), n, reencoded.data());
+    ASSERT_EQ(reencoded, expected);
+}
+
+TEST(EcBatchTest, invalid_point) {
+    // A corrupt encoding in the last range must reach the caller as an exception, not terminate a worker.
+    std::size_t n = 1000;
+    petace::verse::EC ec(petace::verse::kCurveID, petace::solo::HashScheme::SHA_256);
+    petace::solo::PRNGFactory prng_factory(petace::solo::PRNGScheme::AES_ECB_CTR);
+    std::shared_ptr<petace::solo::PRNG> prng = prng_factory.create();
+
+    std::vector<std::shared_ptr<petace::verse::EC::Point>> points(n);
+    std::vector<std::shared_ptr<petace::verse::EC::Point>> decoded(n);
+    for (std::size_t i = 0; i < n; i++) {
+        petace::verse::EC::SecretKey sk;
+        points[i] = std::make_shared<petace::verse::EC::Point>(ec);
+        decoded[i] = std::make_shared<petace::verse::EC::Point>(ec);
+        ec.create_secret_key(prng, sk);
+        ec.create_public_key(sk, *points[i]);
+    }
+    std::vector<petace::solo::Byte> encoded(n * petace::verse::kEccPointLen);
+    petace::verse::ThreadPool pool(3);
+    petace::verse::points_to_bytes(ec, points.data(), n, encoded.data(), &pool);
+    encoded[(n - 1) * petace::verse::kEccPointLen] = 0x07;
+
+    EXPECT_ANY_THROW(petace::verse::points_from_bytes(ec, encoded.data(), n, decoded.data(), &pool));
+    // The pool is still usable afterwards.
+    petace::verse::points_to_bytes(ec, points.data(), n, encoded.data(), &pool);
+    petace::verse::points_from_bytes(ec, encoded.data(), n, decoded.data(), &pool);
+}
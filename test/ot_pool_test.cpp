@@ -0,0 +1,108 @@
+// Copyright 2023 TikTok Pte. Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <array>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "verse/two-choose-one/ot-pool/ot_pool.h"
+#include "verse/util/common.h"
+#include "verse/util/defines.h"
+#include "verse/util/local_network.h"
+
+class OtPoolTest : public ::testing::Test {
+public:
+    void SetUp() override {
+        auto refill_nets = petace::verse::LocalNetwork::create_pair();
+        auto online_nets = petace::verse::LocalNetwork::create_pair();
+        sender_online_ = online_nets.first;
+        receiver_online_ = online_nets.second;
+
+        petace::verse::VerseParams params;
+        params.base_ot_sizes = 128;
+        params.ext_ot_sizes = 1024;
+        petace::verse::OtPoolParams pool_params;
+        pool_params.low_watermark = 1024;
+        pool_params.high_watermark = 4096;
+
+        params.net = refill_nets.first;
+        sender_pool_.reset(new petace::verse::OtPoolSender(params, pool_params));
+        params.net = refill_nets.second;
+        receiver_pool_.reset(new petace::verse::OtPoolReceiver(params, pool_params));
+
+        std::thread sender_start([this] { sender_pool_->start(); });
+        receiver_pool_->start();
+        sender_start.join();
+    }
+
+    void TearDown() override {
+        // The receiver drives the refill, so it stops first and releases the sender.
+        receiver_pool_.reset();
+        sender_pool_.reset();
+    }
+
+public:
+    std::shared_ptr<petace::network::Network> sender_online_ = nullptr;
+    std::shared_ptr<petace::network::Network> receiver_online_ = nullptr;
+    std::unique_ptr<petace::verse::OtPoolSender> sender_pool_ = nullptr;
+    std::unique_ptr<petace::verse::OtPoolReceiver> receiver_pool_ = nullptr;
+};
+
+TEST_F(OtPoolTest, draw) {
+    // Draw sizes that are not aligned to batches and one draw larger than the high watermark.
+    std::vector<std::size_t> sizes = {1, 100, 1000, 3000, 8000, 77};
+    for (auto n : sizes) {
+        std::vector<petace::verse::block> choices((n + 127) / 128);
+        for (auto& choice : choices) {
+            choice = petace::verse::read_block_from_dev_urandom();
+        }
+        std::vector<std::array<petace::verse::block, 2>> send_msgs;
+        std::vector<petace::verse::block> recv_msgs;
+        std::thread sender([&] { sender_pool_->draw(sender_online_, n, send_msgs); });
+        receiver_pool_->draw(receiver_online_, choices, n, recv_msgs);
+        sender.join();
+
+        ASSERT_EQ(send_msgs.size(), n);
+        ASSERT_EQ(recv_msgs.size(), n);
+        for (std::size_t i = 0; i < n; i++) {
+            std::size_t bit = petace::verse::bit_from_blocks(choices, i);
+            ASSERT_EQ(recv_msgs[i][0], send_msgs[i][bit][0]);
+            ASSERT_EQ(recv_msgs[i][1], send_msgs[i][bit][1]);
+            ASSERT_NE(recv_msgs[i][0], send_msgs[i][1 - bit][0]);
+        }
+    }
+    auto stats = receiver_pool_->get_stats();
+    ASSERT_EQ(stats.consumed, 12178u);
+    ASSERT_GE(stats.produced, stats.consumed);
+    ASSERT_GT(stats.fill_rate(), 0.0);
+}
+
+TEST_F(OtPoolTest, invalid_params) {
+    petace::verse::VerseParams params;
+    params.base_ot_sizes = 128;
+    params.ext_ot_sizes = 1024;
+    petace::verse::OtPoolParams pool_params;
+    EXPECT_THROW(petace::verse::OtPoolSender(params, pool_params), std::invalid_argument);
+    params.net = sender_online_;
+    pool_params.low_watermark = 2;
+    pool_params.high_watermark = 1;
+    EXPECT_THROW(petace::verse::OtPoolReceiver(params, pool_params), std::invalid_argument);
+    pool_params = petace::verse::OtPoolParams();
+    params.ext_ot_sizes = 1000;
+    EXPECT_THROW(petace::verse::OtPoolSender(params, pool_params), std::invalid_argument);
+    EXPECT_THROW(petace::verse::OtPoolReceiver(params, pool_params), std::invalid_argument);
+}
@@ -0,0 +1,163 @@
+// Copyright 2023 TikTok Pte. Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <array>
+#include <functional>
+#include <future>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "verse/session/ot_session_manager.h"
+#include "verse/util/common.h"
+#include "verse/util/defines.h"
+#include "verse/util/local_network.h"
+#include "verse/verse_factory.h"
+
+class OtSessionTest : public ::testing::Test {
+public:
+    // The peer of a sender session: naor-pinkas sender followed by iknp receiver.
+    static void run_receiver_peer(const std::shared_ptr<petace::network::Network>& net, std::size_t batches,
+            std::vector<std::vector<petace::verse::block>>& choices,
+            std::vector<std::vector<petace::verse::block>>& messages) {
+        petace::verse::VerseParams params;
+        params.base_ot_sizes = 128;
+        params.ext_ot_sizes = 512;
+        auto npot_sender = petace::verse::VerseFactory<petace::verse::BaseOtSender>::get_instance().build(
+                petace::verse::OTScheme::NaorPinkasSender, params);
+        auto iknp_receiver = petace::verse::VerseFactory<petace::verse::OtExtReceiver>::get_instance().build(
+                petace::verse::OTScheme::IknpReceiver, params);
+
+        std::vector<std::array<petace::verse::block, 2>> base_send_ots;
+        npot_sender->send(net, base_send_ots);
+        iknp_receiver->set_base_ots(base_send_ots);
+
+        choices.resize(batches);
+        messages.resize(batches);
+        for (std::size_t i = 0; i < batches; i++) {
+            for (std::size_t j = 0; j < params.ext_ot_sizes / 128; j++) {
+                choices[i].emplace_back(petace::verse::read_block_from_dev_urandom());
+            }
+            iknp_receiver->receive(net, choices[i], messages[i]);
+        }
+    }
+};
+
+TEST_F(OtSessionTest, many_sender_sessions) {
+    const std::size_t num_sessions = 8;
+    const std::size_t batches = 3;
+
+    petace::verse::OtSessionManager manager(3);
+    std::vector<std::size_t> session_ids;
+    std::vector<std::shared_ptr<petace::network::Network>> peer_nets;
+    for (std::size_t i = 0; i < num_sessions; i++) {
+        auto nets = petace::verse::LocalNetwork::create_pair();
+        petace::verse::VerseParams params;
+        params.base_ot_sizes = 128;
+        params.ext_ot_sizes = 512;
+        params.net = nets.first;
+        session_ids.emplace_back(manager.open_session(params, petace::verse::OtRole::Sender));
+        peer_nets.emplace_back(nets.second);
+    }
+    ASSERT_EQ(manager.size(), num_sessions);
+
+    std::vector<std::vector<std::vector<petace::verse::block>>> peer_choices(num_sessions);
+    std::vector<std::vector<std::vector<petace::verse::block>>> peer_messages(num_sessions);
+    std::vector<std::thread> peers;
+    for (std::size_t i = 0; i < num_sessions; i++) {
+        peers.emplace_back(run_receiver_peer, peer_nets[i], batches, std::ref(peer_choices[i]),
+                std::ref(peer_messages[i]));
+    }
+
+    std::vector<std::vector<std::vector<std::array<petace::verse::block, 2>>>> server_messages(
+            num_sessions, std::vector<std::vector<std::array<petace::verse::block, 2>>>(batches));
+    std::vector<std::future<void>> done;
+    for (std::size_t j = 0; j < batches; j++) {
+        for (std::size_t i = 0; i < num_sessions; i++) {
+            done.emplace_back(manager.send(session_ids[i], server_messages[i][j]));
+        }
+    }
+    for (auto& f : done) {
+        f.get();
+    }
+    for (auto& peer : peers) {
+        peer.join();
+    }
+
+    for (std::size_t i = 0; i < num_sessions; i++) {
+        for (std::size_t j = 0; j < batches; j++) {
+            ASSERT_EQ(server_messages[i][j].size(), peer_messages[i][j].size());
+            for (std::size_t k = 0; k < peer_messages[i][j].size(); k++) {
+                std::size_t bit = petace::verse::bit_from_blocks(peer_choices[i][j], k);
+                ASSERT_EQ(peer_messages[i][j][k][0], server_messages[i][j][k][bit][0]);
+                ASSERT_EQ(peer_messages[i][j][k][1], server_messages[i][j][k][bit][1]);
+            }
+        }
+        auto stats = manager.get_stats(session_ids[i]);
+        ASSERT_EQ(stats.batches, batches);
+        ASSERT_EQ(stats.ots, batches * 512);
+        ASSERT_GT(stats.bytes_received, 0u);
+        manager.close_session(session_ids[i]);
+    }
+    ASSERT_EQ(manager.size(), 0u);
+}
+
+TEST_F(OtSessionTest, slow_peer_does_not_stall_others) {
+    // A single compute thread; the peer of the first session only shows up after the second session is done.
+    petace::verse::OtSessionManager manager(1);
+    std::vector<std::size_t> session_ids;
+    std::vector<std::shared_ptr<petace::network::Network>> peer_nets;
+    for (std::size_t i = 0; i < 2; i++) {
+        auto nets = petace::verse::LocalNetwork::create_pair();
+        petace::verse::VerseParams params;
+        params.base_ot_sizes = 128;
+        params.ext_ot_sizes = 512;
+        params.net = nets.first;
+        session_ids.emplace_back(manager.open_session(params, petace::verse::OtRole::Sender));
+        peer_nets.emplace_back(nets.second);
+    }
+
+    std::vector<std::vector<std::vector<petace::verse::block>>> peer_choices(2);
+    std::vector<std::vector<std::vector<petace::verse::block>>> peer_messages(2);
+    std::vector<std::vector<std::array<petace::verse::block, 2>>> server_messages(2);
+    std::thread fast_peer(run_receiver_peer, peer_nets[1], 1, std::ref(peer_choices[1]), std::ref(peer_messages[1]));
+    manager.send(session_ids[1], server_messages[1]).get();
+    fast_peer.join();
+    ASSERT_EQ(manager.get_stats(session_ids[1]).batches, 1u);
+
+    std::thread slow_peer(run_receiver_peer, peer_nets[0], 1, std::ref(peer_choices[0]), std::ref(peer_messages[0]));
+    manager.send(session_ids[0], server_messages[0]).get();
+    slow_peer.join();
+    for (std::size_t i = 0; i < 2; i++) {
+        ASSERT_EQ(server_messages[i].size(), peer_messages[i][0].size());
+        for (std::size_t k = 0; k < peer_messages[i][0].size(); k++) {
+            std::size_t bit = petace::verse::bit_from_blocks(peer_choices[i][0], k);
+            ASSERT_EQ(peer_messages[i][0][k][0], server_messages[i][k][bit][0]);
+            ASSERT_EQ(peer_messages[i][0][k][1], server_messages[i][k][bit][1]);
+        }
+        manager.close_session(session_ids[i]);
+    }
+    EXPECT_THROW(manager.close_session(session_ids[0]), std::invalid_argument);
+}
+
+TEST_F(OtSessionTest, invalid_session) {
+    petace::verse::OtSessionManager manager(1);
+    petace::verse::VerseParams params;
+    params.base_ot_sizes = 128;
+    params.ext_ot_sizes = 512;
+    EXPECT_THROW(manager.open_session(params, petace::verse::OtRole::Sender), std::invalid_argument);
+    EXPECT_THROW(manager.get_stats(0), std::invalid_argument);
+}
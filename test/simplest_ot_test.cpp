@@ -0,0 +1,72 @@
+// Copyright 2023 TikTok Pte. Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "verse/base-ot/simplest-ot/simplest_ot.h"
+#include "verse/util/common.h"
+#include "verse/util/defines.h"
+#include "verse/util/local_network.h"
+#include "verse/verse_factory.h"
+
+TEST(SimplestOtTest, simplest_ot) {
+    for (std::size_t base_ot_sizes : {128, 512}) {
+        petace::verse::VerseParams params;
+        params.base_ot_sizes = base_ot_sizes;
+        auto nets = petace::verse::LocalNetwork::create_pair();
+        auto ot_sender = petace::verse::VerseFactory<petace::verse::BaseOtSender>::get_instance().build(
+                petace::verse::OTScheme::SimplestOtSender, params);
+        auto ot_receiver = petace::verse::VerseFactory<petace::verse::BaseOtReceiver>::get_instance().build(
+                petace::verse::OTScheme::SimplestOtReceiver, params);
+
+        std::vector<petace::verse::block> choices(base_ot_sizes / 128);
+        for (auto& choice : choices) {
+            choice = petace::verse::read_block_from_dev_urandom();
+        }
+        std::vector<std::array<petace::verse::block, 2>> send_msgs;
+        std::vector<petace::verse::block> recv_msgs;
+        std::thread sender([&] { ot_sender->send(nets.first, send_msgs); });
+        ot_receiver->receive(nets.second, choices, recv_msgs);
+        sender.join();
+
+        ASSERT_EQ(send_msgs.size(), base_ot_sizes);
+        ASSERT_EQ(recv_msgs.size(), base_ot_sizes);
+        for (std::size_t i = 0; i < base_ot_sizes; i++) {
+            std::size_t bit = petace::verse::bit_from_blocks(choices, i);
+            ASSERT_EQ(recv_msgs[i][0], send_msgs[i][bit][0]);
+            ASSERT_EQ(recv_msgs[i][1], send_msgs[i][bit][1]);
+            ASSERT_NE(recv_msgs[i][0], send_msgs[i][1 - bit][0]);
+        }
+    }
+}
+
+TEST(SimplestOtTest, invalid_point) {
+    petace::verse::VerseParams params;
+    params.base_ot_sizes = 128;
+    auto nets = petace::verse::LocalNetwork::create_pair();
+    auto ot_receiver = petace::verse::VerseFactory<petace::verse::BaseOtReceiver>::get_instance().build(
+            petace::verse::OTScheme::SimplestOtReceiver, params);
+    // 0x05 is not the prefix of any compressed point encoding.
+    std::uint8_t bad_point[petace::verse::kEccPointLen] = {5};
+    petace::verse::send_frame(nets.first, bad_point, sizeof(bad_point));
+    std::vector<petace::verse::block> choices(1);
+    std::vector<petace::verse::block> recv_msgs;
+    EXPECT_THROW(ot_receiver->receive(nets.second, choices, recv_msgs), std::runtime_error);
+}
@@ -0,0 +1,195 @@
+// Copyright 2023 TikTok Pte. Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "verse/two-choose-one/iknp/iknp_ot_ext.h"
+#include "verse/util/common.h"
+#include "verse/util/local_network.h"
+#include "verse/util/striped_network.h"
+#include "verse/verse_factory.h"
+
+namespace {
+
+std::pair<std::shared_ptr<petace::network::Network>, std::shared_ptr<petace::network::Network>> striped_pair(
+        std::size_t k, std::size_t stripe_bytes) {
+    std::vector<std::shared_ptr<petace::network::Network>> first;
+    std::vector<std::shared_ptr<petace::network::Network>> second;
+    for (std::size_t i = 0; i < k; i++) {
+        auto nets = petace::verse::LocalNetwork::create_pair();
+        first.emplace_back(nets.first);
+        second.emplace_back(nets.second);
+    }
+    return std::make_pair(std::make_shared<petace::verse::StripedNetwork>(first, stripe_bytes),
+            std::make_shared<petace::verse::StripedNetwork>(second, stripe_bytes));
+}
+
+// A connection whose flow delivers at most window bytes per round trip, as a TCP flow bound by its congestion window
+// on a long link does. Sending blocks for one round trip per window.
+class WindowedNetwork : public petace::network::Network {
+public:
+    WindowedNetwork(std::shared_ptr<petace::network::Network> inner, std::size_t window, std::chrono::milliseconds rtt)
+            : inner_(std::move(inner)), window_(window), rtt_(rtt) {
+    }
+
+    int send_data(const void* data, std::size_t nbyte) override {
+        const char* ptr = static_cast<const char*>(data);
+        for (std::size_t begin = 0; begin < nbyte; begin += window_) {
+            std::this_thread::sleep_for(rtt_);
+            inner_->send_data(ptr + begin, std::min(window_, nbyte - begin));
+        }
+        return static_cast<int>(nbyte);
+    }
+
+    int recv_data(void* data, std::size_t nbyte) override {
+        return inner_->recv_data(data, nbyte);
+    }
+
+    void warmup() override {
+    }
+
+    std::size_t get_bytes_sent() const override {
+        return inner_->get_bytes_sent();
+    }
+
+    std::size_t get_bytes_received() const override {
+        return inner_->get_bytes_received();
+    }
+
+private:
+    std::shared_ptr<petace::network::Network> inner_ = nullptr;
+
+    std::size_t window_ = 0;
+
+    std::chrono::milliseconds rtt_{0};
+};
+
+// Return the seconds it takes to send nbyte bytes in one call over k windowed connections.
+double windowed_seconds(std::size_t k, std::size_t nbyte) {
+    std::vector<std::shared_ptr<petace::network::Network>> first;
+    std::vector<std::shared_ptr<petace::network::Network>> second;
+    for (std::size_t i = 0; i < k; i++) {
+        auto nets = petace::verse::LocalNetwork::create_pair();
+        first.emplace_back(std::make_shared<WindowedNetwork>(nets.first, 1 << 16, std::chrono::milliseconds(5)));
+        second.emplace_back(nets.second);
+    }
+    petace::verse::StripedNetwork sender(first);
+    petace::verse::StripedNetwork receiver(second);
+    std::vector<char> data(nbyte, 1);
+    std::vector<char> received(nbyte);
+    auto begin = std::chrono::steady_clock::now();
+    std::thread thread([&] { receiver.recv_data(received.data(), nbyte); });
+    sender.send_data(data.data(), nbyte);
+    thread.join();
+    EXPECT_EQ(received, data);
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+}
+
+}  // namespace
+
+TEST(StripedNetworkTest, window_bound_link) {
+    // 2 MB take 32 round trips over one window-bound flow and 8 over each of four.
+    std::size_t nbyte = std::size_t(1) << 21;
+    double one = windowed_seconds(1, nbyte);
+    double four = windowed_seconds(4, nbyte);
+    ASSERT_LT(four * 2, one);
+}
+
+TEST(StripedNetworkTest, byte_stream) {
+    // Receives are cut at other boundaries than sends, so calls are split and merged on the receiving side.
+    auto nets = striped_pair(3, 1000);
+    std::vector<std::size_t> send_sizes = {1, 999, 1000, 1001, 70000, 0, 5};
+    std::vector<std::size_t> recv_sizes = {3000, 1, 60000, 10005};
+    std::vector<std::uint8_t> data(73006);
+    for (std::size_t i = 0; i < data.size(); i++) {
+        data[i] = static_cast<std::uint8_t>(i * 7 + (i >> 8));
+    }
+    std::size_t offset = 0;
+    for (auto nbyte : send_sizes) {
+        nets.first->send_data(data.data() + offset, nbyte);
+        offset += nbyte;
+    }
+    ASSERT_EQ(offset, data.size());
+
+    std::vector<std::uint8_t> received(data.size());
+    offset = 0;
+    for (auto nbyte : recv_sizes) {
+        nets.second->recv_data(received.data() + offset, nbyte);
+        offset += nbyte;
+    }
+    ASSERT_EQ(offset, data.size());
+    ASSERT_EQ(received, data);
+    // Every non-empty call carries one length announcement.
+    ASSERT_EQ(nets.first->get_bytes_sent(), data.size() + 6 * sizeof(std::uint64_t));
+    ASSERT_EQ(nets.second->get_bytes_received(), nets.first->get_bytes_sent());
+}
+
+TEST(StripedNetworkTest, iknp_ot) {
+    std::size_t ext_ot_size = 2048;
+    auto nets = striped_pair(4, 4096);
+    petace::verse::VerseParams params;
+    params.base_ot_sizes = 128;
+    params.ext_ot_sizes = ext_ot_size;
+    std::vector<petace::verse::block> base_choices{petace::verse::read_block_from_dev_urandom()};
+    std::vector<petace::verse::block> ext_choices;
+    for (std::size_t i = 0; i < ext_ot_size / 128; i++) {
+        ext_choices.emplace_back(petace::verse::read_block_from_dev_urandom());
+    }
+    std::vector<std::array<petace::verse::block, 2>> send_msgs;
+    std::vector<petace::verse::block> recv_msgs;
+
+    std::thread sender([&] {
+        auto npot_receiver = petace::verse::VerseFactory<petace::verse::BaseOtReceiver>::get_instance().build(
+                petace::verse::OTScheme::NaorPinkasReceiver, params);
+        auto iknp_sender = petace::verse::VerseFactory<petace::verse::OtExtSender>::get_instance().build(
+                petace::verse::OTScheme::IknpSender, params);
+        std::vector<petace::verse::block> base_recv_ots;
+        npot_receiver->receive(nets.first, base_choices, base_recv_ots);
+        iknp_sender->set_base_ots(base_choices, base_recv_ots);
+        iknp_sender->send(nets.first, send_msgs);
+    });
+    auto npot_sender = petace::verse::VerseFactory<petace::verse::BaseOtSender>::get_instance().build(
+            petace::verse::OTScheme::NaorPinkasSender, params);
+    auto iknp_receiver = petace::verse::VerseFactory<petace::verse::OtExtReceiver>::get_instance().build(
+            petace::verse::OTScheme::IknpReceiver, params);
+    std::vector<std::array<petace::verse::block, 2>> base_send_ots;
+    npot_sender->send(nets.second, base_send_ots);
+    iknp_receiver->set_base_ots(base_send_ots);
+    iknp_receiver->receive(nets.second, ext_choices, recv_msgs);
+    sender.join();
+
+    ASSERT_EQ(recv_msgs.size(), ext_ot_size);
+    for (std::size_t i = 0; i < ext_ot_size; i++) {
+        const auto& expected = send_msgs[i][petace::verse::bit_from_blocks(ext_choices, i)];
+        ASSERT_EQ(recv_msgs[i][0], expected[0]);
+        ASSERT_EQ(recv_msgs[i][1], expected[1]);
+    }
+}
+
+TEST(StripedNetworkTest, except) {
+    auto nets = petace::verse::LocalNetwork::create_pair();
+    EXPECT_THROW(petace::verse::StripedNetwork({}), std::invalid_argument);
+    EXPECT_THROW(petace::verse::StripedNetwork({nets.first, nullptr}), std::invalid_argument);
+    EXPECT_THROW(petace::verse::StripedNetwork({nets.first}, 0), std::invalid_argument);
+}
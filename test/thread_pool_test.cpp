@@ -0,0 +1,92 @@
+// Copyright 2023 TikTok Pte. Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "verse/util/thread_pool.h"
+
+TEST(ThreadPoolTest, parallel_for_parts) {
+    petace::verse::ThreadPool pool(3);
+    for (std::size_t n : {1, 3, 4, 10, 1001}) {
+        std::vector<std::atomic<std::size_t>> hits(n);
+        std::vector<std::atomic<std::size_t>> parts(petace::verse::parallel_parts(&pool));
+        petace::verse::parallel_for_parts(&pool, n, [&](std::size_t part, std::size_t begin, std::size_t end) {
+            parts[part]++;
+            for (std::size_t i = begin; i < end; i++) {
+                hits[i]++;
+            }
+        });
+        for (std::size_t i = 0; i < n; i++) {
+            ASSERT_EQ(hits[i].load(), 1u);
+        }
+        for (auto& part : parts) {
+            ASSERT_LE(part.load(), 1u);
+        }
+    }
+}
+
+TEST(ThreadPoolTest, concurrent_callers) {
+    // Several threads split their ranges over one pool whose only worker is busy with a queued task.
+    petace::verse::ThreadPool pool(1);
+    std::atomic<bool> release(false);
+    auto blocker = pool.submit([&release] {
+        while (!release.load()) {
+            std::this_thread::yield();
+        }
+    });
+    std::vector<std::size_t> sums(4, 0);
+    std::vector<std::thread> callers;
+    for (std::size_t t = 0; t < sums.size(); t++) {
+        callers.emplace_back([&pool, &sums, t] {
+            std::vector<std::size_t> values(1000, t + 1);
+            std::atomic<std::size_t> sum(0);
+            petace::verse::parallel_for(&pool, values.size(), [&](std::size_t begin, std::size_t end) {
+                for (std::size_t i = begin; i < end; i++) {
+                    sum += values[i];
+                }
+            });
+            sums[t] = sum.load();
+        });
+    }
+    // The callers finish on their own threads while the worker is still held.
+    for (auto& caller : callers) {
+        caller.join();
+    }
+    release = true;
+    blocker.get();
+    for (std::size_t t = 0; t < sums.size(); t++) {
+        ASSERT_EQ(sums[t], 1000 * (t + 1));
+    }
+}
+
+TEST(ThreadPoolTest, exception) {
+    petace::verse::ThreadPool pool(2);
+    std::atomic<std::size_t> ranges(0);
+    EXPECT_THROW(petace::verse::parallel_for_parts(&pool, 30,
+                         [&ranges](std::size_t part, std::size_t, std::size_t) {
+                             ranges++;
+                             if (part == 2) {
+                                 throw std::runtime_error("range failed.");
+                             }
+                         }),
+            std::runtime_error);
+    // Every range ran before the exception reached the caller.
+    ASSERT_EQ(ranges.load(), 3u);
+}
@@ -0,0 +1,132 @@
+// Copyright 2023 TikTok Pte. Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "verse/triple/arithmetic_triple.h"
+#include "verse/triple/boolean_triple.h"
+#include "verse/util/defines.h"
+#include "verse/util/local_network.h"
+
+namespace {
+
+void check_arithmetic_triples(std::size_t bit_length, std::size_t num_threads) {
+    // 300 triples span several extension calls and end in a partial batch.
+    std::size_t n = 300;
+    petace::verse::VerseParams params;
+    params.base_ot_sizes = 128;
+    params.ext_ot_sizes = 4096;
+    params.num_threads = num_threads;
+    auto nets = petace::verse::LocalNetwork::create_pair();
+    petace::verse::ArithmeticTripleGenerator leader(params, bit_length, true);
+    petace::verse::ArithmeticTripleGenerator follower(params, bit_length, false);
+
+    std::vector<std::uint64_t> a0, b0, c0, a1, b1, c1;
+    std::thread thread([&] {
+        leader.setup(nets.first);
+        leader.generate(nets.first, n, a0, b0, c0);
+    });
+    follower.setup(nets.second);
+    follower.generate(nets.second, n, a1, b1, c1);
+    thread.join();
+
+    std::uint64_t mask = bit_length == 64 ? ~std::uint64_t(0) : (std::uint64_t(1) << bit_length) - 1;
+    ASSERT_EQ(c0.size(), n);
+    ASSERT_EQ(c1.size(), n);
+    for (std::size_t i = 0; i < n; i++) {
+        ASSERT_EQ(c0[i] & ~mask, 0u);
+        ASSERT_EQ(c1[i] & ~mask, 0u);
+        ASSERT_EQ(((a0[i] + a1[i]) * (b0[i] + b1[i])) & mask, (c0[i] + c1[i]) & mask);
+    }
+}
+
+void check_boolean_triples(std::size_t num_threads) {
+    // 70 words span several extension calls and end in a partial batch.
+    std::size_t words = 70;
+    petace::verse::VerseParams params;
+    params.base_ot_sizes = 128;
+    params.ext_ot_sizes = 1024;
+    params.num_threads = num_threads;
+    auto nets = petace::verse::LocalNetwork::create_pair();
+    petace::verse::BooleanTripleGenerator leader(params, true);
+    petace::verse::BooleanTripleGenerator follower(params, false);
+
+    std::vector<std::uint64_t> a0(words), b0(words), c0(words), a1(words), b1(words), c1(words);
+    std::thread thread([&] {
+        leader.setup(nets.first);
+        leader.generate(nets.first, words, a0.data(), b0.data(), c0.data());
+    });
+    follower.setup(nets.second);
+    follower.generate(nets.second, words, a1.data(), b1.data(), c1.data());
+    thread.join();
+
+    std::uint64_t any_a = 0;
+    std::uint64_t any_b = 0;
+    for (std::size_t w = 0; w < words; w++) {
+        ASSERT_EQ((a0[w] ^ a1[w]) & (b0[w] ^ b1[w]), c0[w] ^ c1[w]);
+        any_a |= a0[w] & a1[w];
+        any_b |= b0[w] & b1[w];
+    }
+    // The shares must be random, not all zero.
+    ASSERT_NE(any_a, 0u);
+    ASSERT_NE(any_b, 0u);
+}
+
+}  // namespace
+
+TEST(TripleTest, arithmetic_64) {
+    check_arithmetic_triples(64, 1);
+}
+
+TEST(TripleTest, arithmetic_32_threads) {
+    check_arithmetic_triples(32, 3);
+}
+
+TEST(TripleTest, arithmetic_except) {
+    petace::verse::VerseParams params;
+    params.base_ot_sizes = 128;
+    params.ext_ot_sizes = 1024;
+    EXPECT_THROW(petace::verse::ArithmeticTripleGenerator(params, 16, true), std::invalid_argument);
+    params.base_ot_sizes = 256;
+    EXPECT_THROW(petace::verse::ArithmeticTripleGenerator(params, 64, true), std::invalid_argument);
+    params.base_ot_sizes = 128;
+    petace::verse::ArithmeticTripleGenerator generator(params, 64, true);
+    std::vector<std::uint64_t> a, b, c;
+    EXPECT_THROW(generator.generate(nullptr, 1, a, b, c), std::logic_error);
+}
+
+TEST(TripleTest, boolean) {
+    check_boolean_triples(1);
+}
+
+TEST(TripleTest, boolean_threads) {
+    check_boolean_triples(3);
+}
+
+TEST(TripleTest, boolean_except) {
+    petace::verse::VerseParams params;
+    params.base_ot_sizes = 256;
+    params.ext_ot_sizes = 1024;
+    EXPECT_THROW(petace::verse::BooleanTripleGenerator(params, true), std::invalid_argument);
+    params.base_ot_sizes = 128;
+    petace::verse::BooleanTripleGenerator generator(params, true);
+    std::uint64_t a = 0, b = 0, c = 0;
+    EXPECT_THROW(generator.generate(nullptr, 1, &a, &b, &c), std::logic_error);
+}
@@ -0,0 +1,98 @@
+// Copyright 2023 TikTok Pte. Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+
+#include "gtest/gtest.h"
+
+#include "verse/verse_factory.h"
+
+namespace petace {
+namespace verse {
+
+// Two more schemes on one interface in one translation unit; the registration macros must not collide.
+const OTScheme kTestSchemeA = static_cast<OTScheme>(100);
+const OTScheme kTestSchemeB = static_cast<OTScheme>(101);
+
+inline SchemeDescriptor describe_test_scheme() {
+    SchemeDescriptor descriptor;
+    descriptor.name = "test-malicious";
+    descriptor.security = SecurityModel::Malicious;
+    descriptor.base_ot_widths = {64};
+    descriptor.micros_per_ot = 1000.0;
+    return descriptor;
+}
+
+REGISTER_VERSE_BASE_OT_SENDER(kTestSchemeA, create_naor_pinkas_sender, describe_test_scheme())
+REGISTER_VERSE_BASE_OT_SENDER(kTestSchemeB, create_naor_pinkas_sender)
+
+}  // namespace verse
+}  // namespace petace
+
+TEST(VerseFactoryTest, multiple_registrations) {
+    auto& factory = petace::verse::VerseFactory<petace::verse::BaseOtSender>::get_instance();
+    petace::verse::VerseParams params;
+    params.base_ot_sizes = 128;
+    ASSERT_NE(factory.build(petace::verse::kTestSchemeA, params), nullptr);
+    ASSERT_NE(factory.build(petace::verse::kTestSchemeB, params), nullptr);
+    ASSERT_EQ(factory.describe(petace::verse::kTestSchemeA).name, "test-malicious");
+    EXPECT_THROW(factory.describe(petace::verse::kTestSchemeB), std::invalid_argument);
+    auto schemes = factory.schemes();
+    for (auto scheme : {petace::verse::OTScheme::NaorPinkasSender, petace::verse::OTScheme::SimplestOtSender,
+                 petace::verse::OTScheme::IknpBaseOtSender, petace::verse::kTestSchemeA, petace::verse::kTestSchemeB}) {
+        ASSERT_NE(std::find(schemes.begin(), schemes.end(), scheme), schemes.end());
+    }
+}
+
+TEST(VerseFactoryTest, select_base_ot) {
+    auto& factory = petace::verse::VerseFactory<petace::verse::BaseOtSender>::get_instance();
+    petace::verse::SchemeProfile profile;
+    petace::verse::VerseParams params;
+    params.base_ot_sizes = 128;
+    ASSERT_EQ(factory.select(profile, params), petace::verse::OTScheme::SimplestOtSender);
+    // Wide base ots amortize the public-key setup of the iknp bootstrap.
+    params.base_ot_sizes = 1024;
+    ASSERT_EQ(factory.select(profile, params), petace::verse::OTScheme::IknpBaseOtSender);
+    // Only the malicious test scheme remains, and it supports 64 base ots only.
+    profile.security = petace::verse::SecurityModel::Malicious;
+    EXPECT_THROW(factory.select(profile, params), std::invalid_argument);
+    params.base_ot_sizes = 64;
+    ASSERT_EQ(factory.select(profile, params), petace::verse::kTestSchemeA);
+}
+
+TEST(VerseFactoryTest, select_extension) {
+    petace::verse::SchemeProfile profile;
+    profile.message_modes = petace::verse::kChosenMessages;
+    petace::verse::VerseParams params;
+    params.base_ot_sizes = 128;
+    params.ext_ot_sizes = 1024;
+    auto& factory = petace::verse::VerseFactory<petace::verse::OtExtSender>::get_instance();
+    ASSERT_EQ(factory.select(profile, params), petace::verse::OTScheme::IknpSender);
+    ASSERT_NE(factory.build(profile, params), nullptr);
+    params.ext_ot_sizes = 1000;
+    EXPECT_THROW(factory.build(profile, params), std::invalid_argument);
+
+    params.base_ot_sizes = 512;
+    auto& nco_factory = petace::verse::VerseFactory<petace::verse::NcoOtExtReceiver>::get_instance();
+    // Kkrt sends chosen messages through NcoOtExtSender::send_chosen.
+    ASSERT_EQ(nco_factory.select(profile, params), petace::verse::OTScheme::KkrtReceiver);
+    params.base_ot_sizes = 500;
+    EXPECT_THROW(nco_factory.select(profile, params), std::invalid_argument);
+    params.base_ot_sizes = 512;
+    profile.message_modes = petace::verse::kLongMessages;
+    ASSERT_EQ(nco_factory.select(profile, params), petace::verse::OTScheme::KkrtReceiver);
+    ASSERT_EQ(nco_factory.describe(petace::verse::OTScheme::KkrtReceiver).name, "kkrt");
+}